@@ -0,0 +1,35 @@
+#ifndef ANIMATION_TIMELINE_H
+#define ANIMATION_TIMELINE_H
+
+#include <stdint.h>
+
+#define ANIMATION_NO_FRAME -1
+
+// Frame scheduler driven from loop(). A timeline is a list of frame
+// durations in ms; update() returns the index of the frame that should be
+// drawn now, or ANIMATION_NO_FRAME if the screen is already current, so
+// each loop() draws at most one frame and never blocks. If loop() stalls,
+// overdue frames are skipped rather than played late.
+// A one-shot timeline ends after its last frame; a looping one wraps.
+class AnimationTimeline {
+public:
+    AnimationTimeline();
+
+    void start(const uint16_t *frameDurations, uint8_t frameCount, unsigned long now, bool loop = false);
+    void stop();
+    int update(unsigned long now);
+
+    bool isRunning() const { return running; }
+    uint8_t getFrame() const { return frame; }
+
+private:
+    const uint16_t *durations;
+    uint8_t count;
+    uint8_t frame;
+    bool looping;
+    bool running;
+    bool pending;            // Current frame not yet handed out
+    unsigned long frameStart;
+};
+
+#endif // ANIMATION_TIMELINE_H
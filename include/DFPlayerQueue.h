@@ -0,0 +1,131 @@
+#ifndef DFPLAYER_QUEUE_H
+#define DFPLAYER_QUEUE_H
+
+#include <Arduino.h>
+
+#define DFPLAYER_QUEUE_SIZE      8
+#define DFPLAYER_ACK_TIMEOUT     150 // ms to wait for the module's ACK
+#define DFPLAYER_NO_ACK_GAP      100 // ms between commands when ACKs never arrive
+#define DFPLAYER_MAX_MISSED_ACKS 3   // Consecutive timeouts before giving up on ACKs
+#define DFPLAYER_BUSY_RETRY      200 // ms before resending a command the module was too busy for
+#define DFPLAYER_MAX_RETRIES     3
+#define DFPLAYER_BUSY_TIMEOUT    500 // ms for the BUSY pin to follow a play or stop
+#define DFPLAYER_NO_BUSY_PIN     -1
+
+// Serial protocol: 7E FF 06 CMD ACK PH PL CSH CSL EF
+#define DFPLAYER_FRAME_LENGTH    10
+
+// Commands
+#define DFPLAYER_CMD_PLAY_TRACK  0x03
+#define DFPLAYER_CMD_VOLUME      0x06
+#define DFPLAYER_CMD_EQ          0x07
+#define DFPLAYER_CMD_OUTPUT      0x09
+#define DFPLAYER_CMD_SLEEP       0x0A
+#define DFPLAYER_CMD_WAKE        0x0B
+#define DFPLAYER_CMD_RESET       0x0C
+#define DFPLAYER_CMD_LOOP_ALL    0x11 // Param 0 = off
+#define DFPLAYER_CMD_STOP        0x16
+#define DFPLAYER_CMD_SINGLE_LOOP 0x19 // Param 1 = off
+#define DFPLAYER_CMD_DAC         0x1A // Param 1 = off
+
+// Messages from the module
+#define DFPLAYER_MSG_CARD_INSERTED 0x3A
+#define DFPLAYER_MSG_CARD_REMOVED  0x3B
+#define DFPLAYER_MSG_USB_FINISHED  0x3C
+#define DFPLAYER_MSG_SD_FINISHED   0x3D
+#define DFPLAYER_MSG_ONLINE        0x3F
+#define DFPLAYER_MSG_ERROR         0x40
+#define DFPLAYER_MSG_ACK           0x41
+
+// Error codes in DFPLAYER_MSG_ERROR
+#define DFPLAYER_ERROR_BUSY        0x01
+
+#define DFPLAYER_EQ_NORMAL   0
+#define DFPLAYER_DEVICE_SD   2
+
+// Non-blocking DFPlayer Mini driver. Commands are queued and sent one at a
+// time from service(). How they are paced depends on the wiring:
+// - When the module's replies can be received, each command asks for an
+//   ACK and the next one goes out as soon as it arrives. Status messages
+//   (track finished, card removed, errors) are parsed as they come in. If
+//   no ACK ever arrives, the driver stops asking after a few timeouts.
+// - Without replies, commands go out DFPLAYER_NO_ACK_GAP apart. If the
+//   BUSY pin (low while a track plays) is wired, a play or stop also waits
+//   until BUSY follows it, and BUSY going high marks the end of a track.
+class DFPlayerQueue {
+public:
+    DFPlayerQueue();
+
+    // receives: false when the serial RX pin cannot receive (e.g. GPIO16,
+    // which has no pin-change interrupt for SoftwareSerial)
+    void begin(Stream &serial, bool receives = true, int8_t busyPin = DFPLAYER_NO_BUSY_PIN);
+
+    // Queue a raw command; false (and counted) if the queue is full
+    bool send(uint8_t command, uint16_t param = 0);
+
+    // Play a track, replacing any play or stop that has not been sent yet.
+    // A new track also cuts off the one playing, so no stop is needed.
+    void play(uint16_t track);
+    void stop();
+
+    // Read replies and send the next command; call from loop()
+    void service();
+
+    bool isIdle() const { return count == 0 && !awaitingAck && !awaitingBusy && !retryPending; }
+    bool isPlaying() const { return playing; }
+    bool isAckSupported() const { return ackSupported; }
+    uint8_t getLastError() const { return lastError; }
+
+    uint32_t getCommandCount() const { return commandsSent; }
+    uint32_t getAckCount() const { return acks; }
+    uint32_t getTimeoutCount() const { return timeouts; }
+    uint32_t getErrorCount() const { return errors; }
+    uint32_t getFinishedCount() const { return tracksFinished; }
+    uint32_t getReplacedCount() const { return replaced; }
+    uint32_t getDroppedCount() const { return dropped; }
+
+private:
+    struct Command {
+        uint8_t command;
+        uint16_t param;
+    };
+    Command queue[DFPLAYER_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+
+    Stream *serial;
+    Command inFlight;
+    uint8_t retries;
+    bool retryPending;
+    bool awaitingAck;
+    unsigned long sentAt;
+    unsigned long nextSendAt;
+    uint8_t missedAcks;
+    bool ackSupported;
+    bool receives;
+    int8_t busyPin;
+    bool awaitingBusy;
+    bool busyExpected;   // BUSY level (true = low, playing) that completes the command
+
+    uint8_t frame[DFPLAYER_FRAME_LENGTH];
+    uint8_t frameLength;
+
+    bool playing;
+    uint8_t lastError;
+    uint32_t commandsSent;
+    uint32_t acks;
+    uint32_t timeouts;
+    uint32_t errors;
+    uint32_t tracksFinished;
+    uint32_t replaced;
+    uint32_t dropped;
+
+    void transmit(const Command &command);
+    void receive(uint8_t byte);
+    void serviceBusy(unsigned long now);
+    void handleMessage(uint8_t command, uint16_t param);
+    void removeQueued(uint8_t command);
+    static uint16_t checksum(const uint8_t *frame);
+};
+
+#endif // DFPLAYER_QUEUE_H
@@ -0,0 +1,41 @@
+#ifndef DEVICE_MAP_H
+#define DEVICE_MAP_H
+
+#include <Arduino.h>
+
+#define DEVICE_MAP_MAGIC     0x4D384231 // "M8B1"
+#define DEVICE_MAP_RTC_BLOCK 0          // RTC user memory offset, in 4-byte blocks
+
+// Which 7-bit I2C addresses answered, as a 128-bit set. Scanning the whole
+// bus takes ~130 probes; the result is kept in RTC user memory (guarded by a
+// magic and CRC) so a warm boot (reset, watchdog, deep sleep wake) reuses it.
+// Power-on always rescans since the wiring may have changed.
+class DeviceMap {
+public:
+    DeviceMap();
+
+    void scan();
+    bool loadFromRtc();   // False if missing, corrupt or after power-on
+    void saveToRtc();
+    void invalidateRtc(); // Force a rescan on the next boot
+
+    bool has(uint8_t address) const;
+    uint8_t getCount() const;
+    bool isCached() const { return cached; }
+    void print() const;
+
+private:
+    struct Stored {
+        uint32_t magic;
+        uint32_t present[4];
+        uint32_t crc;
+    };
+    uint32_t present[4];
+    bool cached;
+
+    static uint32_t crc32(const uint8_t *data, size_t length);
+};
+
+extern DeviceMap deviceMap;
+
+#endif // DEVICE_MAP_H
@@ -0,0 +1,61 @@
+#ifndef DISPLAY_FLUSH_H
+#define DISPLAY_FLUSH_H
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+#include "I2CBus.h"
+
+// Full-buffer geometry of the 128x64 SH1106 in 8x8 tiles. U8g2 stores each
+// tile row (page) as 128 consecutive column bytes, 8 bytes per tile.
+#define DISPLAY_TILE_COLS   16
+#define DISPLAY_TILE_ROWS   8
+#define DISPLAY_TILE_BYTES  8
+#define DISPLAY_BUFFER_SIZE (DISPLAY_TILE_COLS * DISPLAY_TILE_ROWS * DISPLAY_TILE_BYTES)
+
+// Replacement for sendBuffer() that only transfers tiles that changed since
+// the previous flush. A shadow copy of the last frame sent is compared tile by
+// tile; each run of dirty tiles in a tile row goes out through
+// updateDisplayArea(), and an unchanged frame is not sent at all.
+// Between runs the shared bus gets to service other clients (the sensor).
+class TileFlusher {
+public:
+    explicit TileFlusher(U8G2 &display);
+
+    uint16_t flush();     // Returns data bytes sent
+    void invalidate();    // Next flush sends the whole frame
+    void setBusClient(int8_t client) { busClient = client; }
+    int8_t getBusClient() const { return busClient; }
+
+    // Last frame sent, as a binary PBM (P4) image, in one emit() per pixel row.
+    // Returns false without emitting anything before the first flush.
+    bool exportPbm(void (*emit)(const char *text, size_t length)) const;
+    bool hasFrame() const { return shadowValid; }
+    
+    // Off-screen capture: export whatever is drawn in the buffer now, then
+    // put the last frame sent back so the panel and the next flush never
+    // see the drawing
+    void exportBufferPbm(void (*emit)(const char *text, size_t length));
+    void restoreBuffer();
+
+    uint16_t getLastFlushBytes() const { return lastFlushBytes; }
+    uint32_t getTotalBytes() const { return totalBytes; }
+    uint32_t getFlushCount() const { return flushCount; }
+    uint32_t getSkippedCount() const { return skippedCount; }
+    void resetStats();
+
+private:
+    U8G2 &display;
+    uint8_t shadow[DISPLAY_BUFFER_SIZE];
+    bool shadowValid;
+    int8_t busClient;
+
+    uint16_t lastFlushBytes;
+    uint32_t totalBytes;
+    uint32_t flushCount;
+    uint32_t skippedCount;
+
+    void sendRun(uint8_t tileRow, uint8_t firstTile, uint8_t tileCount);
+    static void writePbm(const uint8_t *frame, void (*emit)(const char *text, size_t length));
+};
+
+#endif // DISPLAY_FLUSH_H
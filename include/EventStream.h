@@ -0,0 +1,67 @@
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include "MPU6050_Raw.h"
+#include "ResponseCatalog.h"
+
+#define EVENT_MAX_CLIENTS       4
+#define EVENT_BUFFER_SIZE       384    // Pending bytes per client before it is dropped
+// Largest data field: an answer with every character JSON-escaped, plus its
+// source. Longer events are counted in getDroppedEventCount() and not sent.
+#define EVENT_MAX_DATA_LENGTH   (2 * CATALOG_MAX_ENTRY_LENGTH + 40)
+#define EVENT_MAX_TEXT_LENGTH   (EVENT_MAX_DATA_LENGTH + 32) // With "event:"/"data:" framing
+#define EVENT_ACCEL_INTERVAL    100    // ms between accelerometer events (10Hz)
+#define EVENT_KEEPALIVE_INTERVAL 15000 // ms between keep-alive comments
+#define EVENT_RETRY_MS          2000   // Browser reconnect delay after a drop
+
+// Server-Sent Events fan-out for the web page. Each subscriber gets a fixed
+// output buffer; publish() only copies into the buffers and service() writes
+// as much as each socket accepts without blocking. A client whose buffer
+// would overflow is too slow to keep up and is disconnected rather than
+// letting it stall loop(). The browser's EventSource reconnects by itself.
+class EventStream {
+public:
+    EventStream();
+
+    // Take over an HTTP connection as a subscriber; false if all slots are busy
+    bool subscribe(WiFiClient &client, bool wantsAccel);
+
+    // Queue an event for every subscriber (or only accel subscribers)
+    void publish(const char *event, const char *data, bool accelOnly = false);
+
+    // Accelerometer samples, downsampled to EVENT_ACCEL_INTERVAL
+    void publishAccel(const AccelSample &sample, uint8_t accelRange);
+
+    // Flush pending output and reap closed connections; call from loop()
+    void service();
+
+    uint8_t getClientCount() const;
+    uint32_t getEventCount() const { return eventCount; }
+    uint32_t getDroppedClientCount() const { return droppedClients; }
+    uint32_t getRejectedCount() const { return rejected; }
+    uint32_t getDroppedEventCount() const { return droppedEvents; }
+
+private:
+    struct Subscriber {
+        WiFiClient client;
+        bool active;
+        bool accel;
+        char buffer[EVENT_BUFFER_SIZE];
+        uint16_t pending;
+    };
+    Subscriber subscribers[EVENT_MAX_CLIENTS];
+
+    unsigned long lastAccelEvent;
+    unsigned long lastKeepAlive;
+    uint32_t eventCount;
+    uint32_t droppedClients;
+    uint32_t rejected;
+    uint32_t droppedEvents;
+
+    bool enqueue(Subscriber &subscriber, const char *text, size_t length);
+    void drop(Subscriber &subscriber);
+};
+
+#endif // EVENT_STREAM_H
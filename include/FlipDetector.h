@@ -0,0 +1,73 @@
+#ifndef FLIP_DETECTOR_H
+#define FLIP_DETECTOR_H
+
+#include <stdint.h>
+#include "MPU6050_Raw.h"
+
+// Samples further apart than this restart the filter from the accelerometer
+#define FLIP_MAX_GAP_MS 100
+
+// Tuning for FlipDetector. Angles and rates are converted to raw counts once
+// in begin(), so update() only does integer math.
+struct FlipConfig {
+    uint8_t faceAxis;      // 0=X, 1=Y, 2=Z: the axis pointing out of the display
+    int8_t faceSign;       // +1 if that axis reads +1g with the display facing up
+    uint8_t tiltDegrees;   // Cone around vertical that counts as face up/down
+    uint16_t maxRateDps;   // Summed gyro rate below which the device is still
+    uint16_t settleMs;     // Still in one orientation for this long to count
+    uint16_t refractoryMs; // Minimum time between two flips
+    uint8_t blendShift;    // Accelerometer weight per sample: 1 / 2^blendShift
+
+    FlipConfig()
+        : faceAxis(2), faceSign(1), tiltDegrees(40), maxRateDps(30),
+          settleMs(300), refractoryMs(1500), blendShift(4) {}
+};
+
+// "Turn it over" trigger, like a real 8-ball: recognises the device coming
+// to rest face up after it rested face down. Gravity is tracked with a
+// fixed-point complementary filter: the estimate is rotated by the gyro
+// rates every sample and pulled toward the accelerometer by 1/2^blendShift,
+// so it stays right while the device is being turned (when the accelerometer
+// also sees hand motion). Constant memory, no heap, no floating point in
+// update().
+class FlipDetector {
+public:
+    enum Face { FACE_UNKNOWN, FACE_UP, FACE_DOWN, FACE_SIDE };
+
+    explicit FlipDetector(const FlipConfig &config = FlipConfig());
+
+    void begin(uint8_t accelRange, uint8_t gyroRange);
+    // Restart the filter; the last resting face is kept
+    void reset() { hasEstimate = false; }
+
+    // Feed one sample with its time; returns true when a flip is recognised
+    bool update(const MotionSample &sample, unsigned long now);
+
+    Face getFace() const { return restingFace; }
+    uint32_t getFlipCount() const { return flipCount; }
+    // Gravity estimate in milli-g, for logging and tuning
+    int16_t getGravityMilliG(uint8_t axis) const;
+
+private:
+    FlipConfig config;
+
+    // Derived in begin()
+    uint16_t countsPerG;
+    int32_t radiansPerCountQ20; // Gyro count to rad/s, Q20
+    uint32_t maxRateCounts;
+    uint16_t cosSqQ8;           // cos²(tilt) * 256
+
+    int32_t gravity[3];         // Estimate in accel counts << 4
+    bool hasEstimate;
+    unsigned long lastUpdate;
+
+    Face candidateFace;         // Orientation while it settles
+    unsigned long candidateSince;
+    Face restingFace;
+    unsigned long lastFlip;
+    uint32_t flipCount;
+
+    Face classify() const;
+};
+
+#endif // FLIP_DETECTOR_H
@@ -0,0 +1,90 @@
+#ifndef GESTURE_ENGINE_H
+#define GESTURE_ENGINE_H
+
+#include <stdint.h>
+#include "MPU6050_Raw.h"
+
+// Samples in the sliding window (0.64s at the 50Hz FIFO rate)
+#define GESTURE_WINDOW_SIZE 32
+
+// Tuning for GestureEngine. Accelerations are in milli-g and converted to raw
+// counts once in begin(), so update() only does integer math.
+struct GestureConfig {
+    uint16_t energyOnMilliG;        // RMS motion (gravity removed) needed to trigger
+    uint16_t energyOffMilliG;       // RMS motion below which the engine re-arms
+    uint16_t reversalDeadbandMilliG; // Swing needed on each side to count a reversal
+    uint8_t  minReversals;          // Direction reversals on the dominant axis
+    uint16_t minJerkMilliG;         // Mean |change| between consecutive samples
+    uint16_t refractoryMs;          // Minimum time between two shakes
+
+    GestureConfig()
+        : energyOnMilliG(400), energyOffMilliG(200), reversalDeadbandMilliG(250),
+          minReversals(4), minJerkMilliG(60), refractoryMs(1000) {}
+};
+
+// Streaming shake recogniser over a fixed ring buffer of per-sample features.
+// A shake needs sustained energy, repeated back-and-forth reversals and jerk
+// across the whole window, so a single bump or tap does not fire it, while
+// a gentle but real shake does. Triggering is edge based with hysteresis:
+// after a shake the window energy must drop below energyOff (and the
+// refractory period pass) before the next one. Constant memory, no heap.
+class GestureEngine {
+public:
+    explicit GestureEngine(const GestureConfig &config = GestureConfig());
+
+    void begin(uint8_t accelRange, uint16_t sampleRateHz);
+    void reset(); // Forget the window, e.g. after a gap in the sample stream
+
+    // Feed one sample at the configured rate; returns true when a shake is recognised
+    bool update(const AccelSample &sample);
+
+    bool isArmed() const { return armed; }
+    uint32_t getShakeCount() const { return shakeCount; }
+    uint32_t getSampleCount() const { return sampleCount; }
+
+    // Window features, for logging and tuning
+    uint16_t getEnergyMilliG() const;   // RMS over the window
+    uint8_t getDominantReversals() const;
+    uint16_t getJerkMilliG() const;     // Mean per sample over the window
+
+private:
+    GestureConfig config;
+
+    // Thresholds in raw counts, derived in begin()
+    uint16_t countsPerG;
+    uint32_t energyOnSum;   // Window sum of (deviation² >> 8)
+    uint32_t energyOffSum;
+    int16_t reversalDeadband;
+    uint32_t jerkSum;
+    uint32_t refractorySamples;
+
+    // Per-sample features in the ring
+    struct Feature {
+        uint32_t energy[3];  // Per-axis deviation² >> 8
+        uint16_t jerk;       // |Δx| + |Δy| + |Δz|, saturated
+        uint8_t reversals;   // Bit per axis
+    };
+    Feature window[GESTURE_WINDOW_SIZE];
+    uint8_t head;
+    uint8_t filled;
+
+    // Running window sums
+    uint32_t axisEnergy[3];
+    uint8_t axisReversals[3];
+    uint32_t windowJerk;
+
+    int32_t gravity[3];    // Low-passed acceleration, counts << 4
+    int8_t lastSign[3];
+    AccelSample previous;
+    bool hasPrevious;
+
+    bool armed;
+    uint32_t sampleCount;
+    uint32_t lastShakeSample;
+    uint32_t shakeCount;
+
+    uint8_t dominantAxis() const;
+    uint32_t totalEnergy() const { return axisEnergy[0] + axisEnergy[1] + axisEnergy[2]; }
+};
+
+#endif // GESTURE_ENGINE_H
@@ -0,0 +1,162 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define I2C_MAX_CLIENTS      4
+#define I2C_NO_CLIENT        -1
+#define I2C_DEFAULT_CLOCK    100000
+
+// Transaction limits. Wire waits at most I2C_CLOCK_STRETCH_LIMIT_US for SCL
+// to rise on each clock; neither the MPU6050 nor the SH1106 stretches, so
+// this only has to cover slow pull-ups. Wire.begin() resets it to the
+// core's 150ms, so begin(), recoverBus() and endExternal() (after a driver
+// such as U8g2 has restarted Wire) all apply it again. An attempt is a
+// timeout, and its data is discarded, when it takes longer than its budget:
+// I2C_TRANSACTION_OVERHEAD_US plus I2C_BYTE_BUDGET_CLOCKS per byte on the
+// wire at the client's clock (twice the 9 clocks a byte needs). NACKs, short reads and a busy bus are
+// retried up to I2C_MAX_RETRIES times; a busy bus gets one bus clear first,
+// a timeout gets a bus clear and no retry.
+//
+// Budgets at 400kHz: a 14-byte sensor burst (17 bytes on the wire, ~155
+// clocks, ~0.4ms) gets 1.8ms; a 120-byte FIFO chunk (123 bytes, ~1110
+// clocks, ~2.8ms) gets 6.5ms.
+//
+// Worst case for a failed read:
+// - device missing or bus held low: each attempt fails at the start or the
+//   address byte (< 0.1ms at 400kHz), so 3 attempts and a bus clear (9
+//   pulses, ~0.1ms) stay under 0.5ms.
+// - device stretching every clock: Wire only returns at the end, so one
+//   attempt costs its clocks x (2.5 + 50us), then a bus clear. ~8ms for a
+//   sensor burst, within the 20ms loop; ~58ms for a full FIFO chunk, after
+//   which the FIFO is reset.
+#define I2C_CLOCK_STRETCH_LIMIT_US 50
+#define I2C_TRANSACTION_OVERHEAD_US 1000
+#define I2C_BYTE_BUDGET_CLOCKS     18
+#define I2C_MAX_RETRIES            2
+#define I2C_BUS_CLEAR_PULSES       9
+#define I2C_BUS_CLEAR_HALF_PERIOD  5  // us, 100kHz
+#define I2C_RECOVERY_LOG_MS        5000 // At most one bus-clear message per interval
+
+// Outcome of a register transaction, carried up to the driver's callers
+enum I2CStatus : uint8_t {
+    I2C_OK = 0,
+    I2C_NACK_ADDRESS,   // No device answered
+    I2C_NACK_DATA,      // Device rejected a byte
+    I2C_SHORT_READ,     // Fewer bytes than requested
+    I2C_TIMEOUT,        // Clock stretched out or transaction too slow
+    I2C_BUS_BUSY,       // SDA or SCL held low before the start
+    I2C_INVALID_CLIENT
+};
+
+// Per-client bus statistics
+struct I2CClientStats {
+    uint32_t transactions;
+    uint32_t errors;
+    uint32_t totalMicros;
+    uint32_t maxMicros;
+    uint32_t lifetimeTransactions; // Not cleared by resetStats()
+    uint32_t lifetimeErrors;
+    uint32_t nacks;       // Failed attempts by cause, also cumulative
+    uint32_t timeouts;
+    uint32_t retries;
+    uint32_t recoveries;  // Bus clears triggered by this client
+};
+
+// Owner of the shared Wire bus. Each device registers as a client with the
+// fastest clock it supports, and the bus is switched to that clock before the
+// client's transactions. Clients that drive Wire themselves (U8g2) bracket
+// their transfers with beginExternal()/endExternal() so they are timed and
+// counted too.
+//
+// A client can also register a service callback. Long multi-transfer
+// operations (display flushes) call serviceClients() between chunks, so a
+// sensor that is due gets the bus instead of waiting for the whole flush.
+class I2CBus {
+public:
+    I2CBus();
+
+    void begin(uint8_t sdaPin, uint8_t sclPin);
+    bool isStarted() const { return started; }
+
+    int8_t registerClient(const char *name, uint8_t address, uint32_t maxClock);
+    void setServiceCallback(int8_t client, void (*callback)(), uint32_t intervalMicros);
+
+    // Register-level transactions on behalf of a client, with retries and
+    // bus recovery; a read succeeds only if all bytes arrived
+    I2CStatus writeRegister(int8_t client, uint8_t reg, uint8_t value);
+    I2CStatus readRegisters(int8_t client, uint8_t reg, uint8_t *buffer, uint8_t length);
+    // Address-only write, no retries; counted against the client registered
+    // at that address, if any
+    bool probe(uint8_t address);
+
+    // Clock SCL until a device holding SDA lets go, then send a STOP
+    bool recoverBus();
+    uint32_t timeoutFor(uint8_t bytes) const; // Budget for an attempt, in us
+    static const char *statusName(I2CStatus status);
+
+    // Transfers made by a client's own driver
+    void beginExternal(int8_t client);
+    void endExternal(int8_t client, bool ok);
+
+    // Give due clients a turn; called between chunks of long operations
+    void serviceClients();
+
+    const I2CClientStats *getStats(int8_t client) const;
+    const char *getClientName(int8_t client) const;
+    uint8_t getClientCount() const { return clientCount; }
+    void printStats();
+    void resetStats();
+
+private:
+    struct Client {
+        const char *name;
+        uint8_t address;
+        uint32_t maxClock;
+        void (*service)();
+        uint32_t serviceInterval;
+        uint32_t lastService;
+        I2CClientStats stats;
+    };
+
+    Client clients[I2C_MAX_CLIENTS];
+    uint8_t clientCount;
+    uint8_t sdaPin;
+    uint8_t sclPin;
+    uint32_t currentClock;
+    bool started;
+    bool servicing;
+    unsigned long transactionStart;
+    unsigned long lastRecoveryLog;
+    uint32_t unloggedRecoveries;
+
+    bool validClient(int8_t client) const { return client >= 0 && client < clientCount; }
+    int8_t findClient(uint8_t address) const;
+    void selectClock(int8_t client);
+    void recordTransaction(int8_t client, bool ok);
+    // reg null: address only (probe); value null: read 'length' bytes
+    I2CStatus attempt(uint8_t address, const uint8_t *reg, const uint8_t *value, uint8_t *buffer, uint8_t length);
+    I2CStatus transact(int8_t client, uint8_t reg, const uint8_t *value, uint8_t *buffer, uint8_t length);
+};
+
+extern I2CBus i2cBus;
+
+// Bus policy for drivers templated on their bus (see MPU6050): forwards to
+// the shared i2cBus and compiles down to the same direct calls
+struct SharedI2CBus {
+    static int8_t registerClient(const char *name, uint8_t address, uint32_t maxClock) {
+        return i2cBus.registerClient(name, address, maxClock);
+    }
+    static I2CStatus writeRegister(int8_t client, uint8_t reg, uint8_t value) {
+        return i2cBus.writeRegister(client, reg, value);
+    }
+    static I2CStatus readRegisters(int8_t client, uint8_t reg, uint8_t *buffer, uint8_t length) {
+        return i2cBus.readRegisters(client, reg, buffer, length);
+    }
+    static bool probe(uint8_t address) {
+        return i2cBus.probe(address);
+    }
+};
+
+#endif // I2C_BUS_H
@@ -0,0 +1,73 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+
+#define LATENCY_BUCKET_COUNT 12
+
+// Fixed-bucket latency histogram in microseconds. Recording is a short scan
+// over constant bounds - no allocation - and percentiles are reported as the
+// upper bound of the bucket they fall in.
+class LatencyHistogram {
+public:
+    LatencyHistogram() { reset(); }
+
+    void record(uint32_t micros) {
+        uint8_t bucket = 0;
+        while (bucket < LATENCY_BUCKET_COUNT - 1 && micros > bucketBound(bucket)) {
+            bucket++;
+        }
+        counts[bucket]++;
+        count++;
+        sum += micros;
+        if (micros > max) {
+            max = micros;
+        }
+    }
+
+    // Upper bound of the bucket holding the given percentile (0..100)
+    uint32_t percentile(uint8_t pct) const {
+        if (count == 0) {
+            return 0;
+        }
+        uint32_t target = (count * pct + 99) / 100;
+        uint32_t seen = 0;
+        for (uint8_t bucket = 0; bucket < LATENCY_BUCKET_COUNT; bucket++) {
+            seen += counts[bucket];
+            if (seen >= target) {
+                return bucket < LATENCY_BUCKET_COUNT - 1 ? bucketBound(bucket) : max;
+            }
+        }
+        return max;
+    }
+
+    void reset() {
+        for (uint8_t bucket = 0; bucket < LATENCY_BUCKET_COUNT; bucket++) {
+            counts[bucket] = 0;
+        }
+        count = 0;
+        sum = 0;
+        max = 0;
+    }
+
+    // 100us .. 5s in a 1-2-5 series; the last bucket is unbounded
+    static uint32_t bucketBound(uint8_t bucket) {
+        static const uint32_t bounds[LATENCY_BUCKET_COUNT - 1] = {
+            100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 5000000
+        };
+        return bucket < LATENCY_BUCKET_COUNT - 1 ? bounds[bucket] : 0xFFFFFFFF;
+    }
+
+    uint32_t getCount() const { return count; }
+    uint32_t getBucketCount(uint8_t bucket) const { return counts[bucket]; }
+    uint64_t getSum() const { return sum; }
+    uint32_t getMax() const { return max; }
+
+private:
+    uint32_t counts[LATENCY_BUCKET_COUNT];
+    uint32_t count;
+    uint64_t sum;
+    uint32_t max;
+};
+
+#endif // LATENCY_HISTOGRAM_H
@@ -2,7 +2,7 @@
 #define MPU6050_RAW_H
 
 #include <Arduino.h>
-#include <Wire.h>
+#include "I2CBus.h"
 
 // MPU6050 Register Addresses
 #define MPU6050_DEFAULT_ADDR 0x68
@@ -14,47 +14,168 @@
 #define ACCEL_YOUT_L 0x3E
 #define ACCEL_ZOUT_H 0x3F
 #define ACCEL_ZOUT_L 0x40
+#define TEMP_OUT_H   0x41
+#define GYRO_XOUT_H  0x43
 #define WHO_AM_I     0x75
 #define ACCEL_CONFIG 0x1C
+#define GYRO_CONFIG  0x1B
+#define MPU6050_DEFAULT_RANGE 2 // ±8g, set by begin()
+#define MPU6050_DEFAULT_GYRO_RANGE 1 // ±500°/s, set by begin()
+#define MPU6050_MAX_CLOCK 400000 // Fast-mode I2C
+#define SMPLRT_DIV   0x19
+#define MPU_CONFIG   0x1A
+#define FIFO_EN      0x23
+#define INT_STATUS   0x3A
+#define USER_CTRL    0x6A
+#define FIFO_COUNTH  0x72
+#define FIFO_R_W     0x74
+#define MOT_THR      0x1F
+#define MOT_DUR      0x20
+#define INT_PIN_CFG  0x37
+#define INT_ENABLE   0x38
 
-class MPU6050_Raw {
+// Register bits
+#define FIFO_EN_ACCEL           0x08 // FIFO_EN: push accel X/Y/Z into FIFO
+#define USER_CTRL_FIFO_EN       0x40 // USER_CTRL: enable FIFO operation
+#define USER_CTRL_FIFO_RESET    0x04 // USER_CTRL: reset FIFO (self-clearing)
+#define INT_STATUS_FIFO_OFLOW   0x10 // INT_STATUS: FIFO overflowed
+#define INT_STATUS_MOT          0x40 // INT_STATUS: motion detected
+#define INT_ENABLE_MOT          0x40 // INT_ENABLE: motion interrupt
+#define INT_ENABLE_DATA_RDY     0x01 // INT_ENABLE: new sample ready
+#define INT_PIN_CFG_LATCH       0x20 // INT_PIN_CFG: hold INT high until INT_STATUS is read
+#define ACCEL_HPF_MASK          0x07 // ACCEL_CONFIG: high-pass filter bits
+#define ACCEL_HPF_5HZ           0x01 // Motion detection runs on HPF output
+
+#define MPU6050_FIFO_SIZE       1024 // Bytes of FIFO on the chip
+#define FIFO_READ_CHUNK         120  // Bytes per burst, fits the Wire buffer
+
+// Size of the contiguous ACCEL_XOUT_H..ACCEL_ZOUT_L block
+#define ACCEL_BURST_LENGTH 6
+
+// Size of the contiguous ACCEL_XOUT_H..GYRO_ZOUT_L block (accel, temp, gyro)
+#define MOTION_BURST_LENGTH 14
+
+// One raw accelerometer sample in sensor counts
+struct AccelSample {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+};
+
+// All seven channels from one burst read, in sensor counts
+struct MotionSample {
+    AccelSample accel;
+    int16_t temperature; // See temperatureCentiDegrees()
+    int16_t gyroX;
+    int16_t gyroY;
+    int16_t gyroZ;
+};
+
+// MPU6050 driver, parameterised at compile time on a bus policy: a type
+// with static functions
+//     int8_t    registerClient(const char *name, uint8_t address, uint32_t maxClock);
+//     I2CStatus writeRegister(int8_t client, uint8_t reg, uint8_t value);
+//     I2CStatus readRegisters(int8_t client, uint8_t reg, uint8_t *buffer, uint8_t length);
+//     bool      probe(uint8_t address);
+// The calls are resolved at compile time and inline into the driver, so the
+// production MPU6050_Raw (on SharedI2CBus) costs nothing over calling i2cBus
+// directly. Another policy puts a sensor on a different bus or replaces the
+// bus with a fake that records register traffic (RecordingBus in
+// test/fakes, used by test/test_bus_policy); several instances can share
+// one policy (e.g. sensors at 0x68 and 0x69). Member definitions are in
+// MPU6050_impl.h.
+template <class Bus>
+class MPU6050 {
 public:
     // Constructor
-    MPU6050_Raw(uint8_t address = MPU6050_ALT_ADDR);
+    MPU6050(uint8_t address = MPU6050_ALT_ADDR);
     
-    // Initialization
-    bool begin(uint8_t sda_pin, uint8_t scl_pin);
+    // Initialization (the shared i2cBus must already be started)
+    bool begin();
     bool isInitialized() const { return initialized; }
+    int8_t getBusClient() const { return busClient; }
     
-    // I2C device scanning
+    // Full bus scan for diagnostics; boot uses the cached deviceMap instead
     void scanI2CDevices();
-      // Accelerometer functions
-    void readAccelerometer(float &x, float &y, float &z);
+    
+    // Accelerometer functions
+    bool readAccelerometerRaw(AccelSample &sample); // Single burst transaction
+    bool readMotionRaw(MotionSample &sample);       // Accel, temp and gyro in one burst
+    bool readAccelerometer(float &x, float &y, float &z); // Zeros on failure
     bool detectShake(float threshold);
+    bool isShakeSample(const AccelSample &sample, float threshold) const; // Float reference
+    uint8_t getAccelerometerRange() const { return accelRange; }
     
     // Configuration
     void setAccelerometerRange(uint8_t range); // 0=±2g, 1=±4g, 2=±8g, 3=±16g
+    void setGyroRange(uint8_t range);          // 0=±250, 1=±500, 2=±1000, 3=±2000 °/s
+    uint8_t getGyroRange() const { return gyroRange; }
+    static int16_t temperatureCentiDegrees(int16_t raw); // Datasheet: raw / 340 + 36.53°C
+    void setSampleRateDivider(uint8_t divider); // Rate = gyro rate / (1 + divider)
+    void setDigitalLowPassFilter(uint8_t mode); // 0..6, see CONFIG DLPF_CFG
+    
+    // FIFO streaming (accelerometer samples only)
+    bool enableFifo();
+    void disableFifo();
+    void resetFifo();
+    bool isFifoEnabled() const { return fifoEnabled; }
+    uint16_t getFifoCount();
+    size_t readFifo(AccelSample *samples, size_t maxSamples); // Returns samples drained
+    uint32_t getFifoSampleCount() const { return fifoSampleCount; }
+    uint32_t getFifoOverflowCount() const { return fifoOverflowCount; }
+    
+    // Motion-detection interrupt on the INT pin (active high, latched)
+    bool enableMotionInterrupt(uint8_t threshold, uint8_t durationMs); // threshold: 1 LSB = 2mg
+    void disableMotionInterrupt();
+    void setInterruptSources(uint8_t sources); // INT_ENABLE_* bits; keeps the pin config
+    uint8_t readInterruptStatus(); // Reading clears the latched INT pin
     
     // Debug functions
     void printAccelData();
     uint8_t getWhoAmI();
     uint8_t getPowerManagement();
+    
+    // I2C bus statistics (per instance)
+    uint32_t getTransactionCount() const { return transactionCount; }
+    uint32_t getBytesTransferred() const { return bytesTransferred; }
+    void resetBusStats() { transactionCount = 0; bytesTransferred = 0; }
+    // Outcome of the most recent transaction: why a read returned false
+    I2CStatus getLastStatus() const { return lastStatus; }
 
 private:
     uint8_t mpuAddress;
+    int8_t busClient;
     bool initialized;
     float accelSensitivity;
+    uint8_t accelRange;
+    uint8_t gyroRange;
+    float shakeBandThreshold;   // Threshold the cached band was computed for
+    uint32_t shakeBandUpperSq;  // Squared magnitude band in raw counts
+    uint32_t shakeBandLowerSq;
     unsigned long lastPrintTime;
+    uint32_t transactionCount;
+    uint32_t bytesTransferred;
+    I2CStatus lastStatus;
+    bool fifoEnabled;
+    uint32_t fifoSampleCount;
+    uint32_t fifoOverflowCount;
     
     // Raw I2C communication
-    void writeRegister(uint8_t reg, uint8_t value);
-    uint8_t readRegister(uint8_t reg);
+    I2CStatus writeRegister(uint8_t reg, uint8_t value);
+    uint8_t readRegister(uint8_t reg);   // 0 on failure, see lastStatus
     int16_t readRegister16(uint8_t reg);
+    I2CStatus readRegisters(uint8_t reg, uint8_t *buffer, uint8_t length);
     
     // Internal functions
     bool testConnection();
     bool wakeUpDevice();
     void updateAccelSensitivity();
+    void updateShakeBand(float threshold);
 };
 
+// The driver used by the firmware, on the shared i2cBus; instantiated once
+// in src/MPU6050_Raw.cpp
+typedef MPU6050<SharedI2CBus> MPU6050_Raw;
+extern template class MPU6050<SharedI2CBus>;
+
 #endif // MPU6050_RAW_H
@@ -0,0 +1,590 @@
+#ifndef MPU6050_IMPL_H
+#define MPU6050_IMPL_H
+
+// Member definitions of the MPU6050 driver template. Included by
+// src/MPU6050_Raw.cpp, which instantiates the production MPU6050_Raw once,
+// and by code that instantiates the driver on another bus policy.
+#include "MPU6050_Raw.h"
+#include "ShakeDetector.h"
+#include "Profiler.h"
+
+
+template <class Bus>
+MPU6050<Bus>::MPU6050(uint8_t address) {
+    mpuAddress = address;
+    busClient = I2C_NO_CLIENT;
+    initialized = false;
+    accelSensitivity = 4096.0; // Default for ±8g range
+    accelRange = MPU6050_DEFAULT_RANGE;
+    gyroRange = MPU6050_DEFAULT_GYRO_RANGE;
+    shakeBandThreshold = -1.0; // Forces computation on first detectShake()
+    shakeBandUpperSq = 0;
+    shakeBandLowerSq = 0;
+    lastPrintTime = 0;
+    transactionCount = 0;
+    bytesTransferred = 0;
+    lastStatus = I2C_OK;
+    fifoEnabled = false;
+    fifoSampleCount = 0;
+    fifoOverflowCount = 0;
+}
+
+template <class Bus>
+bool MPU6050<Bus>::begin() {
+    Serial.println("Initializing MPU6050 with raw I2C...");
+    
+    // Join the shared bus; the MPU6050 supports 400kHz fast mode
+    busClient = Bus::registerClient("MPU6050", mpuAddress, MPU6050_MAX_CLOCK);
+    if (busClient == I2C_NO_CLIENT) {
+        return false;
+    }
+    
+    // Test connection
+    if (!testConnection()) {
+        return false;
+    }
+    
+    // Wake up device
+    if (!wakeUpDevice()) {
+        return false;
+    }
+    
+    // Configure ±8g accelerometer and ±500°/s gyro ranges
+    setAccelerometerRange(MPU6050_DEFAULT_RANGE);
+    setGyroRange(MPU6050_DEFAULT_GYRO_RANGE);
+    
+    Serial.println("MPU6050 initialized successfully with raw I2C!");
+    initialized = true;
+    return true;
+}
+
+template <class Bus>
+void MPU6050<Bus>::scanI2CDevices() {
+    Serial.println("Scanning I2C devices...");
+    
+    int deviceCount = 0;
+    for (byte address = 1; address < 127; address++) {
+        if (Bus::probe(address)) {
+            Serial.print("I2C device found at address 0x");
+            if (address < 16) Serial.print("0");
+            Serial.print(address, HEX);
+            
+            switch(address) {
+                case MPU6050_DEFAULT_ADDR:
+                    Serial.print(" (MPU6050 - default address)");
+                    break;
+                case MPU6050_ALT_ADDR:
+                    Serial.print(" (MPU6050 - alternate address)");
+                    break;
+                default:
+                    Serial.print(" (Unknown device)");
+                    break;
+            }
+            Serial.println();
+            deviceCount++;
+        }
+    }
+    
+    if (deviceCount == 0) {
+        Serial.println("No I2C devices found!");
+    } else {
+        Serial.print("Found ");
+        Serial.print(deviceCount);
+        Serial.println(" I2C device(s)");
+    }
+}
+
+template <class Bus>
+bool MPU6050<Bus>::testConnection() {
+    // Check if MPU6050 responds
+    if (!Bus::probe(mpuAddress)) {
+        Serial.print("MPU6050 not responding at address 0x");
+        Serial.println(mpuAddress, HEX);
+        return false;
+    }
+    
+    Serial.println("MPU6050 responds to I2C ping");
+    
+    // Read WHO_AM_I register to verify device
+    uint8_t whoAmI = getWhoAmI();
+    Serial.print("WHO_AM_I register: 0x");
+    Serial.println(whoAmI, HEX);
+    
+    // WHO_AM_I should be 0x68 for MPU6050
+    if (whoAmI != 0x68) {
+        Serial.print("Unexpected WHO_AM_I value: 0x");
+        Serial.print(whoAmI, HEX);
+        Serial.println(" (expected 0x68)");
+        Serial.println("Continuing anyway - might still work...");
+    }
+    
+    return true;
+}
+
+template <class Bus>
+bool MPU6050<Bus>::wakeUpDevice() {
+    // Wake up the MPU6050 (it starts in sleep mode)
+    Serial.println("Waking up MPU6050...");
+    writeRegister(PWR_MGMT_1, 0x00);
+    delay(100);
+    
+    // Verify wake-up by reading power management register
+    uint8_t pwrMgmt = getPowerManagement();
+    Serial.print("Power management register: 0x");
+    Serial.println(pwrMgmt, HEX);
+    
+    if (pwrMgmt & 0x40) {
+        Serial.println("WARNING: Device still in sleep mode");
+        // Try again
+        writeRegister(PWR_MGMT_1, 0x00);
+        delay(100);
+        pwrMgmt = getPowerManagement();
+        Serial.print("Power management after retry: 0x");
+        Serial.println(pwrMgmt, HEX);
+        
+        if (pwrMgmt & 0x40) {
+            Serial.println("ERROR: Failed to wake up device");
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+template <class Bus>
+void MPU6050<Bus>::setAccelerometerRange(uint8_t range) {
+    // Set accelerometer range (register 0x1C)
+    // 0 = ±2g, 1 = ±4g, 2 = ±8g, 3 = ±16g
+    writeRegister(ACCEL_CONFIG, range << 3);
+    updateAccelSensitivity();
+    
+    Serial.print("Accelerometer range set to ±");
+    switch(range) {
+        case 0: Serial.println("2g"); break;
+        case 1: Serial.println("4g"); break;
+        case 2: Serial.println("8g"); break;
+        case 3: Serial.println("16g"); break;
+        default: Serial.println("unknown"); break;
+    }
+}
+
+template <class Bus>
+void MPU6050<Bus>::setGyroRange(uint8_t range) {
+    // FS_SEL occupies bits 4:3 of GYRO_CONFIG; self-test bits stay cleared
+    writeRegister(GYRO_CONFIG, (range & 0x03) << 3);
+    gyroRange = (readRegister(GYRO_CONFIG) >> 3) & 0x03;
+    
+    Serial.print("Gyro range set to ±");
+    Serial.print(250 << gyroRange);
+    Serial.println("°/s");
+}
+
+template <class Bus>
+int16_t MPU6050<Bus>::temperatureCentiDegrees(int16_t raw) {
+    return (int32_t)raw * 10 / 34 + 3653;
+}
+
+template <class Bus>
+void MPU6050<Bus>::setSampleRateDivider(uint8_t divider) {
+    // Sample rate = gyro output rate / (1 + divider), where the gyro output
+    // rate is 1kHz with the DLPF enabled and 8kHz without it
+    writeRegister(SMPLRT_DIV, divider);
+}
+
+template <class Bus>
+void MPU6050<Bus>::setDigitalLowPassFilter(uint8_t mode) {
+    // DLPF_CFG occupies bits 2:0 of CONFIG; keep EXT_SYNC_SET cleared
+    writeRegister(MPU_CONFIG, mode & 0x07);
+}
+
+template <class Bus>
+void MPU6050<Bus>::updateAccelSensitivity() {
+    uint8_t config = readRegister(ACCEL_CONFIG);
+    uint8_t range = (config >> 3) & 0x03;
+    accelRange = range;
+    shakeBandThreshold = -1.0; // Band is in raw counts, recompute for the new range
+    
+    switch(range) {
+        case 0: accelSensitivity = 16384.0; break; // ±2g
+        case 1: accelSensitivity = 8192.0;  break; // ±4g
+        case 2: accelSensitivity = 4096.0;  break; // ±8g
+        case 3: accelSensitivity = 2048.0;  break; // ±16g
+        default: accelSensitivity = 4096.0; break; // Default to ±8g
+    }
+}
+
+template <class Bus>
+bool MPU6050<Bus>::readAccelerometerRaw(AccelSample &sample) {
+    PROFILE_ZONE("readAccelerometer");
+    if (!initialized) {
+        sample.x = sample.y = sample.z = 0;
+        return false;
+    }
+    
+    // Read all three axes (6 bytes starting from ACCEL_XOUT_H) in one transaction
+    uint8_t buffer[ACCEL_BURST_LENGTH];
+    if (readRegisters(ACCEL_XOUT_H, buffer, ACCEL_BURST_LENGTH) != I2C_OK) {
+        sample.x = sample.y = sample.z = 0;
+        return false;
+    }
+    
+    sample.x = (int16_t)((buffer[0] << 8) | buffer[1]);
+    sample.y = (int16_t)((buffer[2] << 8) | buffer[3]);
+    sample.z = (int16_t)((buffer[4] << 8) | buffer[5]);
+    return true;
+}
+
+template <class Bus>
+bool MPU6050<Bus>::readMotionRaw(MotionSample &sample) {
+    PROFILE_ZONE("readMotion");
+    memset(&sample, 0, sizeof(sample));
+    if (!initialized) {
+        return false;
+    }
+    
+    // Accel, temperature and gyro registers are contiguous from ACCEL_XOUT_H,
+    // so all seven channels come from the same instant in one transaction
+    uint8_t buffer[MOTION_BURST_LENGTH];
+    if (readRegisters(ACCEL_XOUT_H, buffer, MOTION_BURST_LENGTH) != I2C_OK) {
+        return false;
+    }
+    
+    sample.accel.x = (int16_t)((buffer[0] << 8) | buffer[1]);
+    sample.accel.y = (int16_t)((buffer[2] << 8) | buffer[3]);
+    sample.accel.z = (int16_t)((buffer[4] << 8) | buffer[5]);
+    sample.temperature = (int16_t)((buffer[6] << 8) | buffer[7]);
+    sample.gyroX = (int16_t)((buffer[8] << 8) | buffer[9]);
+    sample.gyroY = (int16_t)((buffer[10] << 8) | buffer[11]);
+    sample.gyroZ = (int16_t)((buffer[12] << 8) | buffer[13]);
+    return true;
+}
+
+template <class Bus>
+bool MPU6050<Bus>::readAccelerometer(float &x, float &y, float &z) {
+    AccelSample sample;
+    if (!readAccelerometerRaw(sample)) {
+        x = y = z = 0.0;
+        return false;
+    }
+    
+    // Convert to g (gravitational acceleration)
+    x = sample.x / accelSensitivity;
+    y = sample.y / accelSensitivity;
+    z = sample.z / accelSensitivity;
+    return true;
+}
+
+template <class Bus>
+bool MPU6050<Bus>::detectShake(float threshold) {
+    AccelSample sample;
+    if (!readAccelerometerRaw(sample)) {
+        return false;
+    }
+    
+    if (threshold != shakeBandThreshold) {
+        updateShakeBand(threshold);
+    }
+    
+    // Integer comparison of squared magnitude, see FixedPointShakeDetector
+    uint32_t magnitudeSq = (uint32_t)((int32_t)sample.x * sample.x) +
+                           (uint32_t)((int32_t)sample.y * sample.y) +
+                           (uint32_t)((int32_t)sample.z * sample.z);
+    return magnitudeSq > shakeBandUpperSq || magnitudeSq < shakeBandLowerSq;
+}
+
+template <class Bus>
+void MPU6050<Bus>::updateShakeBand(float threshold) {
+    uint16_t thresholdMilliG = (uint16_t)(threshold * 1000.0 + 0.5);
+    
+    switch(accelRange) {
+        case 0:
+            shakeBandUpperSq = FixedPointShakeDetector<ACCEL_RANGE_2G>::upperBandSq(thresholdMilliG);
+            shakeBandLowerSq = FixedPointShakeDetector<ACCEL_RANGE_2G>::lowerBandSq(thresholdMilliG);
+            break;
+        case 1:
+            shakeBandUpperSq = FixedPointShakeDetector<ACCEL_RANGE_4G>::upperBandSq(thresholdMilliG);
+            shakeBandLowerSq = FixedPointShakeDetector<ACCEL_RANGE_4G>::lowerBandSq(thresholdMilliG);
+            break;
+        case 2:
+            shakeBandUpperSq = FixedPointShakeDetector<ACCEL_RANGE_8G>::upperBandSq(thresholdMilliG);
+            shakeBandLowerSq = FixedPointShakeDetector<ACCEL_RANGE_8G>::lowerBandSq(thresholdMilliG);
+            break;
+        default:
+            shakeBandUpperSq = FixedPointShakeDetector<ACCEL_RANGE_16G>::upperBandSq(thresholdMilliG);
+            shakeBandLowerSq = FixedPointShakeDetector<ACCEL_RANGE_16G>::lowerBandSq(thresholdMilliG);
+            break;
+    }
+    shakeBandThreshold = threshold;
+}
+
+template <class Bus>
+bool MPU6050<Bus>::isShakeSample(const AccelSample &sample, float threshold) const {
+    float x = sample.x / accelSensitivity;
+    float y = sample.y / accelSensitivity;
+    float z = sample.z / accelSensitivity;
+    
+    // Calculate total acceleration magnitude
+    float totalAccel = sqrt(x*x + y*y + z*z);
+    
+    // Detect shake (acceleration significantly different from 1g)
+    return fabs(totalAccel - 1.0) > threshold;
+}
+
+template <class Bus>
+bool MPU6050<Bus>::enableFifo() {
+    if (!initialized) {
+        return false;
+    }
+    
+    // Route only the accelerometer into the FIFO, then reset and enable it
+    writeRegister(FIFO_EN, FIFO_EN_ACCEL);
+    writeRegister(USER_CTRL, USER_CTRL_FIFO_RESET);
+    writeRegister(USER_CTRL, USER_CTRL_FIFO_EN);
+    
+    fifoEnabled = (readRegister(USER_CTRL) & USER_CTRL_FIFO_EN) != 0;
+    if (!fifoEnabled) {
+        Serial.println("ERROR: Failed to enable MPU6050 FIFO");
+        writeRegister(FIFO_EN, 0x00);
+        return false;
+    }
+    
+    // Clear a stale overflow flag
+    readRegister(INT_STATUS);
+    Serial.println("MPU6050 FIFO streaming enabled");
+    return true;
+}
+
+template <class Bus>
+void MPU6050<Bus>::disableFifo() {
+    writeRegister(USER_CTRL, 0x00);
+    writeRegister(FIFO_EN, 0x00);
+    fifoEnabled = false;
+}
+
+template <class Bus>
+void MPU6050<Bus>::resetFifo() {
+    // FIFO_RESET only takes effect while FIFO_EN is cleared
+    writeRegister(USER_CTRL, USER_CTRL_FIFO_RESET);
+    writeRegister(USER_CTRL, fifoEnabled ? USER_CTRL_FIFO_EN : 0x00);
+}
+
+template <class Bus>
+uint16_t MPU6050<Bus>::getFifoCount() {
+    uint8_t buffer[2];
+    if (readRegisters(FIFO_COUNTH, buffer, 2) != I2C_OK) {
+        return 0;
+    }
+    return (uint16_t)((buffer[0] << 8) | buffer[1]);
+}
+
+template <class Bus>
+size_t MPU6050<Bus>::readFifo(AccelSample *samples, size_t maxSamples) {
+    PROFILE_ZONE("readFifo");
+    if (!fifoEnabled || maxSamples == 0) {
+        return 0;
+    }
+    
+    // After an overflow the oldest bytes were overwritten and the stream may
+    // no longer be aligned to sample boundaries, so start over
+    uint16_t count = getFifoCount();
+    if ((readRegister(INT_STATUS) & INT_STATUS_FIFO_OFLOW) || count >= MPU6050_FIFO_SIZE) {
+        fifoOverflowCount++;
+        Serial.println("WARNING: MPU6050 FIFO overflow, samples dropped");
+        resetFifo();
+        return 0;
+    }
+    
+    size_t available = count / ACCEL_BURST_LENGTH;
+    size_t toRead = available < maxSamples ? available : maxSamples;
+    size_t drained = 0;
+    
+    // Read whole samples in bursts that fit the Wire receive buffer
+    uint8_t buffer[FIFO_READ_CHUNK];
+    while (drained < toRead) {
+        size_t chunkSamples = toRead - drained;
+        if (chunkSamples > FIFO_READ_CHUNK / ACCEL_BURST_LENGTH) {
+            chunkSamples = FIFO_READ_CHUNK / ACCEL_BURST_LENGTH;
+        }
+        uint8_t chunkBytes = chunkSamples * ACCEL_BURST_LENGTH;
+        
+        if (readRegisters(FIFO_R_W, buffer, chunkBytes) != I2C_OK) {
+            // A failed or short read loses sample alignment
+            resetFifo();
+            break;
+        }
+        
+        for (size_t i = 0; i < chunkSamples; i++) {
+            const uint8_t *b = &buffer[i * ACCEL_BURST_LENGTH];
+            AccelSample &sample = samples[drained + i];
+            sample.x = (int16_t)((b[0] << 8) | b[1]);
+            sample.y = (int16_t)((b[2] << 8) | b[3]);
+            sample.z = (int16_t)((b[4] << 8) | b[5]);
+        }
+        drained += chunkSamples;
+    }
+    
+    fifoSampleCount += drained;
+    return drained;
+}
+
+template <class Bus>
+bool MPU6050<Bus>::enableMotionInterrupt(uint8_t threshold, uint8_t durationMs) {
+    if (!initialized) {
+        return false;
+    }
+    
+    // Motion detection compares the high-pass filtered accelerometer output
+    // against MOT_THR for MOT_DUR consecutive 1ms samples
+    uint8_t accelConfig = readRegister(ACCEL_CONFIG);
+    writeRegister(ACCEL_CONFIG, (accelConfig & ~ACCEL_HPF_MASK) | ACCEL_HPF_5HZ);
+    writeRegister(MOT_THR, threshold);
+    writeRegister(MOT_DUR, durationMs);
+    
+    // Active high push-pull, latched until INT_STATUS is read
+    writeRegister(INT_PIN_CFG, INT_PIN_CFG_LATCH);
+    writeRegister(INT_ENABLE, INT_ENABLE_MOT);
+    
+    if (readRegister(INT_ENABLE) != INT_ENABLE_MOT || readRegister(MOT_THR) != threshold) {
+        Serial.println("ERROR: Failed to configure MPU6050 motion interrupt");
+        writeRegister(INT_ENABLE, 0x00);
+        return false;
+    }
+    
+    // Release any interrupt latched during configuration
+    readInterruptStatus();
+    
+    Serial.print("Motion interrupt enabled: threshold=");
+    Serial.print(threshold * 2);
+    Serial.print("mg, duration=");
+    Serial.print(durationMs);
+    Serial.println("ms");
+    return true;
+}
+
+template <class Bus>
+void MPU6050<Bus>::disableMotionInterrupt() {
+    writeRegister(INT_ENABLE, 0x00);
+    readInterruptStatus();
+}
+
+template <class Bus>
+void MPU6050<Bus>::setInterruptSources(uint8_t sources) {
+    writeRegister(INT_ENABLE, sources);
+}
+
+template <class Bus>
+uint8_t MPU6050<Bus>::readInterruptStatus() {
+    return readRegister(INT_STATUS);
+}
+
+template <class Bus>
+void MPU6050<Bus>::printAccelData() {
+    if (!initialized) {
+        Serial.println("MPU6050 not initialized");
+        return;
+    }
+    
+    // Print acceleration data every 500ms
+    if (millis() - lastPrintTime > 500) {
+        MotionSample motion;
+        readMotionRaw(motion);
+        float x = motion.accel.x / accelSensitivity;
+        float y = motion.accel.y / accelSensitivity;
+        float z = motion.accel.z / accelSensitivity;
+        float gyroSensitivity = 131.0 / (1 << gyroRange); // LSB per °/s
+        
+        float totalAccel = sqrt(x*x + y*y + z*z);
+        
+        Serial.print("Accel: X=");
+        Serial.print(x, 2);
+        Serial.print("g, Y=");
+        Serial.print(y, 2);
+        Serial.print("g, Z=");
+        Serial.print(z, 2);
+        Serial.print("g, Total=");
+        Serial.print(totalAccel, 2);
+        Serial.print("g, Diff from 1g=");
+        Serial.print(fabs(totalAccel - 1.0), 2);
+        Serial.print(", Gyro=");
+        Serial.print(motion.gyroX / gyroSensitivity, 0);
+        Serial.print("/");
+        Serial.print(motion.gyroY / gyroSensitivity, 0);
+        Serial.print("/");
+        Serial.print(motion.gyroZ / gyroSensitivity, 0);
+        Serial.print("dps, Temp=");
+        Serial.print(temperatureCentiDegrees(motion.temperature) / 100.0, 1);
+        Serial.print("C");
+        Serial.print(", I2C txns=");
+        Serial.print(transactionCount);
+        Serial.print(", bytes=");
+        Serial.print(bytesTransferred);
+        if (fifoEnabled) {
+            Serial.print(", FIFO samples=");
+            Serial.print(fifoSampleCount);
+            Serial.print(", overflows=");
+            Serial.print(fifoOverflowCount);
+        }
+        Serial.println();
+        
+        lastPrintTime = millis();
+    }
+}
+
+template <class Bus>
+uint8_t MPU6050<Bus>::getWhoAmI() {
+    return readRegister(WHO_AM_I);
+}
+
+template <class Bus>
+uint8_t MPU6050<Bus>::getPowerManagement() {
+    return readRegister(PWR_MGMT_1);
+}
+
+// Private methods
+// Each call below is one I2C transaction (the bus may retry it);
+// bytesTransferred counts the register address byte plus the data bytes of
+// successful transactions (not the device address). The outcome is kept in
+// lastStatus for callers that only see a bool or a zero value.
+template <class Bus>
+I2CStatus MPU6050<Bus>::writeRegister(uint8_t reg, uint8_t value) {
+    lastStatus = Bus::writeRegister(busClient, reg, value);
+    
+    transactionCount++;
+    if (lastStatus == I2C_OK) {
+        bytesTransferred += 2;
+    }
+    return lastStatus;
+}
+
+template <class Bus>
+uint8_t MPU6050<Bus>::readRegister(uint8_t reg) {
+    uint8_t value;
+    if (readRegisters(reg, &value, 1) != I2C_OK) {
+        return 0;
+    }
+    return value;
+}
+
+template <class Bus>
+int16_t MPU6050<Bus>::readRegister16(uint8_t reg) {
+    uint8_t buffer[2];
+    if (readRegisters(reg, buffer, 2) != I2C_OK) {
+        return 0;
+    }
+    return (int16_t)((buffer[0] << 8) | buffer[1]);
+}
+
+template <class Bus>
+I2CStatus MPU6050<Bus>::readRegisters(uint8_t reg, uint8_t *buffer, uint8_t length) {
+    // One write/repeated-start/read transaction; the MPU6050 auto-increments
+    // the register pointer
+    lastStatus = Bus::readRegisters(busClient, reg, buffer, length);
+    
+    transactionCount++;
+    if (lastStatus == I2C_OK) {
+        bytesTransferred += 1 + length;
+    }
+    return lastStatus;
+}
+
+#endif // MPU6050_IMPL_H
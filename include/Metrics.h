@@ -0,0 +1,67 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+#include "LatencyHistogram.h"
+
+#define METRICS_MAX_ENTRIES  56
+#define METRICS_CHUNK_SIZE   512 // Export text buffered per emit() call
+
+// Monotonic count. set() mirrors a count that is kept elsewhere.
+class MetricCounter {
+public:
+    MetricCounter() : value(0) {}
+    void inc(uint32_t amount = 1) { value += amount; }
+    void set(uint32_t count) { value = count; }
+    uint32_t get() const { return value; }
+private:
+    uint32_t value;
+};
+
+// Point-in-time value
+class MetricGauge {
+public:
+    MetricGauge() : value(0) {}
+    void set(int32_t newValue) { value = newValue; }
+    int32_t get() const { return value; }
+private:
+    int32_t value;
+};
+
+// Table of named metrics for the /metrics endpoint. Metrics are plain
+// objects owned by the code that updates them, so recording is a single
+// add or a bucket scan with no lookup and no allocation; the registry only
+// keeps pointers and names. Entries sharing a name (with different labels)
+// must be registered next to each other.
+class MetricsRegistry {
+public:
+    MetricsRegistry();
+
+    // name and labels are string literals, e.g. "http_requests_total", "handler=\"ask\""
+    void addCounter(const char *name, const char *help, MetricCounter &counter, const char *labels = 0);
+    void addGauge(const char *name, const char *help, MetricGauge &gauge, const char *labels = 0);
+    void addHistogram(const char *name, const char *help, LatencyHistogram &histogram);
+
+    // Prometheus text format, handed to emit() in chunks of at most METRICS_CHUNK_SIZE
+    void exportText(void (*emit)(const char *text, size_t length)) const;
+
+    uint8_t getCount() const { return count; }
+
+private:
+    enum Type { COUNTER, GAUGE, HISTOGRAM };
+    struct Entry {
+        const char *name;
+        const char *help;
+        const char *labels;
+        uint8_t type;
+        void *metric;
+    };
+    Entry entries[METRICS_MAX_ENTRIES];
+    uint8_t count;
+
+    void add(const char *name, const char *help, const char *labels, uint8_t type, void *metric);
+};
+
+extern MetricsRegistry metrics;
+
+#endif // METRICS_H
@@ -0,0 +1,69 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+
+// Time without a shake, button press or page request before stepping down
+#define POWER_IDLE_AFTER       30000  // ms
+#define POWER_DEEP_IDLE_AFTER  300000 // ms
+
+// Rough per-component draw in mA, for the current estimate only
+#define POWER_MA_CPU           15
+#define POWER_MA_CPU_SLEEP     1   // Forced light sleep
+#define POWER_MA_RADIO_AP      70
+#define POWER_MA_OLED          12
+#define POWER_MA_DFPLAYER      20
+#define POWER_MA_DFPLAYER_SLEEP 8
+#define POWER_MA_MPU6050       4
+
+enum PowerState {
+    POWER_ACTIVE,
+    POWER_IDLE,
+    POWER_DEEP_IDLE,
+    POWER_STATE_COUNT
+};
+
+// Decides the power state from the time since the last interaction and keeps
+// the books: time spent in each state and an integrated estimate of the
+// charge drawn. Applying a state (blanking the display, radio off, ...) is
+// left to the caller, which also reports its draw with setLoad().
+class PowerManager {
+public:
+    PowerManager();
+
+    void noteActivity(unsigned long now);
+    bool update(unsigned long now); // True when the state changed
+
+    PowerState getState() const { return state; }
+    static const char *getStateName(PowerState state);
+
+    // Estimated draw of the current configuration
+    void setLoad(uint16_t milliAmps, unsigned long now);
+    uint16_t getLoad() const { return loadMilliAmps; }
+
+    uint32_t getTimeInState(PowerState state, unsigned long now) const; // ms
+    uint32_t getTransitionCount() const { return transitions; }
+    uint16_t getAverageMilliAmps(unsigned long now) const;
+
+    // Forced light sleep with the radio off, until timeout or wakePin goes
+    // high. A timeout of 0 sleeps until the pin wakes it. The SDK's wake-up
+    // setup replaces any attachInterrupt() handler on wakePin; the caller
+    // must attach it again afterwards.
+    static void lightSleep(uint32_t timeoutMs, uint8_t wakePin);
+
+private:
+    PowerState state;
+    unsigned long lastActivity;
+    unsigned long stateSince;
+    uint32_t stateTime[POWER_STATE_COUNT];
+    uint32_t transitions;
+
+    uint16_t loadMilliAmps;
+    unsigned long loadSince;
+    uint64_t chargeMilliAmpMs; // Integral of load over time since boot
+
+    void accumulate(unsigned long now);
+    void enter(PowerState next, unsigned long now);
+};
+
+#endif // POWER_MANAGER_H
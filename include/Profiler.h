@@ -0,0 +1,74 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Scoped cycle-count profiler, built only with -DMAGIC8BALL_PROFILER
+// (pio run -e esp12e_profiler). PROFILE_ZONE("name") records begin/end
+// records for the enclosing scope into a fixed ring; PROFILE_FRAME("loop")
+// does the same and marks the start of a frame. /profile?frames=N dumps the
+// last N complete frames as Chrome trace-event JSON (chrome://tracing,
+// ui.perfetto.dev). Without the flag both macros expand to nothing.
+#ifdef MAGIC8BALL_PROFILER
+
+#include <Arduino.h>
+
+#define PROFILER_RING_SIZE     256 // Records (12 bytes each)
+#define PROFILER_DEFAULT_FRAMES 4
+#define PROFILER_CHUNK_SIZE    512
+
+class Profiler {
+public:
+    Profiler();
+
+    void begin(const char *zone, bool frameStart = false) { record(zone, frameStart ? FRAME_BEGIN : BEGIN); }
+    void end(const char *zone) { record(zone, END); }
+
+    // Trace JSON for the last complete frames, handed to emit() in chunks
+    void exportTrace(uint8_t frames, void (*emit)(const char *text, size_t length));
+
+    uint32_t getRecordCount() const { return recordCount; }
+
+private:
+    enum Phase { END, BEGIN, FRAME_BEGIN };
+    struct Record {
+        const char *zone;
+        uint32_t cycles;
+        uint8_t phase;
+    };
+    Record ring[PROFILER_RING_SIZE];
+    uint16_t head;
+    uint32_t recordCount;
+
+    void record(const char *zone, uint8_t phase) {
+        Record &entry = ring[head];
+        entry.zone = zone;
+        entry.phase = phase;
+        entry.cycles = ESP.getCycleCount();
+        head = (head + 1) % PROFILER_RING_SIZE;
+        recordCount++;
+    }
+};
+
+extern Profiler profiler;
+
+// RAII helper behind the macros
+class ProfileScope {
+public:
+    ProfileScope(const char *zone, bool frameStart) : zone(zone) { profiler.begin(zone, frameStart); }
+    ~ProfileScope() { profiler.end(zone); }
+private:
+    const char *zone;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name)  ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name, false)
+#define PROFILE_FRAME(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name, true)
+
+#else
+
+#define PROFILE_ZONE(name)
+#define PROFILE_FRAME(name)
+
+#endif // MAGIC8BALL_PROFILER
+
+#endif // PROFILER_H
@@ -0,0 +1,65 @@
+#ifndef RESPONSE_CATALOG_H
+#define RESPONSE_CATALOG_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+
+#define CATALOG_PATH             "/catalog.bin"
+#define CATALOG_UPLOAD_PATH      "/catalog.tmp"
+#define CATALOG_SELECTION_PATH   "/catalog.sel"
+#define CATALOG_MAGIC            "M8BC"
+#define CATALOG_VERSION          1
+#define CATALOG_MAX_SETS         8
+#define CATALOG_MAX_ENTRY_LENGTH 80
+#define CATALOG_NAME_LENGTH      10 // Including the NUL padding
+
+// Answer sets stored on LittleFS in the binary format written by
+// tools/build_catalog.py: a header, a table of sets, a u32 offset index per
+// set and the packed strings. Only the header and set table are read when a
+// catalog is opened; getEntry() seeks to one index pair and reads that one
+// string, so catalogs of thousands of entries never touch the heap.
+class ResponseCatalog {
+public:
+    ResponseCatalog();
+
+    // Mount LittleFS, open CATALOG_PATH and restore the saved selection
+    bool begin();
+
+    // Check a catalog file end to end (header, CRC, every offset, and that
+    // every entry fits the two-line answer layout)
+    static bool validate(const char *path);
+    // Replace the catalog with a validated upload
+    bool install(const char *uploadPath);
+
+    bool isActive() const { return active; }
+    uint8_t getSetCount() const { return setCount; }
+    const char *getSetName(uint8_t set) const;
+    uint16_t getSetEntryCount(uint8_t set) const;
+    int8_t findSet(const char *name) const;
+
+    // Pick the set answers come from; -1 selects the built-in answers
+    bool select(int8_t set);
+    int8_t getSelectedSet() const { return active ? selected : -1; }
+    uint16_t getEntryCount() const;
+
+    // Copy entry text into buffer (NUL terminated); returns its length, 0 on error
+    size_t getEntry(uint16_t index, char *buffer, size_t bufferSize);
+
+private:
+    struct SetInfo {
+        char name[CATALOG_NAME_LENGTH + 1];
+        uint16_t entryCount;
+        uint32_t indexOffset;
+    };
+    File file;
+    SetInfo sets[CATALOG_MAX_SETS];
+    uint8_t setCount;
+    int8_t selected;
+    bool mounted;
+    bool active;
+
+    bool open();
+    void saveSelection();
+};
+
+#endif // RESPONSE_CATALOG_H
@@ -0,0 +1,38 @@
+#ifndef RESPONSE_LAYOUT_H
+#define RESPONSE_LAYOUT_H
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+#define LAYOUT_MAX_LINES      2
+#define LAYOUT_MAX_LINE_CHARS 21  // 128px / 6px font
+#define LAYOUT_REVEAL_STEPS   3   // Progressive reveal frames; the last shows everything
+
+// One line of a wrapped response, as a slice of the original string
+struct ResponseLine {
+    uint8_t offset;
+    uint8_t length;
+};
+
+// Word-wrapped, centred layout of a response. Positions are precomputed for
+// every reveal step, so drawing a frame is just drawStr() calls on slices of
+// the response - no String objects and no width measurements per frame.
+struct ResponseLayout {
+    uint8_t lineCount;
+    ResponseLine lines[LAYOUT_MAX_LINES];
+    uint8_t revealLength[LAYOUT_REVEAL_STEPS][LAYOUT_MAX_LINES]; // Visible chars per line
+    uint8_t revealX[LAYOUT_REVEAL_STEPS][LAYOUT_MAX_LINES];      // Left edge per line
+};
+
+// Measures with the display's current font; call after setFont()
+void layoutResponse(U8G2 &display, const char *text, ResponseLayout &layout);
+
+// True if layoutResponse() shows all of the text; anything past the second
+// line would be cut off. Catalog validation rejects entries that don't fit.
+bool responseFits(const char *text, size_t length);
+
+// Draws one line of a layout at the given reveal step and baseline
+void drawResponseLine(U8G2 &display, const char *text, const ResponseLayout &layout,
+                      uint8_t step, uint8_t line, int y);
+
+#endif // RESPONSE_LAYOUT_H
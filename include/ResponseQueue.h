@@ -0,0 +1,51 @@
+#ifndef RESPONSE_QUEUE_H
+#define RESPONSE_QUEUE_H
+
+#include <stdint.h>
+
+#define RESPONSE_QUEUE_SIZE    8
+#define RESPONSE_EVENT_MAX_AGE 10000 // ms before a queued answer is considered stale
+
+// Where an answer was asked for
+enum ResponseSource {
+    SOURCE_SHAKE,
+    SOURCE_BUTTON,
+    SOURCE_WEB,
+    SOURCE_FLIP
+};
+
+// "Show this answer" request for the physical device
+struct ResponseEvent {
+    uint16_t responseIndex;
+    uint8_t source;
+    unsigned long queuedAt;
+};
+
+// Fixed-size FIFO of answers waiting to be animated. Producers (web handler,
+// shake, button) return immediately; loop() plays events in order once the
+// display is free. When full, the oldest event is dropped, and events older
+// than RESPONSE_EVENT_MAX_AGE are discarded instead of played.
+class ResponseQueue {
+public:
+    ResponseQueue();
+
+    void push(const ResponseEvent &event);
+    bool pop(ResponseEvent &event, unsigned long now);
+
+    uint8_t size() const { return count; }
+    uint8_t getMaxDepth() const { return maxDepth; }
+    uint32_t getEnqueuedCount() const { return enqueued; }
+    uint32_t getDroppedCount() const { return dropped; }
+    uint32_t getStaleCount() const { return stale; }
+
+private:
+    ResponseEvent events[RESPONSE_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+    uint8_t maxDepth;
+    uint32_t enqueued;
+    uint32_t dropped;
+    uint32_t stale;
+};
+
+#endif // RESPONSE_QUEUE_H
@@ -0,0 +1,69 @@
+#ifndef SHAKE_DETECTOR_H
+#define SHAKE_DETECTOR_H
+
+#include <stdint.h>
+#include "MPU6050_Raw.h"
+
+// Accelerometer full-scale ranges (ACCEL_CONFIG AFS_SEL)
+#define ACCEL_RANGE_2G  0
+#define ACCEL_RANGE_4G  1
+#define ACCEL_RANGE_8G  2
+#define ACCEL_RANGE_16G 3
+
+// Integer shake detector equivalent to |sqrt(x² + y² + z²) / sensitivity - 1g| > threshold.
+// Instead of converting to g and taking a square root, the squared magnitude
+// in raw counts is compared against a squared threshold band precomputed in
+// counts². Sensitivity is 16384 >> Range counts/g, so everything the float
+// path divides by is a compile-time shift.
+//
+// The band is rounded so that the integer comparison is exact: a sample is a
+// shake here if and only if its true magnitude lies outside
+// [1g - threshold, 1g + threshold]. No heap, no floats, no division per sample.
+template <uint8_t Range>
+class FixedPointShakeDetector {
+public:
+    static_assert(Range <= ACCEL_RANGE_16G, "Range must be 0 (±2g) .. 3 (±16g)");
+
+    static constexpr uint8_t kOneGShift = 14 - Range;
+    static constexpr uint32_t kOneG = 1UL << kOneGShift; // Counts per g
+
+    constexpr explicit FixedPointShakeDetector(uint16_t thresholdMilliG)
+        : upperSq(upperBandSq(thresholdMilliG)), lowerSq(lowerBandSq(thresholdMilliG)) {}
+
+    bool isShake(const AccelSample &sample) const {
+        // Each square is at most 2^30, so the sum of three fits in 32 bits
+        uint32_t magnitudeSq = (uint32_t)((int32_t)sample.x * sample.x) +
+                               (uint32_t)((int32_t)sample.y * sample.y) +
+                               (uint32_t)((int32_t)sample.z * sample.z);
+        return magnitudeSq > upperSq || magnitudeSq < lowerSq;
+    }
+
+    uint32_t upperBound() const { return upperSq; }
+    uint32_t lowerBound() const { return lowerSq; }
+
+    // |a| > (1000 + t) / 1000 g  <=>  |a|² > floor(((1000 + t) * 1g)² / 10^6)
+    static constexpr uint32_t upperBandSq(uint16_t thresholdMilliG) {
+        return clampBand(squareCounts(1000UL + thresholdMilliG) / 1000000ULL);
+    }
+
+    // |a| < (1000 - t) / 1000 g  <=>  |a|² < ceil(((1000 - t) * 1g)² / 10^6)
+    // A threshold of 1g or more leaves no lower band.
+    static constexpr uint32_t lowerBandSq(uint16_t thresholdMilliG) {
+        return thresholdMilliG >= 1000 ? 0 :
+            clampBand((squareCounts(1000UL - thresholdMilliG) + 999999ULL) / 1000000ULL);
+    }
+
+private:
+    uint32_t upperSq;
+    uint32_t lowerSq;
+
+    static constexpr uint64_t squareCounts(uint32_t milliG) {
+        return (uint64_t)(milliG * kOneG) * (milliG * kOneG);
+    }
+
+    static constexpr uint32_t clampBand(uint64_t value) {
+        return value > 0xFFFFFFFFULL ? 0xFFFFFFFFUL : (uint32_t)value;
+    }
+};
+
+#endif // SHAKE_DETECTOR_H
@@ -0,0 +1,47 @@
+#ifndef SPRITE_CACHE_H
+#define SPRITE_CACHE_H
+
+#include <Arduino.h>
+#include <U8g2lib.h>
+
+// Radii the 8-ball is ever drawn at: 16 +/- 2 for the welcome pulse, 18 for
+// the response screen (shake frames only offset the same sprite)
+#define BALL_SPRITE_MIN_RADIUS 14
+#define BALL_SPRITE_MAX_RADIUS 18
+#define BALL_SPRITE_COUNT      (BALL_SPRITE_MAX_RADIUS - BALL_SPRITE_MIN_RADIUS + 1)
+
+// Bytes for one XBM sprite of side 2r+1 (rows padded to whole bytes)
+#define BALL_SPRITE_SIDE(r)    (2 * (r) + 1)
+#define BALL_SPRITE_BYTES(r)   (((BALL_SPRITE_SIDE(r) + 7) / 8) * BALL_SPRITE_SIDE(r))
+
+// Pre-rendered 8-ball bitmaps. build() rasterises each radius once at boot
+// with the original circle/glyph/line drawing code and captures the result
+// as XBM, so a frame costs a single drawXBM() instead of three circles, a
+// glyph and a line.
+class BallSpriteCache {
+public:
+    typedef void (*RasterizeFunction)(int centerX, int centerY, int radius, int shakeOffset);
+
+    BallSpriteCache();
+
+    // Uses (and clears) the display buffer as a scratch canvas
+    void build(U8G2 &display, RasterizeFunction rasterize);
+    bool isBuilt() const { return built; }
+
+    // Draws the sprite centred on (centerX, centerY); false if not cached
+    bool draw(U8G2 &display, int centerX, int centerY, int radius) const;
+
+    size_t getMemoryUsage() const { return sizeof(pool); }
+
+private:
+    uint8_t pool[BALL_SPRITE_BYTES(14) + BALL_SPRITE_BYTES(15) + BALL_SPRITE_BYTES(16) +
+                 BALL_SPRITE_BYTES(17) + BALL_SPRITE_BYTES(18)];
+    uint16_t offsets[BALL_SPRITE_COUNT];
+    bool built;
+};
+
+// Pulse radius offset for the welcome animation: (int)(2 * sin(2*PI * t / 2000))
+// as a table of breakpoints over the 2s cycle instead of a soft-float sin()
+int pulseRadiusOffset(unsigned long timeMs);
+
+#endif // SPRITE_CACHE_H
@@ -0,0 +1,114 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "MPU6050_Raw.h"
+
+#define TRACE_PATH              "/trace.bin"
+#define TRACE_MAGIC             "M8BT"
+#define TRACE_VERSION           1
+#define TRACE_BLOCK_SIZE        512
+#define TRACE_BLOCK_HEADER_SIZE 16
+#define TRACE_SAMPLE_SIZE       8
+#define TRACE_BLOCK_SAMPLES     ((TRACE_BLOCK_SIZE - TRACE_BLOCK_HEADER_SIZE) / TRACE_SAMPLE_SIZE) // 62
+#define TRACE_FILE_BLOCKS       128   // 64KB ring, ~2.6 minutes at 50Hz
+#define TRACE_PRETRIGGER_SAMPLES 64   // Kept in RAM while armed, ~1.3s at 50Hz
+#define TRACE_POSTTRIGGER_MS    2000  // Recorded after each shake in auto mode
+#define TRACE_DEFAULT_MS        30000 // Manual recording without a duration
+#define TRACE_MAX_MS            600000
+
+// Block flags
+#define TRACE_FLAG_START        0x01 // First block of a recording
+#define TRACE_FLAG_SHAKE        0x02 // A shake was recognised during this block
+#define TRACE_FLAG_GAP          0x04 // Samples were dropped before this block
+
+// Records raw accelerometer samples to a ring of fixed-size blocks in
+// TRACE_PATH on LittleFS. Samples are packed into one of two RAM staging
+// blocks (addSample() is safe to call from the FIFO drain during a display
+// flush); service() writes full blocks from loop(). Blocks go round the ring
+// in order, and LittleFS moves rewritten blocks around the flash, so the
+// same sectors are not erased over and over.
+//
+// Block format (little-endian), read by tools/trace_dump.py:
+//     0  char[4]  "M8BT"
+//     4  u32      sequence number, increasing across the ring and reboots
+//     8  u32      millis() of the first sample
+//    12  u8       version, u8 accelerometer range (0=±2g .. 3=±16g),
+//                 u8 sample count, u8 flags (TRACE_FLAG_*)
+//    16  samples  u16 ms since the previous sample (0 for the first),
+//                 int16 x, y, z in raw counts; unused samples are zero
+// A reader sorts the blocks by sequence; the oldest comes first in /trace.bin.
+class TraceRecorder {
+public:
+    enum State { TRACE_IDLE, TRACE_ARMED, TRACE_RECORDING };
+
+    TraceRecorder();
+
+    // Mount LittleFS and find where the ring continues
+    bool begin(uint8_t accelRange);
+
+    // Record for durationMs, or until stop()
+    void start(unsigned long durationMs, unsigned long now);
+    void stop();
+    // Auto mode keeps the last samples in RAM and records around each shake
+    void setAuto(bool enabled);
+    void clear();
+
+    // Feed every sensor sample; cheap when idle
+    void addSample(const AccelSample &sample, unsigned long sampleTime);
+    // A shake was recognised at sampleTime
+    void trigger(unsigned long sampleTime);
+    // Write staged blocks to flash and end timed recordings; call from loop()
+    void service(unsigned long now);
+
+    // Whole ring, oldest block first, in one emit() per block
+    void exportBlocks(void (*emit)(const char *text, size_t length));
+
+    State getState() const { return state; }
+    bool isRecording() const { return state == TRACE_RECORDING; }
+    bool isAuto() const { return autoMode; }
+    uint16_t getStoredBlocks() const { return storedBlocks; }
+    uint32_t getSampleCount() const { return sampleCount; }
+    uint32_t getDroppedCount() const { return droppedCount; }
+    uint32_t getWriteErrorCount() const { return writeErrors; }
+
+private:
+    struct PretriggerSample {
+        AccelSample sample;
+        unsigned long time;
+    };
+
+    File file;
+    bool ready;
+    State state;
+    bool autoMode;
+    uint8_t range;
+    unsigned long stopAt;
+
+    // Double-buffered staging: one block fills while the other waits for flash
+    uint8_t staging[2][TRACE_BLOCK_SIZE];
+    uint8_t fillIndex;
+    uint8_t fillCount;
+    bool pending[2];
+    unsigned long lastSampleTime;
+    uint8_t nextFlags;
+
+    PretriggerSample pretrigger[TRACE_PRETRIGGER_SAMPLES];
+    uint8_t pretriggerHead;
+    uint8_t pretriggerCount;
+
+    uint32_t nextSequence;
+    uint16_t nextBlock;     // Ring slot the next block is written to
+    uint16_t storedBlocks;  // Slots in use, up to TRACE_FILE_BLOCKS
+    uint32_t sampleCount;
+    uint32_t droppedCount;
+    uint32_t writeErrors;
+
+    void stage(const AccelSample &sample, unsigned long sampleTime);
+    void openBlock(unsigned long sampleTime);
+    void closeBlock();
+    void writeBlock(uint8_t *block);
+};
+
+#endif // TRACE_RECORDER_H
@@ -0,0 +1,21 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+// On-device microbenchmarks, built only with -DMAGIC8BALL_BENCHMARKS
+// (pio run -e esp12e_benchmarks). Results are printed to Serial in CPU
+// cycles measured with ESP.getCycleCount().
+#ifdef MAGIC8BALL_BENCHMARKS
+
+void runBenchmarks();
+void benchmarkShakeDetection();
+void benchmarkBusPolicy();
+void benchmarkGestureEngine();
+void benchmarkFlipDetector();
+void benchmarkBallRendering();
+void benchmarkResponseLayout();
+void benchmarkCatalogLookup();
+void benchmarkPageGeneration();
+
+#endif // MAGIC8BALL_BENCHMARKS
+
+#endif // BENCHMARKS_H
@@ -5,43 +5,183 @@
 #include <math.h>
 #include <U8g2lib.h>
 #include <Wire.h>
+#include "GestureEngine.h"
+#include "FlipDetector.h"
+#include "ResponseQueue.h"
+#include "ResponseCatalog.h"
+#include "TraceRecorder.h"
 
 // OLED display settings for SH1106
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 #define SCREEN_ADDRESS 0x3C // I2C address for SH1106
+#define SH1106_MAX_CLOCK 400000 // Fast-mode I2C
 
 // I2C pin definitions for MPU6050 and OLED (shared I2C bus)
 #define MPU_SDA D2      // GPIO4 - Standard I2C pins
 #define MPU_SCL D1      // GPIO5
 
+// Main loop pacing. Animations are advanced from loop() one frame at a time,
+// so the interval only bounds frame timing jitter.
+#define LOOP_INTERVAL_MS        20
+#define LOOP_STATS_INTERVAL     10000 // ms between loop latency reports
+#define LOOP_INTERVAL_IDLE_MS   100   // Loop pacing once idle (see PowerManager)
+#define LOOP_INTERVAL_DEEP_IDLE_MS 250
+
+// Display animation frames (see updateDisplayAnimation)
+#define RESPONSE_SHAKE_FRAMES   6
+#define RESPONSE_REVEAL_FRAMES  3
+#define RESPONSE_FRAME_COUNT    (RESPONSE_SHAKE_FRAMES + RESPONSE_REVEAL_FRAMES + 1)
+#define WELCOME_FRAME_INTERVAL  100
+#define WELCOME_FRAME_INTERVAL_IDLE 500
+#define FRAME_BUDGET_US         12000 // Render + flush, within one LOOP_INTERVAL_MS
+#define FRAME_BUDGET_BYTES      512   // Half the screen; a full redraw is ~23ms at 400kHz
+
+// Shake sampling: MPU6050 FIFO at 1kHz / (1 + 19) = 50Hz with a 44Hz DLPF.
+// The 1KB FIFO holds 170 samples (3.4s), longer than any blocking animation.
+#define SHAKE_SAMPLE_RATE_DIV 19
+#define SHAKE_SAMPLE_RATE_HZ  50
+#define SHAKE_SAMPLE_PERIOD_MS (1000 / SHAKE_SAMPLE_RATE_HZ)
+#define SHAKE_FIFO_RESYNC_MS  200 // Sample clock drift tolerated before resyncing to millis()
+#define SHAKE_POLL_RATE_HZ    (1000 / LOOP_INTERVAL_MS) // Polling fallback: one sample per loop()
+#define SHAKE_DLPF_MODE       3
+#define SHAKE_FIFO_BATCH      32  // Samples drained per FIFO read
+#define SHAKE_SERVICE_INTERVAL 40000 // us between FIFO drains during display flushes
+#define SENSOR_ERROR_LOG_MS   5000 // At most one failed-read message per interval
+
+// Turning the ball over (face down, then face up) also asks a question; the
+// gyro and accelerometer are read in one burst per loop while it is handled
+#define ENABLE_FLIP_TRIGGER     true
+
+// Motion wake-up: the MPU6050 INT pin raises a GPIO interrupt on movement so
+// the sensor is only read while the device is actually being handled
+#define MPU_INT_PIN             D5    // GPIO14
+#define ENABLE_MOTION_WAKE      true
+#define MOTION_WAKE_THRESHOLD   40    // 1 LSB = 2mg -> 80mg
+#define MOTION_WAKE_DURATION    20    // ms of motion above threshold
+#define MOTION_ACTIVE_WINDOW    3000  // ms to keep sampling after the last wake
+#define MOTION_PIN_TEST_MS      50    // Startup check: wait this long for INT to rise
+
+// Deep idle turns the access point off until the device is moved; only
+// used when the motion interrupt is available to wake it
+#define POWER_AP_OFF_IN_DEEP_IDLE true
+
+// Answers queued while one is on screen are shown after this much of it
+#define RESPONSE_QUEUE_HOLD_MS  1500
+
+// /status reply, sized for a fully escaped answer
+#define STATUS_JSON_SIZE        320
+
+// DFPlayer Mini wiring. SoftwareSerial cannot receive on GPIO16 (no
+// pin-change interrupt), so with RX on D0 the module's replies are never
+// seen; commands are paced by time and the BUSY pin instead of ACKs. Moving
+// RX to an interrupt-capable pin such as D7 enables ACK pacing.
+#define DFPLAYER_RX_PIN         D0    // GPIO16, wired to the module's TX
+#define DFPLAYER_TX_PIN         D3    // GPIO0, wired to the module's RX
+#define DFPLAYER_BUSY_PIN       D6    // GPIO12, low while a track plays
+#define DFPLAYER_RX_WORKS       (DFPLAYER_RX_PIN != D0)
+
+// Boot: devices are brought up cooperatively (see serviceBoot) instead of
+// with blocking delays
+#define DFPLAYER_POWERUP_MS     3000 // From reset until the module takes commands
+#define WIFI_AP_SETTLE_MS       100
+
+struct BootTask {
+    const char* name;
+    bool (*step)(BootTask& task, unsigned long now); // True once the device is up
+    uint8_t state;
+    unsigned long resumeAt;     // millis() before which step() is not called
+    unsigned long activeMicros; // Time spent inside step()
+    bool done;
+};
+
 // Button pin for manual trigger (fallback)
 #define BUTTON_PIN D3   // GPIO0 - Built-in button on NodeMCU
 
 // Function declarations
 void handleShakeDetection();
+void sampleShakeSensor();
+void drainShakeFifo();
+bool processShakeSample(const AccelSample &sample, unsigned long sampleTime);
+void announceShake();
+bool processFlipSample(const MotionSample &sample);
+void reportSensorError();
+unsigned long nextFifoSampleTime(unsigned long now);
+bool motionWindowActive();
+void initializeMotionWake();
 void handleButtonPress();
-void showRandomResponse();
+void showRandomResponse(ResponseSource source);
+void queueResponse(uint16_t responseIndex, ResponseSource source);
+uint16_t responseCount();
+const char* lookupResponse(uint16_t index, char* buffer, size_t size);
+size_t escapeJson(const char* text, char* out, size_t size);
+size_t buildStatusJson(char* json, size_t size);
+void playQueuedResponse();
+void handleEvents();
+void handleMetrics();
+void handleFrame();
+void sendTraceStatus();
+void handleTrace();
+void handleTraceStart();
+void handleTraceStop();
+void handleTraceAuto();
+void handleTraceClear();
+void handleTraceDownload();
+void registerMetrics();
+void updateMetrics();
+void sendChunk(const char* text, size_t length);
 void initializeDisplay();
-void scanI2CForDisplay();
+void beginFrame();
+void flushDisplay();
 void displayText(const char* text, bool center = true);
 void displayMagic8BallResponse(const char* response);
+void buildResponseLayouts();
+void updateDisplayAnimation();
+bool isResponseAnimating();
+void recordLoopLatency(unsigned long elapsedMicros);
+void updatePowerState();
+void enterDeepIdle();
+void leaveDeepIdle();
+void startAccessPoint();
+uint16_t estimateCurrent();
+void waitForNextLoop();
 void displayWelcomeMessage();
 void displayAnimatedWelcome();
 void draw8Ball(int centerX, int centerY, int radius, int shakeOffset = 0);
-void initializeDFPlayer();
+void rasterize8Ball(int centerX, int centerY, int radius, int shakeOffset = 0);
+bool bootDFPlayer(BootTask& task, unsigned long now);
+bool bootDisplay(BootTask& task, unsigned long now);
+bool bootSensor(BootTask& task, unsigned long now);
+bool bootCatalog(BootTask& task, unsigned long now);
+bool bootTrace(BootTask& task, unsigned long now);
+void sendCatalogStatus();
+void handleCatalog();
+void handleCatalogUpload();
+void handleCatalogUploaded();
+void handleCatalogSelect();
+bool bootWiFi(BootTask& task, unsigned long now);
+void serviceBoot();
+void logBootStage(const char* name, unsigned long activeMicros);
+void initializeWebServer();
 void playRandomSound();
 
 // External variables (defined in main.cpp)
 extern const char* responses[];
 extern const int numResponses;
-extern float shakeThreshold;
-extern bool isShaking;
+extern GestureEngine gestureEngine;
+extern FlipDetector flipDetector;
+extern ResponseCatalog responseCatalog;
+extern TraceRecorder traceRecorder;
 extern bool responseShown;
 extern unsigned long lastShakeTime;
 extern unsigned long responseDisplayTime;
 extern const unsigned long responseDisplayDuration;
 extern unsigned long welcomeAnimationTime;
+extern unsigned long loopMaxMicros;
+extern bool motionWakeEnabled;
+extern bool shakePending;
+extern uint32_t motionWakeCount;
+extern uint32_t motionFalseTriggerCount;
 extern U8G2_SH1106_128X64_NONAME_F_HW_I2C display;
 
 #endif // MAGIC8BALL_H
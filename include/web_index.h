@@ -0,0 +1,102 @@
+// Generated by tools/embed_web.py from web/index.html - do not edit
+#ifndef WEB_INDEX_H
+#define WEB_INDEX_H
+
+#include <Arduino.h>
+
+// 3277 bytes of HTML, 1402 bytes gzipped
+#define WEB_INDEX_ETAG "\"167073d73cc5c667\""
+#define WEB_INDEX_GZ_LENGTH 1402
+
+static const uint8_t WEB_INDEX_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xa5, 0x57, 0x6d, 0x6f, 0xdb, 0x36,
+  0x10, 0xfe, 0xee, 0x5f, 0x71, 0x45, 0x11, 0x48, 0x02, 0x22, 0x45, 0x76, 0xaa, 0x34, 0xf3, 0x1b,
+  0xd6, 0x66, 0x1d, 0xb6, 0x21, 0x5d, 0xb7, 0x26, 0xc0, 0x96, 0x8f, 0xb4, 0x44, 0x59, 0x6c, 0x24,
+  0x51, 0x20, 0x29, 0x3b, 0x5e, 0xe1, 0xff, 0xbe, 0x3b, 0xea, 0xc5, 0xb2, 0x9b, 0x0c, 0x1b, 0x96,
+  0x20, 0x86, 0x44, 0x1e, 0x9f, 0xbb, 0x7b, 0xee, 0xb9, 0xa3, 0x33, 0x7f, 0xf5, 0xc3, 0xa7, 0x9b,
+  0xfb, 0x87, 0xdf, 0x3e, 0x40, 0x66, 0x8a, 0x7c, 0x39, 0x6f, 0x3f, 0x39, 0x4b, 0x96, 0xa3, 0xb9,
+  0x11, 0x26, 0xe7, 0xcb, 0x8f, 0x6c, 0x2d, 0x62, 0xb8, 0xf6, 0xdf, 0xb3, 0x3c, 0x87, 0x3f, 0xc4,
+  0x8f, 0x62, 0x7e, 0xd1, 0x6c, 0x8c, 0xe6, 0x05, 0x37, 0x0c, 0x4a, 0x56, 0xf0, 0x85, 0xb3, 0x11,
+  0x7c, 0x5b, 0x49, 0x65, 0x1c, 0x88, 0x65, 0x69, 0x78, 0x69, 0x16, 0xce, 0x56, 0x24, 0x26, 0x5b,
+  0x24, 0x7c, 0x23, 0x62, 0xee, 0xdb, 0x97, 0x73, 0x10, 0xa5, 0x30, 0x82, 0xe5, 0xbe, 0x8e, 0x59,
+  0xce, 0x17, 0x63, 0x07, 0x41, 0xb4, 0xd9, 0x11, 0xd8, 0x4a, 0x26, 0x3b, 0xf8, 0x0a, 0x29, 0x9e,
+  0xf6, 0x53, 0x56, 0x88, 0x7c, 0x37, 0x85, 0x77, 0x0a, 0x6d, 0xcf, 0x41, 0xb3, 0x52, 0xfb, 0x9a,
+  0x2b, 0x91, 0xce, 0xc0, 0xf0, 0x27, 0xe3, 0xb3, 0x5c, 0xac, 0xcb, 0x29, 0xc4, 0xe8, 0x86, 0xab,
+  0x19, 0xac, 0x58, 0xfc, 0xb8, 0x56, 0xb2, 0x2e, 0x93, 0x29, 0xe4, 0xa2, 0xe4, 0x4c, 0xf9, 0x6b,
+  0xc5, 0x12, 0x81, 0xdb, 0xee, 0xf8, 0x32, 0x4a, 0xf8, 0xfa, 0x1c, 0x5e, 0x5f, 0x5d, 0xbd, 0xe5,
+  0x9c, 0x41, 0x78, 0x86, 0xcf, 0x6f, 0xaf, 0xde, 0xac, 0xd8, 0x04, 0xc6, 0x61, 0x78, 0xe6, 0xcd,
+  0x30, 0xe0, 0x5c, 0xaa, 0x29, 0x6c, 0x33, 0x61, 0xf8, 0x0c, 0x0a, 0xa6, 0xd6, 0x02, 0xc1, 0xc3,
+  0x19, 0x54, 0x2c, 0x49, 0x44, 0xb9, 0x9e, 0xc2, 0x24, 0xac, 0x9e, 0x66, 0xb0, 0x1f, 0x05, 0x94,
+  0x1b, 0x43, 0x0f, 0x0a, 0x23, 0x2d, 0xd8, 0x53, 0x93, 0xd5, 0x14, 0xa2, 0xd0, 0x1a, 0xf4, 0x47,
+  0x81, 0xd5, 0x46, 0x1e, 0xc7, 0xa5, 0xd6, 0x2b, 0xe6, 0x4e, 0xa2, 0xe8, 0xbc, 0xfb, 0x0b, 0x83,
+  0xb1, 0x37, 0x70, 0x71, 0x69, 0x11, 0x56, 0x52, 0x25, 0x5c, 0xf9, 0x14, 0x7c, 0xad, 0x3b, 0xbf,
+  0x2b, 0xf9, 0xe4, 0xeb, 0x8c, 0x25, 0x72, 0x4b, 0xd0, 0xd7, 0xd5, 0x13, 0x5c, 0x4e, 0xf0, 0xc3,
+  0x22, 0x86, 0xe7, 0xf6, 0x37, 0xb8, 0xf4, 0x28, 0xbe, 0x6c, 0xdc, 0x31, 0xa8, 0xc5, 0x5f, 0x1c,
+  0xcf, 0x07, 0x11, 0x2f, 0xba, 0xb8, 0xfc, 0x95, 0x34, 0x46, 0x16, 0x1d, 0xaa, 0x25, 0xb2, 0x83,
+  0x25, 0x3c, 0xfa, 0x7b, 0x73, 0x8a, 0x1b, 0x59, 0xdc, 0x60, 0x45, 0xb5, 0xff, 0x0a, 0x6d, 0xba,
+  0xe3, 0x06, 0x21, 0xe3, 0x62, 0x9d, 0x99, 0xfe, 0x75, 0x98, 0xed, 0xeb, 0x30, 0x0c, 0xbf, 0xc9,
+  0x26, 0x0a, 0xcf, 0x0e, 0x1c, 0xd1, 0x99, 0x96, 0xa6, 0x4a, 0x6a, 0x14, 0x85, 0xc4, 0x45, 0xc5,
+  0x73, 0x66, 0xc4, 0x86, 0x9f, 0xe6, 0x1c, 0x36, 0xe6, 0x2f, 0x45, 0x36, 0x9d, 0xb2, 0xd4, 0xd8,
+  0x9a, 0xb4, 0xda, 0x9b, 0x82, 0x73, 0xed, 0x0c, 0x81, 0xd9, 0x4a, 0xcb, 0xbc, 0xa6, 0xf2, 0x1a,
+  0x59, 0xa1, 0xf3, 0x88, 0x02, 0xce, 0x79, 0x6a, 0xda, 0xa8, 0x8c, 0x42, 0x89, 0xa5, 0x52, 0x21,
+  0x3b, 0xf6, 0x11, 0xc3, 0xe0, 0x7f, 0xba, 0x7e, 0xf4, 0x8c, 0x3e, 0x86, 0xf4, 0xbe, 0x21, 0x18,
+  0xbb, 0xb0, 0x6d, 0xb9, 0x58, 0xc9, 0x3c, 0xa1, 0xb8, 0x56, 0x35, 0x72, 0x5d, 0x62, 0x44, 0x47,
+  0xac, 0xa4, 0xe9, 0xd5, 0xea, 0x6a, 0x75, 0x8a, 0xd8, 0xd0, 0x34, 0x85, 0x52, 0x96, 0x7c, 0xa0,
+  0x88, 0x71, 0x44, 0x95, 0x0e, 0x7b, 0x17, 0x8d, 0xcf, 0xf1, 0xf5, 0x33, 0x3a, 0x89, 0xac, 0x55,
+  0x5c, 0x2b, 0x4d, 0xb0, 0x95, 0x14, 0x4d, 0x5f, 0x74, 0x5c, 0x8f, 0x9b, 0x82, 0x53, 0x62, 0x1d,
+  0x1f, 0x58, 0x4e, 0x14, 0x8d, 0x3e, 0x84, 0x3a, 0xcd, 0xe4, 0xc6, 0x52, 0x78, 0x12, 0x70, 0x34,
+  0x89, 0x26, 0xcf, 0xf3, 0xf3, 0xe0, 0xfa, 0x28, 0x19, 0xef, 0xb4, 0x56, 0x24, 0xa1, 0xeb, 0xd3,
+  0x62, 0x4d, 0x9a, 0x62, 0x29, 0xae, 0x2b, 0x59, 0x6a, 0x7e, 0xe2, 0xe6, 0x99, 0xde, 0x98, 0x78,
+  0xdf, 0xb4, 0xdf, 0x49, 0xce, 0xe3, 0x68, 0xd8, 0x72, 0x56, 0x1f, 0x28, 0xb9, 0x02, 0x75, 0xde,
+  0xe9, 0xf2, 0xca, 0x1e, 0x4b, 0x84, 0xae, 0x72, 0x86, 0xc3, 0x24, 0xcd, 0x39, 0xbe, 0xda, 0xd1,
+  0xe1, 0x23, 0xef, 0x85, 0x3e, 0x0c, 0x90, 0x2f, 0xb5, 0x36, 0x22, 0xdd, 0xf9, 0xbd, 0x7c, 0xba,
+  0x8d, 0x61, 0xcc, 0xd9, 0xc4, 0x36, 0x7d, 0x3f, 0x1d, 0x86, 0x45, 0x69, 0xfa, 0x0c, 0xad, 0x45,
+  0x99, 0xca, 0xe3, 0x1e, 0x0c, 0x83, 0xef, 0x68, 0x4f, 0x56, 0x2c, 0x16, 0x66, 0x47, 0xef, 0xd7,
+  0x7d, 0x47, 0x36, 0x62, 0x6c, 0x87, 0xcb, 0xf7, 0x8f, 0x7c, 0x97, 0x2a, 0x1c, 0xa6, 0x1a, 0x90,
+  0xcd, 0x47, 0x22, 0x89, 0x86, 0x15, 0x0d, 0x29, 0x7c, 0x7c, 0x5e, 0xa1, 0x21, 0xf1, 0x8a, 0x72,
+  0x7e, 0xd9, 0xc2, 0x8f, 0x6c, 0x8d, 0xf6, 0xf0, 0xf6, 0x1f, 0x8c, 0x3a, 0x1b, 0x4c, 0x80, 0x5c,
+  0x23, 0xe9, 0x68, 0xca, 0x4a, 0x51, 0xb0, 0x46, 0x2e, 0x4d, 0x3c, 0xd8, 0x73, 0x1a, 0x38, 0xd3,
+  0xdc, 0xc7, 0xd0, 0x65, 0x6d, 0x28, 0xe8, 0xf9, 0x45, 0x33, 0xbe, 0xe7, 0x17, 0xf6, 0xce, 0x98,
+  0xd3, 0x14, 0xc7, 0x99, 0x9e, 0x88, 0x0d, 0xc4, 0x39, 0xd3, 0x7a, 0xe1, 0xf4, 0x23, 0x93, 0x66,
+  0x7d, 0x36, 0x5e, 0xde, 0xdd, 0x7f, 0x86, 0xe1, 0x95, 0x82, 0x27, 0xc7, 0xc7, 0x27, 0xa8, 0xa5,
+  0x1d, 0x10, 0x49, 0xfb, 0x84, 0xd8, 0xb8, 0x89, 0x26, 0x6d, 0x4f, 0xc9, 0x32, 0xce, 0x45, 0xfc,
+  0xb8, 0x70, 0x98, 0x7e, 0xfc, 0xbd, 0xe6, 0x9a, 0x42, 0x74, 0x3d, 0x67, 0xf9, 0x4e, 0x3f, 0x82,
+  0xc9, 0xf8, 0x11, 0xf8, 0xab, 0xf9, 0x45, 0x73, 0xea, 0xd8, 0x43, 0x57, 0xd3, 0xc6, 0x4b, 0xff,
+  0xb6, 0x9c, 0x57, 0xcb, 0x1b, 0xc2, 0xb6, 0x38, 0xad, 0x3b, 0x23, 0x61, 0xcd, 0x0d, 0x30, 0xe8,
+  0xcc, 0x10, 0xb3, 0xea, 0x63, 0x1a, 0x80, 0x52, 0xe9, 0x29, 0xc7, 0x6a, 0xf9, 0x20, 0x6b, 0x88,
+  0x59, 0x89, 0x5a, 0xd3, 0xb2, 0xe5, 0x8e, 0x00, 0xab, 0x6c, 0xa7, 0x05, 0xde, 0x7b, 0xd0, 0x5c,
+  0x89, 0x16, 0x87, 0xcc, 0x6f, 0x64, 0x59, 0xf2, 0xd8, 0xf0, 0x04, 0x91, 0xe8, 0xce, 0x42, 0x61,
+  0xce, 0x75, 0x85, 0xe7, 0x29, 0xb8, 0x76, 0xc9, 0x59, 0xfa, 0x48, 0x35, 0x2e, 0x2e, 0xdb, 0x53,
+  0x76, 0x33, 0xc7, 0x59, 0xe9, 0xb4, 0x2b, 0x36, 0xa0, 0x2e, 0x2c, 0x1d, 0x2b, 0x51, 0x99, 0xe5,
+  0x28, 0xad, 0xcb, 0x98, 0xf8, 0xc1, 0x28, 0xe4, 0xf6, 0x73, 0x9b, 0x80, 0x4b, 0xa3, 0xdf, 0x83,
+  0xaf, 0x23, 0x80, 0x0d, 0x53, 0x90, 0xc1, 0x02, 0x12, 0x19, 0xd7, 0x05, 0xfa, 0x09, 0x62, 0xc5,
+  0x51, 0x11, 0x1f, 0x72, 0x4e, 0x6f, 0xae, 0x93, 0x4d, 0x1c, 0x6f, 0x86, 0x76, 0x59, 0x40, 0x67,
+  0x6e, 0x9a, 0xf6, 0x40, 0x7b, 0x7a, 0x9b, 0xb5, 0xe7, 0xb1, 0xfd, 0x87, 0x08, 0x48, 0x56, 0x7b,
+  0xfc, 0xfd, 0xee, 0xe7, 0xc4, 0x3d, 0xb0, 0x6b, 0x81, 0xd0, 0x18, 0x7b, 0x04, 0xd5, 0xf0, 0xd3,
+  0xfd, 0xc7, 0x5b, 0x3c, 0xe6, 0x38, 0xdd, 0x2a, 0xab, 0x2a, 0x5e, 0x26, 0x37, 0x99, 0xc8, 0x13,
+  0x37, 0x43, 0xdb, 0xfd, 0x21, 0xf8, 0x5c, 0xb2, 0xe4, 0xce, 0x30, 0x53, 0x6b, 0xb7, 0x09, 0x3b,
+  0xe5, 0x26, 0xce, 0x5c, 0x07, 0xb5, 0x47, 0x8b, 0x8e, 0x17, 0x20, 0xbd, 0xa5, 0xab, 0x60, 0xb1,
+  0x04, 0x15, 0x7c, 0xd1, 0xa4, 0x87, 0x76, 0x4d, 0xd3, 0x1a, 0x1d, 0x01, 0x10, 0x29, 0xb8, 0xba,
+  0x6f, 0x67, 0xef, 0x98, 0x92, 0xc1, 0xc6, 0xcc, 0x5a, 0xbf, 0x98, 0x4f, 0x57, 0x10, 0xef, 0x84,
+  0x12, 0x1d, 0xb4, 0x3b, 0x74, 0x7e, 0x6f, 0x13, 0x20, 0x76, 0x50, 0xa4, 0xd4, 0x4e, 0x0b, 0x48,
+  0x51, 0x0d, 0x7c, 0x76, 0x48, 0xea, 0x48, 0xbd, 0x36, 0xc4, 0xde, 0xd4, 0xa8, 0x9a, 0x13, 0xca,
+  0x8b, 0x31, 0xd8, 0xbe, 0xf0, 0x02, 0x2b, 0xbc, 0x5b, 0xa1, 0x4d, 0x80, 0x93, 0xd2, 0x75, 0xda,
+  0xd6, 0x6d, 0x88, 0xfe, 0x17, 0xf5, 0x38, 0x2e, 0x04, 0x0a, 0xf1, 0x3e, 0x13, 0x25, 0x21, 0x04,
+  0x41, 0x40, 0x9a, 0xb2, 0xa5, 0xe9, 0xa8, 0xc6, 0xe0, 0x7a, 0x9e, 0xbb, 0x89, 0x48, 0x74, 0xb7,
+  0xcf, 0x96, 0x8c, 0x9e, 0xf5, 0x84, 0xe1, 0xf7, 0xc2, 0x9e, 0x78, 0xcd, 0xcd, 0xbd, 0x28, 0x38,
+  0x4e, 0x0c, 0x17, 0x33, 0xed, 0x97, 0xe1, 0xb8, 0x02, 0x74, 0xa6, 0xe5, 0xfe, 0xbf, 0x64, 0xae,
+  0x78, 0x81, 0x17, 0xd7, 0x49, 0xf2, 0xf4, 0x73, 0x4a, 0x3c, 0xad, 0xed, 0xed, 0x38, 0x0d, 0xbd,
+  0x43, 0x89, 0x0e, 0x1a, 0x43, 0x30, 0xde, 0x55, 0x82, 0x0a, 0xc7, 0x37, 0x54, 0x4c, 0x3c, 0x5f,
+  0xf2, 0x2d, 0x7c, 0xa0, 0x97, 0x3b, 0x59, 0xab, 0x18, 0x5d, 0x5d, 0x34, 0x5b, 0x8d, 0xab, 0xe6,
+  0x99, 0x0a, 0x60, 0x6d, 0x6e, 0x2d, 0x0c, 0x57, 0xae, 0x83, 0xc3, 0x75, 0x8b, 0x43, 0xef, 0x1c,
+  0x3a, 0x17, 0x2e, 0xf7, 0xda, 0xcc, 0xad, 0x2e, 0x10, 0xf9, 0x97, 0xbb, 0x4f, 0xbf, 0x06, 0x15,
+  0x53, 0x98, 0x3d, 0x0f, 0x06, 0xf9, 0x93, 0x52, 0x5f, 0x35, 0xf1, 0x9f, 0xc8, 0x94, 0x1d, 0xcb,
+  0x74, 0x3f, 0x0c, 0x41, 0x96, 0x12, 0x3b, 0x88, 0x12, 0xee, 0x1c, 0xa2, 0xbf, 0x97, 0x99, 0xb4,
+  0xb3, 0xe3, 0x54, 0xc4, 0xce, 0x2d, 0xae, 0xb6, 0xf3, 0x5e, 0x03, 0xb5, 0x24, 0x0d, 0x08, 0xae,
+  0x38, 0x7e, 0x9b, 0xda, 0x1f, 0xf9, 0xe2, 0x4a, 0x49, 0xf5, 0x3f, 0x9d, 0x35, 0xa0, 0xfb, 0xd1,
+  0xb0, 0xbf, 0x67, 0x23, 0xca, 0x7e, 0x2b, 0x4a, 0xfc, 0x3a, 0x11, 0x0c, 0x68, 0xf7, 0xfa, 0x0a,
+  0xcd, 0xe8, 0xd2, 0x69, 0xe6, 0x1b, 0x4e, 0x77, 0xba, 0x6f, 0xf0, 0x0a, 0xa1, 0x7f, 0x5b, 0x46,
+  0x7f, 0x03, 0x4a, 0x1b, 0xd0, 0x79, 0xcd, 0x0c, 0x00, 0x00,
+};
+
+#endif // WEB_INDEX_H
@@ -0,0 +1,65 @@
+#include "AnimationTimeline.h"
+
+AnimationTimeline::AnimationTimeline() {
+    durations = 0;
+    count = 0;
+    frame = 0;
+    looping = false;
+    running = false;
+    pending = false;
+    frameStart = 0;
+}
+
+void AnimationTimeline::start(const uint16_t *frameDurations, uint8_t frameCount, unsigned long now, bool loop) {
+    durations = frameDurations;
+    count = frameCount;
+    frame = 0;
+    looping = loop;
+    running = frameCount > 0;
+    pending = running;
+    frameStart = now;
+}
+
+void AnimationTimeline::stop() {
+    running = false;
+    pending = false;
+}
+
+int AnimationTimeline::update(unsigned long now) {
+    if (!running) {
+        return ANIMATION_NO_FRAME;
+    }
+    
+    // Advance past every frame whose time is up, keeping the schedule anchored
+    // to when each frame was due rather than when it was drawn
+    while (now - frameStart >= durations[frame]) {
+        if (frame + 1 >= count) {
+            if (!looping) {
+                break;
+            }
+            frameStart += durations[frame];
+            frame = 0;
+        } else {
+            frameStart += durations[frame];
+            frame++;
+        }
+        pending = true;
+        
+        // A zero-length looping timeline would spin forever
+        if (durations[frame] == 0 && looping) {
+            frameStart = now;
+            break;
+        }
+    }
+    
+    if (!pending) {
+        return ANIMATION_NO_FRAME;
+    }
+    pending = false;
+    
+    // A one-shot timeline ends once its last frame has been handed out
+    if (!looping && frame + 1 >= count) {
+        running = false;
+    }
+    return frame;
+}
@@ -0,0 +1,251 @@
+#include "DFPlayerQueue.h"
+
+DFPlayerQueue::DFPlayerQueue() {
+    head = 0;
+    count = 0;
+    serial = 0;
+    retries = 0;
+    retryPending = false;
+    awaitingAck = false;
+    sentAt = 0;
+    nextSendAt = 0;
+    missedAcks = 0;
+    ackSupported = true;
+    receives = true;
+    busyPin = DFPLAYER_NO_BUSY_PIN;
+    awaitingBusy = false;
+    busyExpected = false;
+    frameLength = 0;
+    playing = false;
+    lastError = 0;
+    commandsSent = 0;
+    acks = 0;
+    timeouts = 0;
+    errors = 0;
+    tracksFinished = 0;
+    replaced = 0;
+    dropped = 0;
+}
+
+void DFPlayerQueue::begin(Stream &serial, bool receives, int8_t busyPin) {
+    this->serial = &serial;
+    this->receives = receives;
+    this->busyPin = busyPin;
+    // Nothing could come back, so never ask for or wait on an ACK
+    ackSupported = receives;
+    if (busyPin != DFPLAYER_NO_BUSY_PIN) {
+        pinMode(busyPin, INPUT_PULLUP); // Reads as idle if not connected
+    }
+}
+
+bool DFPlayerQueue::send(uint8_t command, uint16_t param) {
+    if (count == DFPLAYER_QUEUE_SIZE) {
+        dropped++;
+        return false;
+    }
+    
+    Command &slot = queue[(head + count) % DFPLAYER_QUEUE_SIZE];
+    slot.command = command;
+    slot.param = param;
+    count++;
+    return true;
+}
+
+void DFPlayerQueue::play(uint16_t track) {
+    for (uint8_t i = 0; i < count; i++) {
+        Command &queued = queue[(head + i) % DFPLAYER_QUEUE_SIZE];
+        if (queued.command == DFPLAYER_CMD_PLAY_TRACK) {
+            // Not sent yet: just change which track it plays
+            queued.param = track;
+            replaced++;
+            removeQueued(DFPLAYER_CMD_STOP);
+            return;
+        }
+    }
+    
+    removeQueued(DFPLAYER_CMD_STOP);
+    send(DFPLAYER_CMD_PLAY_TRACK, track);
+}
+
+void DFPlayerQueue::stop() {
+    removeQueued(DFPLAYER_CMD_PLAY_TRACK);
+    send(DFPLAYER_CMD_STOP);
+}
+
+void DFPlayerQueue::removeQueued(uint8_t command) {
+    // Compact the ring in place, keeping the order of the rest
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        Command queued = queue[(head + i) % DFPLAYER_QUEUE_SIZE];
+        if (queued.command != command) {
+            queue[(head + kept) % DFPLAYER_QUEUE_SIZE] = queued;
+            kept++;
+        }
+    }
+    count = kept;
+}
+
+void DFPlayerQueue::service() {
+    if (!serial) {
+        return;
+    }
+    
+    while (receives && serial->available() > 0) {
+        receive(serial->read());
+    }
+    
+    unsigned long now = millis();
+    if (awaitingAck && now - sentAt >= DFPLAYER_ACK_TIMEOUT) {
+        awaitingAck = false;
+        timeouts++;
+        if (++missedAcks >= DFPLAYER_MAX_MISSED_ACKS && acks == 0) {
+            // Nothing has ever come back; pace by time (and BUSY) from now on
+            ackSupported = false;
+        }
+    }
+    
+    // Status messages report track ends when replies work; otherwise BUSY does
+    if (!ackSupported && busyPin != DFPLAYER_NO_BUSY_PIN) {
+        serviceBusy(now);
+    }
+    
+    if (awaitingAck || awaitingBusy || (long)(now - nextSendAt) < 0) {
+        return;
+    }
+    
+    if (retryPending) {
+        retryPending = false;
+        transmit(inFlight);
+        return;
+    }
+    if (count == 0) {
+        return;
+    }
+    
+    inFlight = queue[head];
+    head = (head + 1) % DFPLAYER_QUEUE_SIZE;
+    count--;
+    retries = 0;
+    transmit(inFlight);
+}
+
+void DFPlayerQueue::transmit(const Command &command) {
+    uint8_t out[DFPLAYER_FRAME_LENGTH] = {
+        0x7E, 0xFF, 0x06, command.command, (uint8_t)(ackSupported ? 1 : 0),
+        (uint8_t)(command.param >> 8), (uint8_t)command.param, 0, 0, 0xEF
+    };
+    uint16_t sum = checksum(out);
+    out[7] = sum >> 8;
+    out[8] = sum & 0xFF;
+    serial->write(out, sizeof(out));
+    
+    commandsSent++;
+    sentAt = millis();
+    bool startsTrack = command.command == DFPLAYER_CMD_PLAY_TRACK;
+    bool endsTrack = command.command == DFPLAYER_CMD_STOP || command.command == DFPLAYER_CMD_SLEEP;
+    if (ackSupported) {
+        awaitingAck = true;
+    } else {
+        nextSendAt = sentAt + DFPLAYER_NO_ACK_GAP;
+        // Opening a file from the card can take longer than the gap
+        if (busyPin != DFPLAYER_NO_BUSY_PIN && (startsTrack || endsTrack)) {
+            awaitingBusy = true;
+            busyExpected = startsTrack;
+        }
+    }
+    
+    if (startsTrack) {
+        playing = true;
+    } else if (endsTrack) {
+        playing = false;
+    }
+}
+
+void DFPlayerQueue::serviceBusy(unsigned long now) {
+    bool busy = digitalRead(busyPin) == LOW;
+    if (awaitingBusy) {
+        if (busy == busyExpected) {
+            awaitingBusy = false;
+        } else if (now - sentAt >= DFPLAYER_BUSY_TIMEOUT) {
+            // The module did not act on it (missing file, no card, asleep)
+            awaitingBusy = false;
+            timeouts++;
+            playing = busy;
+        }
+        return;
+    }
+    
+    if (playing && !busy) {
+        tracksFinished++;
+        playing = false;
+    }
+}
+
+void DFPlayerQueue::receive(uint8_t byte) {
+    // Resynchronise on the start byte
+    if (frameLength == 0 && byte != 0x7E) {
+        return;
+    }
+    frame[frameLength++] = byte;
+    if (frameLength < DFPLAYER_FRAME_LENGTH) {
+        return;
+    }
+    frameLength = 0;
+    
+    uint16_t sum = ((uint16_t)frame[7] << 8) | frame[8];
+    if (frame[1] != 0xFF || frame[2] != 0x06 || frame[9] != 0xEF || sum != checksum(frame)) {
+        errors++;
+        return;
+    }
+    handleMessage(frame[3], ((uint16_t)frame[5] << 8) | frame[6]);
+}
+
+void DFPlayerQueue::handleMessage(uint8_t command, uint16_t param) {
+    switch (command) {
+        case DFPLAYER_MSG_ACK:
+            acks++;
+            missedAcks = 0;
+            awaitingAck = false;
+            break;
+            
+        case DFPLAYER_MSG_ERROR:
+            errors++;
+            lastError = param & 0xFF;
+            // The error replaces the ACK for the command in flight
+            if (awaitingAck) {
+                awaitingAck = false;
+                if (lastError == DFPLAYER_ERROR_BUSY && retries < DFPLAYER_MAX_RETRIES) {
+                    // Still starting up or reading the card: try again shortly
+                    retries++;
+                    retryPending = true;
+                    nextSendAt = millis() + DFPLAYER_BUSY_RETRY;
+                } else if (inFlight.command == DFPLAYER_CMD_PLAY_TRACK) {
+                    playing = false;
+                }
+            }
+            break;
+            
+        case DFPLAYER_MSG_SD_FINISHED:
+        case DFPLAYER_MSG_USB_FINISHED:
+            tracksFinished++;
+            playing = false;
+            break;
+            
+        case DFPLAYER_MSG_CARD_REMOVED:
+            playing = false;
+            break;
+            
+        default:
+            // Card inserted, online and query replies carry nothing we need
+            break;
+    }
+}
+
+uint16_t DFPlayerQueue::checksum(const uint8_t *frame) {
+    // Two's complement of the sum of version .. parameter bytes
+    uint16_t sum = 0;
+    for (uint8_t i = 1; i < 7; i++) {
+        sum += frame[i];
+    }
+    return -sum;
+}
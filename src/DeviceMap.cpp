@@ -0,0 +1,102 @@
+#include "DeviceMap.h"
+#include "I2CBus.h"
+
+DeviceMap deviceMap;
+
+DeviceMap::DeviceMap() {
+    memset(present, 0, sizeof(present));
+    cached = false;
+}
+
+void DeviceMap::scan() {
+    memset(present, 0, sizeof(present));
+    for (uint8_t address = 1; address < 127; address++) {
+        if (i2cBus.probe(address)) {
+            present[address >> 5] |= 1UL << (address & 31);
+        }
+    }
+    cached = false;
+}
+
+bool DeviceMap::loadFromRtc() {
+    rst_info *reset = ESP.getResetInfoPtr();
+    if (reset && reset->reason == REASON_DEFAULT_RST) {
+        return false;
+    }
+    
+    Stored stored;
+    if (!ESP.rtcUserMemoryRead(DEVICE_MAP_RTC_BLOCK, (uint32_t*)&stored, sizeof(stored))) {
+        return false;
+    }
+    if (stored.magic != DEVICE_MAP_MAGIC ||
+        stored.crc != crc32((const uint8_t*)&stored, offsetof(Stored, crc))) {
+        return false;
+    }
+    
+    memcpy(present, stored.present, sizeof(present));
+    cached = true;
+    return true;
+}
+
+void DeviceMap::saveToRtc() {
+    Stored stored;
+    stored.magic = DEVICE_MAP_MAGIC;
+    memcpy(stored.present, present, sizeof(present));
+    stored.crc = crc32((const uint8_t*)&stored, offsetof(Stored, crc));
+    ESP.rtcUserMemoryWrite(DEVICE_MAP_RTC_BLOCK, (uint32_t*)&stored, sizeof(stored));
+}
+
+void DeviceMap::invalidateRtc() {
+    uint32_t zero = 0;
+    ESP.rtcUserMemoryWrite(DEVICE_MAP_RTC_BLOCK, &zero, sizeof(zero));
+}
+
+bool DeviceMap::has(uint8_t address) const {
+    return address < 128 && (present[address >> 5] & (1UL << (address & 31)));
+}
+
+uint8_t DeviceMap::getCount() const {
+    uint8_t count = 0;
+    for (uint8_t address = 1; address < 127; address++) {
+        if (has(address)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void DeviceMap::print() const {
+    Serial.print(cached ? "I2C devices (cached): " : "I2C devices (scanned): ");
+    if (getCount() == 0) {
+        Serial.println("none found!");
+        return;
+    }
+    
+    for (uint8_t address = 1; address < 127; address++) {
+        if (!has(address)) {
+            continue;
+        }
+        Serial.print("0x");
+        if (address < 16) Serial.print("0");
+        Serial.print(address, HEX);
+        switch (address) {
+            case 0x3C: Serial.print(" (SH1106)"); break;
+            case 0x3D: Serial.print(" (SH1106 alt)"); break;
+            case 0x68: Serial.print(" (MPU6050)"); break;
+            case 0x69: Serial.print(" (MPU6050 alt)"); break;
+        }
+        Serial.print(" ");
+    }
+    Serial.println();
+}
+
+uint32_t DeviceMap::crc32(const uint8_t *data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    while (length--) {
+        crc ^= *data++;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
@@ -0,0 +1,119 @@
+#include "DisplayFlush.h"
+
+TileFlusher::TileFlusher(U8G2 &display) : display(display) {
+    shadowValid = false;
+    busClient = I2C_NO_CLIENT;
+    resetStats();
+}
+
+void TileFlusher::invalidate() {
+    shadowValid = false;
+}
+
+void TileFlusher::resetStats() {
+    lastFlushBytes = 0;
+    totalBytes = 0;
+    flushCount = 0;
+    skippedCount = 0;
+}
+
+uint16_t TileFlusher::flush() {
+    const uint8_t *buffer = display.getBufferPtr();
+    uint16_t bytes = 0;
+    
+    for (uint8_t row = 0; row < DISPLAY_TILE_ROWS; row++) {
+        const uint8_t *page = buffer + row * DISPLAY_TILE_COLS * DISPLAY_TILE_BYTES;
+        uint8_t *shadowPage = shadow + row * DISPLAY_TILE_COLS * DISPLAY_TILE_BYTES;
+        
+        // Collect runs of dirty tiles; a single clean tile between two dirty
+        // ones is cheaper to resend than to start another transfer for
+        int runStart = -1;
+        int lastDirty = -1;
+        for (uint8_t col = 0; col < DISPLAY_TILE_COLS; col++) {
+            uint16_t offset = col * DISPLAY_TILE_BYTES;
+            bool dirty = !shadowValid ||
+                         memcmp(page + offset, shadowPage + offset, DISPLAY_TILE_BYTES) != 0;
+            if (!dirty) {
+                continue;
+            }
+            
+            if (runStart >= 0 && col - lastDirty > 2) {
+                sendRun(row, runStart, lastDirty - runStart + 1);
+                bytes += (lastDirty - runStart + 1) * DISPLAY_TILE_BYTES;
+                runStart = -1;
+            }
+            if (runStart < 0) {
+                runStart = col;
+            }
+            lastDirty = col;
+        }
+        
+        if (runStart >= 0) {
+            sendRun(row, runStart, lastDirty - runStart + 1);
+            bytes += (lastDirty - runStart + 1) * DISPLAY_TILE_BYTES;
+            memcpy(shadowPage, page, DISPLAY_TILE_COLS * DISPLAY_TILE_BYTES);
+        }
+    }
+    
+    shadowValid = true;
+    lastFlushBytes = bytes;
+    totalBytes += bytes;
+    if (bytes == 0) {
+        skippedCount++;
+    } else {
+        flushCount++;
+    }
+    return bytes;
+}
+
+void TileFlusher::sendRun(uint8_t tileRow, uint8_t firstTile, uint8_t tileCount) {
+    // Let a due sensor read go first rather than wait out the whole frame
+    i2cBus.serviceClients();
+    
+    i2cBus.beginExternal(busClient);
+    display.updateDisplayArea(firstTile, tileRow, tileCount, 1);
+    i2cBus.endExternal(busClient, true);
+}
+
+bool TileFlusher::exportPbm(void (*emit)(const char *text, size_t length)) const {
+    if (!shadowValid) {
+        return false;
+    }
+    writePbm(shadow, emit);
+    return true;
+}
+
+void TileFlusher::exportBufferPbm(void (*emit)(const char *text, size_t length)) {
+    writePbm(display.getBufferPtr(), emit);
+}
+
+void TileFlusher::restoreBuffer() {
+    // Every frame starts with clearBuffer(), so without a shadow there is
+    // nothing on screen worth keeping
+    if (shadowValid) {
+        memcpy(display.getBufferPtr(), shadow, DISPLAY_BUFFER_SIZE);
+    } else {
+        display.clearBuffer();
+    }
+}
+
+void TileFlusher::writePbm(const uint8_t *frame, void (*emit)(const char *text, size_t length)) {
+    static const char header[] = "P4\n128 64\n";
+    emit(header, sizeof(header) - 1);
+    
+    // The frame is in pages of vertical bytes (bit 0 at the top); PBM wants
+    // rows of horizontal bits, most significant first, 1 = black (lit pixel)
+    const uint16_t width = DISPLAY_TILE_COLS * DISPLAY_TILE_BYTES;
+    char row[width / 8];
+    for (uint8_t y = 0; y < DISPLAY_TILE_ROWS * 8; y++) {
+        const uint8_t *page = frame + (y / 8) * width;
+        uint8_t mask = 1 << (y % 8);
+        memset(row, 0, sizeof(row));
+        for (uint16_t x = 0; x < width; x++) {
+            if (page[x] & mask) {
+                row[x / 8] |= 0x80 >> (x % 8);
+            }
+        }
+        emit(row, sizeof(row));
+    }
+}
@@ -0,0 +1,169 @@
+#include "EventStream.h"
+
+// Raw response head; the stream has no length and stays open
+static const char EVENT_STREAM_HEADER[] PROGMEM =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n";
+
+EventStream::EventStream() {
+    for (int i = 0; i < EVENT_MAX_CLIENTS; i++) {
+        subscribers[i].active = false;
+        subscribers[i].accel = false;
+        subscribers[i].pending = 0;
+    }
+    lastAccelEvent = 0;
+    lastKeepAlive = 0;
+    eventCount = 0;
+    droppedClients = 0;
+    rejected = 0;
+    droppedEvents = 0;
+}
+
+bool EventStream::subscribe(WiFiClient &client, bool wantsAccel) {
+    for (int i = 0; i < EVENT_MAX_CLIENTS; i++) {
+        Subscriber &subscriber = subscribers[i];
+        if (subscriber.active) {
+            continue;
+        }
+        
+        subscriber.client = client;
+        subscriber.client.setNoDelay(true);
+        subscriber.active = true;
+        subscriber.accel = wantsAccel;
+        subscriber.pending = 0;
+        
+        char header[sizeof(EVENT_STREAM_HEADER)];
+        strcpy_P(header, EVENT_STREAM_HEADER);
+        enqueue(subscriber, header, strlen(header));
+        
+        char retry[16];
+        int length = snprintf(retry, sizeof(retry), "retry: %d\n\n", EVENT_RETRY_MS);
+        enqueue(subscriber, retry, length);
+        return true;
+    }
+    
+    rejected++;
+    return false;
+}
+
+void EventStream::publish(const char *event, const char *data, bool accelOnly) {
+    // A new subscriber's response head and one event of the largest kind
+    // must fit its buffer together, or the first answer would drop it
+    static_assert(EVENT_BUFFER_SIZE >= sizeof(EVENT_STREAM_HEADER) + 16 + EVENT_MAX_TEXT_LENGTH,
+                  "EVENT_BUFFER_SIZE too small for the largest event");
+    
+    char text[EVENT_MAX_TEXT_LENGTH];
+    int length = snprintf(text, sizeof(text), "event: %s\ndata: %s\n\n", event, data);
+    if (length <= 0 || length >= (int)sizeof(text)) {
+        droppedEvents++;
+        return;
+    }
+    
+    for (int i = 0; i < EVENT_MAX_CLIENTS; i++) {
+        Subscriber &subscriber = subscribers[i];
+        if (subscriber.active && (!accelOnly || subscriber.accel)) {
+            enqueue(subscriber, text, length);
+        }
+    }
+    eventCount++;
+}
+
+void EventStream::publishAccel(const AccelSample &sample, uint8_t accelRange) {
+    unsigned long now = millis();
+    if (now - lastAccelEvent < EVENT_ACCEL_INTERVAL) {
+        return;
+    }
+    
+    bool anyAccel = false;
+    for (int i = 0; i < EVENT_MAX_CLIENTS; i++) {
+        if (subscribers[i].active && subscribers[i].accel) {
+            anyAccel = true;
+        }
+    }
+    if (!anyAccel) {
+        return;
+    }
+    lastAccelEvent = now;
+    
+    // Milli-g, integer only
+    uint8_t shift = 14 - (accelRange & 0x03);
+    char data[40];
+    snprintf(data, sizeof(data), "[%ld,%ld,%ld]",
+             ((long)sample.x * 1000) >> shift,
+             ((long)sample.y * 1000) >> shift,
+             ((long)sample.z * 1000) >> shift);
+    publish("accel", data, true);
+}
+
+void EventStream::service() {
+    unsigned long now = millis();
+    bool keepAlive = now - lastKeepAlive >= EVENT_KEEPALIVE_INTERVAL;
+    if (keepAlive) {
+        lastKeepAlive = now;
+    }
+    
+    for (int i = 0; i < EVENT_MAX_CLIENTS; i++) {
+        Subscriber &subscriber = subscribers[i];
+        if (!subscriber.active) {
+            continue;
+        }
+        if (!subscriber.client.connected()) {
+            subscriber.client.stop();
+            subscriber.active = false;
+            continue;
+        }
+        
+        // A comment line lets both ends notice dead connections
+        if (keepAlive && !enqueue(subscriber, ":\n\n", 3)) {
+            continue;
+        }
+        
+        if (subscriber.pending == 0) {
+            continue;
+        }
+        
+        // Only what fits in the socket's send buffer, so this never blocks
+        int space = subscriber.client.availableForWrite();
+        if (space <= 0) {
+            continue;
+        }
+        size_t chunk = subscriber.pending < (size_t)space ? subscriber.pending : (size_t)space;
+        size_t written = subscriber.client.write((const uint8_t*)subscriber.buffer, chunk);
+        if (written > 0) {
+            memmove(subscriber.buffer, subscriber.buffer + written, subscriber.pending - written);
+            subscriber.pending -= written;
+        }
+    }
+}
+
+uint8_t EventStream::getClientCount() const {
+    uint8_t count = 0;
+    for (int i = 0; i < EVENT_MAX_CLIENTS; i++) {
+        if (subscribers[i].active) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool EventStream::enqueue(Subscriber &subscriber, const char *text, size_t length) {
+    if (subscriber.pending + length > EVENT_BUFFER_SIZE) {
+        // Not draining fast enough - drop it instead of buffering without bound
+        drop(subscriber);
+        return false;
+    }
+    
+    memcpy(subscriber.buffer + subscriber.pending, text, length);
+    subscriber.pending += length;
+    return true;
+}
+
+void EventStream::drop(Subscriber &subscriber) {
+    subscriber.client.stop();
+    subscriber.active = false;
+    subscriber.pending = 0;
+    droppedClients++;
+}
@@ -0,0 +1,110 @@
+#include "FlipDetector.h"
+
+FlipDetector::FlipDetector(const FlipConfig &config) : config(config) {
+    flipCount = 0;
+    restingFace = FACE_UNKNOWN;
+    begin(MPU6050_DEFAULT_RANGE, MPU6050_DEFAULT_GYRO_RANGE);
+}
+
+void FlipDetector::begin(uint8_t accelRange, uint8_t gyroRange) {
+    countsPerG = 16384 >> (accelRange & 0x03);
+
+    // Gyro: 131 counts per °/s at ±250°/s, halving with each range step
+    uint8_t range = gyroRange & 0x03;
+    radiansPerCountQ20 = (int32_t)(1048576.0 * PI / 180.0 * (1 << range) / 131.0 + 0.5);
+    maxRateCounts = ((uint32_t)config.maxRateDps * 131) >> range;
+
+    float cosTilt = cos(config.tiltDegrees * PI / 180.0);
+    cosSqQ8 = (uint16_t)(cosTilt * cosTilt * 256.0 + 0.5);
+
+    hasEstimate = false;
+    lastUpdate = 0;
+    candidateFace = FACE_UNKNOWN;
+    candidateSince = 0;
+    lastFlip = 0;
+}
+
+bool FlipDetector::update(const MotionSample &sample, unsigned long now) {
+    const int16_t accel[3] = {sample.accel.x, sample.accel.y, sample.accel.z};
+    const int16_t rate[3] = {sample.gyroX, sample.gyroY, sample.gyroZ};
+    unsigned long elapsed = now - lastUpdate;
+    lastUpdate = now;
+
+    if (!hasEstimate || elapsed > FLIP_MAX_GAP_MS) {
+        for (int axis = 0; axis < 3; axis++) {
+            gravity[axis] = (int32_t)accel[axis] << 4;
+        }
+        hasEstimate = true;
+    } else {
+        // Gyro step: gravity is fixed in the world, so in the sensor frame it
+        // turns the other way, g -= θ × g with θ = ω·dt in radians (Q20)
+        int64_t theta[3];
+        for (int axis = 0; axis < 3; axis++) {
+            theta[axis] = (int64_t)rate[axis] * radiansPerCountQ20 * (int32_t)elapsed / 1000;
+        }
+        int32_t crossX = (int32_t)((theta[1] * gravity[2] - theta[2] * gravity[1]) >> 20);
+        int32_t crossY = (int32_t)((theta[2] * gravity[0] - theta[0] * gravity[2]) >> 20);
+        int32_t crossZ = (int32_t)((theta[0] * gravity[1] - theta[1] * gravity[0]) >> 20);
+        gravity[0] -= crossX;
+        gravity[1] -= crossY;
+        gravity[2] -= crossZ;
+
+        // Accelerometer step: pull the estimate toward the measurement
+        for (int axis = 0; axis < 3; axis++) {
+            gravity[axis] += (((int32_t)accel[axis] << 4) - gravity[axis]) >> config.blendShift;
+        }
+    }
+
+    // A face only counts once the device has been still in it for settleMs
+    uint32_t totalRate = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        totalRate += rate[axis] < 0 ? -rate[axis] : rate[axis];
+    }
+    Face face = classify();
+    if (totalRate > maxRateCounts || face != candidateFace) {
+        candidateFace = face;
+        candidateSince = now;
+        return false;
+    }
+    if (now - candidateSince < config.settleMs || face == FACE_SIDE || face == FACE_UNKNOWN ||
+        face == restingFace) {
+        return false;
+    }
+
+    Face previous = restingFace;
+    restingFace = face;
+    if (previous != FACE_DOWN || face != FACE_UP) {
+        return false;
+    }
+    if (flipCount > 0 && now - lastFlip < config.refractoryMs) {
+        return false;
+    }
+    lastFlip = now;
+    flipCount++;
+    return true;
+}
+
+FlipDetector::Face FlipDetector::classify() const {
+    // Face up/down when the face axis is within tiltDegrees of vertical:
+    // component² >= cos²(tilt) * |g|², compared without a square root
+    int32_t component[3];
+    uint32_t magnitudeSq = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        component[axis] = gravity[axis] >> 4;
+        magnitudeSq += (uint32_t)(component[axis] * component[axis]);
+    }
+    if (magnitudeSq < (uint32_t)countsPerG * countsPerG / 4) {
+        return FACE_UNKNOWN; // Well under 1g: falling or thrown
+    }
+
+    int32_t face = component[config.faceAxis] * config.faceSign;
+    uint64_t faceSq = (uint64_t)((int64_t)face * face) << 8;
+    if (faceSq < (uint64_t)magnitudeSq * cosSqQ8) {
+        return FACE_SIDE;
+    }
+    return face > 0 ? FACE_UP : FACE_DOWN;
+}
+
+int16_t FlipDetector::getGravityMilliG(uint8_t axis) const {
+    return (int16_t)(((gravity[axis % 3] >> 4) * 1000) / countsPerG);
+}
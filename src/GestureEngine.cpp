@@ -0,0 +1,174 @@
+#include "GestureEngine.h"
+
+// Gravity low-pass time constant: 2^GRAVITY_SHIFT samples
+#define GRAVITY_SHIFT 5
+#define ENERGY_SHIFT  8
+
+GestureEngine::GestureEngine(const GestureConfig &config) : config(config) {
+    shakeCount = 0;
+    begin(MPU6050_DEFAULT_RANGE, 50);
+}
+
+void GestureEngine::begin(uint8_t accelRange, uint16_t sampleRateHz) {
+    countsPerG = 16384 >> (accelRange & 0x03);
+
+    // Energy thresholds: window sum of per-sample deviation² in the same
+    // scaled units the ring stores
+    uint32_t on = (uint32_t)config.energyOnMilliG * countsPerG / 1000;
+    uint32_t off = (uint32_t)config.energyOffMilliG * countsPerG / 1000;
+    energyOnSum = ((on * on) >> ENERGY_SHIFT) * GESTURE_WINDOW_SIZE;
+    energyOffSum = ((off * off) >> ENERGY_SHIFT) * GESTURE_WINDOW_SIZE;
+
+    reversalDeadband = (int16_t)((uint32_t)config.reversalDeadbandMilliG * countsPerG / 1000);
+    jerkSum = (uint32_t)config.minJerkMilliG * countsPerG / 1000 * GESTURE_WINDOW_SIZE;
+    refractorySamples = (uint32_t)config.refractoryMs * sampleRateHz / 1000;
+
+    reset();
+}
+
+void GestureEngine::reset() {
+    head = 0;
+    filled = 0;
+    windowJerk = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        axisEnergy[axis] = 0;
+        axisReversals[axis] = 0;
+        gravity[axis] = 0;
+        lastSign[axis] = 0;
+    }
+    hasPrevious = false;
+    armed = true;
+    sampleCount = 0;
+    lastShakeSample = 0;
+}
+
+bool GestureEngine::update(const AccelSample &sample) {
+    const int16_t axes[3] = {sample.x, sample.y, sample.z};
+
+    if (!hasPrevious) {
+        // Seed the gravity estimate so the first window is not one big step
+        for (int axis = 0; axis < 3; axis++) {
+            gravity[axis] = (int32_t)axes[axis] << 4;
+        }
+        previous = sample;
+        hasPrevious = true;
+    }
+
+    // Drop the oldest sample's contribution once the window is full
+    Feature &slot = window[head];
+    if (filled == GESTURE_WINDOW_SIZE) {
+        for (int axis = 0; axis < 3; axis++) {
+            axisEnergy[axis] -= slot.energy[axis];
+            if (slot.reversals & (1 << axis)) {
+                axisReversals[axis]--;
+            }
+        }
+        windowJerk -= slot.jerk;
+    } else {
+        filled++;
+    }
+
+    // Features of the new sample
+    const int16_t prevAxes[3] = {previous.x, previous.y, previous.z};
+    uint32_t jerk = 0;
+    slot.reversals = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        gravity[axis] += (((int32_t)axes[axis] << 4) - gravity[axis]) >> GRAVITY_SHIFT;
+        int32_t deviation = (int32_t)axes[axis] - (gravity[axis] >> 4);
+
+        uint32_t magnitude = deviation < 0 ? -deviation : deviation;
+        slot.energy[axis] = (magnitude * magnitude) >> ENERGY_SHIFT;
+        axisEnergy[axis] += slot.energy[axis];
+
+        // A reversal is a swing past the deadband on the opposite side
+        int8_t sign = 0;
+        if (deviation > reversalDeadband) sign = 1;
+        else if (deviation < -reversalDeadband) sign = -1;
+        if (sign != 0) {
+            if (lastSign[axis] != 0 && sign != lastSign[axis]) {
+                slot.reversals |= (1 << axis);
+                axisReversals[axis]++;
+            }
+            lastSign[axis] = sign;
+        }
+
+        int32_t delta = (int32_t)axes[axis] - prevAxes[axis];
+        jerk += delta < 0 ? -delta : delta;
+    }
+    slot.jerk = jerk > 0xFFFF ? 0xFFFF : (uint16_t)jerk;
+    windowJerk += slot.jerk;
+
+    previous = sample;
+    head = (head + 1) % GESTURE_WINDOW_SIZE;
+    sampleCount++;
+
+    uint32_t energy = totalEnergy();
+
+    // Hysteresis: re-arm only once motion has died down and the refractory
+    // period since the last shake has passed
+    if (!armed) {
+        if (energy < energyOffSum && sampleCount - lastShakeSample >= refractorySamples) {
+            armed = true;
+        }
+        return false;
+    }
+
+    if (filled < GESTURE_WINDOW_SIZE) {
+        return false;
+    }
+
+    if (energy >= energyOnSum &&
+        axisReversals[dominantAxis()] >= config.minReversals &&
+        windowJerk >= jerkSum) {
+        armed = false;
+        lastShakeSample = sampleCount;
+        shakeCount++;
+        return true;
+    }
+
+    return false;
+}
+
+uint8_t GestureEngine::dominantAxis() const {
+    uint8_t dominant = 0;
+    for (uint8_t axis = 1; axis < 3; axis++) {
+        if (axisEnergy[axis] > axisEnergy[dominant]) {
+            dominant = axis;
+        }
+    }
+    return dominant;
+}
+
+uint16_t GestureEngine::getEnergyMilliG() const {
+    if (filled == 0) {
+        return 0;
+    }
+
+    // Integer square root of the mean deviation², back in milli-g
+    uint32_t mean = totalEnergy() / filled;
+    if (mean > (0xFFFFFFFFUL >> ENERGY_SHIFT)) {
+        mean = 0xFFFFFFFFUL >> ENERGY_SHIFT;
+    }
+    uint32_t meanSq = mean << ENERGY_SHIFT;
+    uint32_t root = 0;
+    for (uint32_t bit = 1UL << 30; bit != 0; bit >>= 2) {
+        if (meanSq >= root + bit) {
+            meanSq -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+    }
+    return (uint16_t)(root * 1000 / countsPerG);
+}
+
+uint8_t GestureEngine::getDominantReversals() const {
+    return axisReversals[dominantAxis()];
+}
+
+uint16_t GestureEngine::getJerkMilliG() const {
+    if (filled == 0) {
+        return 0;
+    }
+    return (uint16_t)(windowJerk / filled * 1000 / countsPerG);
+}
@@ -0,0 +1,367 @@
+#include "I2CBus.h"
+
+I2CBus i2cBus;
+
+I2CBus::I2CBus() {
+    clientCount = 0;
+    currentClock = 0;
+    started = false;
+    servicing = false;
+    transactionStart = 0;
+    lastRecoveryLog = 0;
+    unloggedRecoveries = 0;
+    sdaPin = 0;
+    sclPin = 0;
+}
+
+void I2CBus::begin(uint8_t sda, uint8_t scl) {
+    sdaPin = sda;
+    sclPin = scl;
+    
+    // A device left mid-byte by a reset would otherwise hold SDA from boot
+    pinMode(sdaPin, INPUT_PULLUP);
+    if (digitalRead(sdaPin) == LOW) {
+        recoverBus();
+    }
+    Wire.begin(sdaPin, sclPin);
+    Wire.setClock(I2C_DEFAULT_CLOCK);
+    Wire.setClockStretchLimit(I2C_CLOCK_STRETCH_LIMIT_US);
+    currentClock = I2C_DEFAULT_CLOCK;
+    started = true;
+    
+    Serial.print("I2C bus started on pins SDA=");
+    Serial.print(sdaPin);
+    Serial.print(", SCL=");
+    Serial.println(sclPin);
+}
+
+int8_t I2CBus::registerClient(const char *name, uint8_t address, uint32_t maxClock) {
+    // Re-registering the same address returns the existing client
+    for (uint8_t i = 0; i < clientCount; i++) {
+        if (clients[i].address == address) {
+            clients[i].maxClock = maxClock;
+            return i;
+        }
+    }
+    
+    if (clientCount >= I2C_MAX_CLIENTS) {
+        Serial.println("ERROR: Too many I2C bus clients");
+        return I2C_NO_CLIENT;
+    }
+    
+    Client &client = clients[clientCount];
+    client.name = name;
+    client.address = address;
+    client.maxClock = maxClock;
+    client.service = 0;
+    client.serviceInterval = 0;
+    client.lastService = 0;
+    memset(&client.stats, 0, sizeof(client.stats));
+    
+    Serial.print("I2C client ");
+    Serial.print(name);
+    Serial.print(" at 0x");
+    Serial.print(address, HEX);
+    Serial.print(", max ");
+    Serial.print(maxClock / 1000);
+    Serial.println("kHz");
+    return clientCount++;
+}
+
+void I2CBus::setServiceCallback(int8_t client, void (*callback)(), uint32_t intervalMicros) {
+    if (!validClient(client)) {
+        return;
+    }
+    clients[client].service = callback;
+    clients[client].serviceInterval = intervalMicros;
+    clients[client].lastService = micros();
+}
+
+void I2CBus::selectClock(int8_t client) {
+    uint32_t clock = validClient(client) ? clients[client].maxClock : I2C_DEFAULT_CLOCK;
+    if (clock != currentClock) {
+        Wire.setClock(clock);
+        currentClock = clock;
+    }
+}
+
+void I2CBus::recordTransaction(int8_t client, bool ok) {
+    if (!validClient(client)) {
+        return;
+    }
+    
+    uint32_t elapsed = micros() - transactionStart;
+    I2CClientStats &stats = clients[client].stats;
+    stats.transactions++;
+    stats.lifetimeTransactions++;
+    stats.totalMicros += elapsed;
+    if (elapsed > stats.maxMicros) {
+        stats.maxMicros = elapsed;
+    }
+    if (!ok) {
+        stats.errors++;
+        stats.lifetimeErrors++;
+    }
+}
+
+int8_t I2CBus::findClient(uint8_t address) const {
+    for (uint8_t i = 0; i < clientCount; i++) {
+        if (clients[i].address == address) {
+            return i;
+        }
+    }
+    return I2C_NO_CLIENT;
+}
+
+uint32_t I2CBus::timeoutFor(uint8_t bytes) const {
+    // Rounded up per byte so the product cannot overflow
+    uint32_t clock = currentClock ? currentClock : I2C_DEFAULT_CLOCK;
+    uint32_t perByte = (I2C_BYTE_BUDGET_CLOCKS * 1000000UL + clock - 1) / clock;
+    return I2C_TRANSACTION_OVERHEAD_US + bytes * perByte;
+}
+
+I2CStatus I2CBus::attempt(uint8_t address, const uint8_t *reg, const uint8_t *value,
+                          uint8_t *buffer, uint8_t length) {
+    uint32_t start = micros();
+    bool read = reg && !value;
+    Wire.beginTransmission(address);
+    if (reg) {
+        Wire.write(*reg);
+    }
+    if (value) {
+        Wire.write(*value);
+    }
+    // A read keeps the bus with a repeated start
+    uint8_t wireStatus = Wire.endTransmission(!read);
+    
+    I2CStatus status;
+    switch (wireStatus) {
+        case 0: status = I2C_OK; break;
+        case 2: status = I2C_NACK_ADDRESS; break;
+        case 1:
+        case 3: status = I2C_NACK_DATA; break;
+        default: status = I2C_BUS_BUSY; break; // 4: SDA/SCL held low or lost arbitration
+    }
+    
+    if (status == I2C_OK && read) {
+        uint8_t received = Wire.requestFrom(address, length);
+        for (uint8_t i = 0; i < received && i < length; i++) {
+            buffer[i] = Wire.read();
+        }
+        if (received != length) {
+            status = I2C_SHORT_READ;
+        }
+    }
+    
+    // Wire only bounds each clock; a device stretching every clock can
+    // still stall a transaction, and its data is not trusted. The budget
+    // counts address, register and data bytes, plus the repeated start's
+    // address byte and the data read back.
+    uint8_t bytes = 1 + (reg ? 1 : 0) + (value ? 1 : 0) + (read ? 1 + length : 0);
+    if (micros() - start > timeoutFor(bytes) &&
+        (status == I2C_OK || status == I2C_SHORT_READ || status == I2C_BUS_BUSY)) {
+        status = I2C_TIMEOUT;
+    }
+    return status;
+}
+
+I2CStatus I2CBus::transact(int8_t client, uint8_t reg, const uint8_t *value,
+                           uint8_t *buffer, uint8_t length) {
+    if (!validClient(client)) {
+        return I2C_INVALID_CLIENT;
+    }
+    
+    selectClock(client);
+    transactionStart = micros();
+    I2CClientStats &stats = clients[client].stats;
+    bool recovered = false;
+    I2CStatus status = I2C_OK;
+    for (uint8_t attemptNumber = 0; attemptNumber <= I2C_MAX_RETRIES; attemptNumber++) {
+        if (attemptNumber > 0) {
+            stats.retries++;
+        }
+        status = attempt(clients[client].address, &reg, value, buffer, length);
+        if (status == I2C_OK) {
+            break;
+        }
+        
+        if (status == I2C_NACK_ADDRESS || status == I2C_NACK_DATA) {
+            stats.nacks++;
+        } else if (status == I2C_TIMEOUT) {
+            // A stretching device would likely stall the retry too; clear
+            // the bus and give up so the worst case stays one slow attempt
+            stats.timeouts++;
+            stats.recoveries++;
+            recoverBus();
+            break;
+        } else if (status == I2C_BUS_BUSY && !recovered) {
+            recovered = true;
+            stats.recoveries++;
+            recoverBus();
+        }
+    }
+    recordTransaction(client, status == I2C_OK);
+    return status;
+}
+
+I2CStatus I2CBus::writeRegister(int8_t client, uint8_t reg, uint8_t value) {
+    return transact(client, reg, &value, 0, 0);
+}
+
+I2CStatus I2CBus::readRegisters(int8_t client, uint8_t reg, uint8_t *buffer, uint8_t length) {
+    // Write the start register, then read 'length' bytes after a repeated start
+    return transact(client, reg, 0, buffer, length);
+}
+
+bool I2CBus::recoverBus() {
+    // Take the pins from Wire: a slave stuck mid-byte releases SDA after at
+    // most nine clocks, then a STOP resets every device's bus state
+    pinMode(sdaPin, INPUT_PULLUP);
+    pinMode(sclPin, OUTPUT_OPEN_DRAIN);
+    for (uint8_t pulse = 0; pulse < I2C_BUS_CLEAR_PULSES && digitalRead(sdaPin) == LOW; pulse++) {
+        digitalWrite(sclPin, LOW);
+        delayMicroseconds(I2C_BUS_CLEAR_HALF_PERIOD);
+        digitalWrite(sclPin, HIGH);
+        delayMicroseconds(I2C_BUS_CLEAR_HALF_PERIOD);
+    }
+    
+    // STOP: SDA rises while SCL is high
+    pinMode(sdaPin, OUTPUT_OPEN_DRAIN);
+    digitalWrite(sclPin, LOW);
+    digitalWrite(sdaPin, LOW);
+    delayMicroseconds(I2C_BUS_CLEAR_HALF_PERIOD);
+    digitalWrite(sclPin, HIGH);
+    delayMicroseconds(I2C_BUS_CLEAR_HALF_PERIOD);
+    digitalWrite(sdaPin, HIGH);
+    delayMicroseconds(I2C_BUS_CLEAR_HALF_PERIOD);
+    pinMode(sdaPin, INPUT_PULLUP);
+    pinMode(sclPin, INPUT_PULLUP);
+    bool clear = digitalRead(sdaPin) == HIGH && digitalRead(sclPin) == HIGH;
+    
+    if (started) {
+        Wire.begin(sdaPin, sclPin);
+        Wire.setClock(currentClock);
+        Wire.setClockStretchLimit(I2C_CLOCK_STRETCH_LIMIT_US);
+    }
+    
+    // A flaky bus can need a clear on every transaction; the per-client
+    // recovery counts keep the totals, so the log only samples them
+    unloggedRecoveries++;
+    if (lastRecoveryLog != 0 && millis() - lastRecoveryLog < I2C_RECOVERY_LOG_MS) {
+        return clear;
+    }
+    lastRecoveryLog = millis();
+    Serial.print(clear ? "I2C bus cleared" : "ERROR: I2C bus still held low");
+    Serial.print(" (");
+    Serial.print(unloggedRecoveries);
+    Serial.println(" clears since last report)");
+    unloggedRecoveries = 0;
+    return clear;
+}
+
+const char *I2CBus::statusName(I2CStatus status) {
+    switch (status) {
+        case I2C_OK: return "ok";
+        case I2C_NACK_ADDRESS: return "address nack";
+        case I2C_NACK_DATA: return "data nack";
+        case I2C_SHORT_READ: return "short read";
+        case I2C_TIMEOUT: return "timeout";
+        case I2C_BUS_BUSY: return "bus busy";
+        case I2C_INVALID_CLIENT: return "invalid client";
+    }
+    return "unknown";
+}
+
+bool I2CBus::probe(uint8_t address) {
+    // Scans go through the same status mapping as register transactions, and
+    // a probe of a registered device shows up in its numbers
+    int8_t client = findClient(address);
+    selectClock(client);
+    transactionStart = micros();
+    I2CStatus status = attempt(address, 0, 0, 0, 0);
+    if (validClient(client)) {
+        I2CClientStats &stats = clients[client].stats;
+        if (status == I2C_NACK_ADDRESS || status == I2C_NACK_DATA) {
+            stats.nacks++;
+        } else if (status == I2C_TIMEOUT) {
+            stats.timeouts++;
+        }
+        recordTransaction(client, status == I2C_OK);
+    }
+    return status == I2C_OK;
+}
+
+void I2CBus::beginExternal(int8_t client) {
+    // The client's driver sets its own clock (U8g2 does so per transfer)
+    if (validClient(client)) {
+        currentClock = clients[client].maxClock;
+    }
+    transactionStart = micros();
+}
+
+void I2CBus::endExternal(int8_t client, bool ok) {
+    // U8g2 calls Wire.begin() on init, and twi_init() puts the core's 150ms
+    // stretch limit back; restore ours so the bounds below keep holding
+    Wire.setClockStretchLimit(I2C_CLOCK_STRETCH_LIMIT_US);
+    recordTransaction(client, ok);
+}
+
+void I2CBus::serviceClients() {
+    if (servicing) {
+        return;
+    }
+    
+    servicing = true;
+    uint32_t now = micros();
+    for (uint8_t i = 0; i < clientCount; i++) {
+        Client &client = clients[i];
+        if (client.service && now - client.lastService >= client.serviceInterval) {
+            client.lastService = now;
+            client.service();
+        }
+    }
+    servicing = false;
+}
+
+const I2CClientStats *I2CBus::getStats(int8_t client) const {
+    return validClient(client) ? &clients[client].stats : 0;
+}
+
+const char *I2CBus::getClientName(int8_t client) const {
+    return validClient(client) ? clients[client].name : "";
+}
+
+void I2CBus::printStats() {
+    for (uint8_t i = 0; i < clientCount; i++) {
+        const I2CClientStats &stats = clients[i].stats;
+        Serial.print("I2C ");
+        Serial.print(clients[i].name);
+        Serial.print(": ");
+        Serial.print(stats.transactions);
+        Serial.print(" txns, ");
+        Serial.print(stats.errors);
+        Serial.print(" errors, avg ");
+        Serial.print(stats.transactions ? stats.totalMicros / stats.transactions : 0);
+        Serial.print("us, max ");
+        Serial.print(stats.maxMicros);
+        Serial.print("us; total ");
+        Serial.print(stats.nacks);
+        Serial.print(" nacks, ");
+        Serial.print(stats.timeouts);
+        Serial.print(" timeouts, ");
+        Serial.print(stats.retries);
+        Serial.print(" retries, ");
+        Serial.print(stats.recoveries);
+        Serial.println(" recoveries");
+    }
+}
+
+void I2CBus::resetStats() {
+    for (uint8_t i = 0; i < clientCount; i++) {
+        I2CClientStats &stats = clients[i].stats;
+        stats.transactions = 0;
+        stats.errors = 0;
+        stats.totalMicros = 0;
+        stats.maxMicros = 0;
+    }
+}
@@ -0,0 +1,119 @@
+#include "Metrics.h"
+#include <stdarg.h>
+
+#define METRICS_PREFIX "magic8ball_"
+
+MetricsRegistry metrics;
+
+// Accumulates export text and hands it out in fixed-size chunks
+class MetricsWriter {
+public:
+    explicit MetricsWriter(void (*emit)(const char *text, size_t length)) : emit(emit), length(0) {}
+
+    void printf(const char *format, ...) {
+        char line[128];
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(line, sizeof(line), format, args);
+        va_end(args);
+        if (written <= 0) {
+            return;
+        }
+        if (written >= (int)sizeof(line)) {
+            written = sizeof(line) - 1;
+        }
+        
+        if (length + written > sizeof(buffer)) {
+            flush();
+        }
+        memcpy(buffer + length, line, written);
+        length += written;
+    }
+
+    void flush() {
+        if (length > 0) {
+            emit(buffer, length);
+            length = 0;
+        }
+    }
+
+private:
+    void (*emit)(const char *text, size_t length);
+    char buffer[METRICS_CHUNK_SIZE];
+    size_t length;
+};
+
+MetricsRegistry::MetricsRegistry() {
+    count = 0;
+}
+
+void MetricsRegistry::add(const char *name, const char *help, const char *labels, uint8_t type, void *metric) {
+    if (count >= METRICS_MAX_ENTRIES) {
+        Serial.print("Metrics registry full, ignoring ");
+        Serial.println(name);
+        return;
+    }
+    
+    Entry &entry = entries[count++];
+    entry.name = name;
+    entry.help = help;
+    entry.labels = labels;
+    entry.type = type;
+    entry.metric = metric;
+}
+
+void MetricsRegistry::addCounter(const char *name, const char *help, MetricCounter &counter, const char *labels) {
+    add(name, help, labels, COUNTER, &counter);
+}
+
+void MetricsRegistry::addGauge(const char *name, const char *help, MetricGauge &gauge, const char *labels) {
+    add(name, help, labels, GAUGE, &gauge);
+}
+
+void MetricsRegistry::addHistogram(const char *name, const char *help, LatencyHistogram &histogram) {
+    add(name, help, 0, HISTOGRAM, &histogram);
+}
+
+void MetricsRegistry::exportText(void (*emit)(const char *text, size_t length)) const {
+    static const char *const typeNames[] = { "counter", "gauge", "histogram" };
+    MetricsWriter out(emit);
+    
+    for (uint8_t i = 0; i < count; i++) {
+        const Entry &entry = entries[i];
+        
+        // HELP and TYPE once per metric family
+        if (i == 0 || strcmp(entries[i - 1].name, entry.name) != 0) {
+            out.printf("# HELP " METRICS_PREFIX "%s %s\n", entry.name, entry.help);
+            out.printf("# TYPE " METRICS_PREFIX "%s %s\n", entry.name, typeNames[entry.type]);
+        }
+        
+        const char *open = entry.labels ? "{" : "";
+        const char *labels = entry.labels ? entry.labels : "";
+        const char *close = entry.labels ? "}" : "";
+        
+        if (entry.type == COUNTER) {
+            out.printf(METRICS_PREFIX "%s%s%s%s %lu\n", entry.name, open, labels, close,
+                       (unsigned long)((const MetricCounter*)entry.metric)->get());
+        } else if (entry.type == GAUGE) {
+            out.printf(METRICS_PREFIX "%s%s%s%s %ld\n", entry.name, open, labels, close,
+                       (long)((const MetricGauge*)entry.metric)->get());
+        } else {
+            // Bucket bounds are microseconds, exported as-is
+            const LatencyHistogram *histogram = (const LatencyHistogram*)entry.metric;
+            uint32_t cumulative = 0;
+            for (uint8_t bucket = 0; bucket < LATENCY_BUCKET_COUNT - 1; bucket++) {
+                cumulative += histogram->getBucketCount(bucket);
+                out.printf(METRICS_PREFIX "%s_bucket{le=\"%lu\"} %lu\n", entry.name,
+                           (unsigned long)LatencyHistogram::bucketBound(bucket), (unsigned long)cumulative);
+            }
+            out.printf(METRICS_PREFIX "%s_bucket{le=\"+Inf\"} %lu\n", entry.name,
+                       (unsigned long)histogram->getCount());
+            out.printf(METRICS_PREFIX "%s_sum %llu\n", entry.name,
+                       (unsigned long long)histogram->getSum());
+            out.printf(METRICS_PREFIX "%s_count %lu\n", entry.name,
+                       (unsigned long)histogram->getCount());
+        }
+    }
+    
+    out.flush();
+}
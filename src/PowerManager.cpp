@@ -0,0 +1,97 @@
+#include "PowerManager.h"
+
+extern "C" {
+#include "user_interface.h"
+#include "gpio.h"
+}
+
+PowerManager::PowerManager() {
+    state = POWER_ACTIVE;
+    lastActivity = 0;
+    stateSince = 0;
+    for (int i = 0; i < POWER_STATE_COUNT; i++) {
+        stateTime[i] = 0;
+    }
+    transitions = 0;
+    loadMilliAmps = 0;
+    loadSince = 0;
+    chargeMilliAmpMs = 0;
+}
+
+const char *PowerManager::getStateName(PowerState state) {
+    static const char *const names[POWER_STATE_COUNT] = { "active", "idle", "deep_idle" };
+    return state < POWER_STATE_COUNT ? names[state] : "unknown";
+}
+
+void PowerManager::noteActivity(unsigned long now) {
+    lastActivity = now;
+}
+
+bool PowerManager::update(unsigned long now) {
+    unsigned long quiet = now - lastActivity;
+    PowerState next = POWER_ACTIVE;
+    if (quiet >= POWER_DEEP_IDLE_AFTER) {
+        next = POWER_DEEP_IDLE;
+    } else if (quiet >= POWER_IDLE_AFTER) {
+        next = POWER_IDLE;
+    }
+    
+    if (next == state) {
+        return false;
+    }
+    enter(next, now);
+    return true;
+}
+
+void PowerManager::enter(PowerState next, unsigned long now) {
+    stateTime[state] += now - stateSince;
+    stateSince = now;
+    state = next;
+    transitions++;
+}
+
+void PowerManager::setLoad(uint16_t milliAmps, unsigned long now) {
+    accumulate(now);
+    loadMilliAmps = milliAmps;
+}
+
+void PowerManager::accumulate(unsigned long now) {
+    chargeMilliAmpMs += (uint64_t)loadMilliAmps * (now - loadSince);
+    loadSince = now;
+}
+
+uint32_t PowerManager::getTimeInState(PowerState which, unsigned long now) const {
+    uint32_t time = stateTime[which];
+    if (which == state) {
+        time += now - stateSince;
+    }
+    return time;
+}
+
+uint16_t PowerManager::getAverageMilliAmps(unsigned long now) const {
+    if (now == 0) {
+        return loadMilliAmps;
+    }
+    uint64_t charge = chargeMilliAmpMs + (uint64_t)loadMilliAmps * (now - loadSince);
+    return (uint16_t)(charge / now);
+}
+
+void PowerManager::lightSleep(uint32_t timeoutMs, uint8_t wakePin) {
+    // The SDK only enters forced light sleep with the radio in NULL_MODE;
+    // it starts at the next idle point, which the delay() provides
+    wifi_set_opmode_current(NULL_MODE);
+    wifi_fpm_set_sleep_type(LIGHT_SLEEP_T);
+    wifi_fpm_open();
+    gpio_pin_wakeup_enable(GPIO_ID_PIN(wakePin), GPIO_PIN_INTR_HILEVEL);
+    
+    if (timeoutMs == 0) {
+        wifi_fpm_do_sleep(0xFFFFFFF); // Special value: until a GPIO wake-up
+        delay(10);
+    } else {
+        wifi_fpm_do_sleep(timeoutMs * 1000);
+        delay(timeoutMs + 1);
+    }
+    
+    gpio_pin_wakeup_disable();
+    wifi_fpm_close();
+}
@@ -0,0 +1,77 @@
+#ifdef MAGIC8BALL_PROFILER
+
+#include "Profiler.h"
+
+Profiler profiler;
+
+Profiler::Profiler() {
+    head = 0;
+    recordCount = 0;
+}
+
+void Profiler::exportTrace(uint8_t frames, void (*emit)(const char *text, size_t length)) {
+    uint16_t stored = recordCount < PROFILER_RING_SIZE ? recordCount : PROFILER_RING_SIZE;
+    uint16_t oldest = (head + PROFILER_RING_SIZE - stored) % PROFILER_RING_SIZE;
+    
+    // Walk back to the frame starts: the newest one belongs to the frame in
+    // progress (the one serving this request) and is excluded
+    uint16_t last = stored;
+    uint16_t first = stored;
+    uint8_t found = 0;
+    for (uint16_t i = stored; i > 0 && found <= frames; i--) {
+        if (ring[(oldest + i - 1) % PROFILER_RING_SIZE].phase == FRAME_BEGIN) {
+            if (found == 0) {
+                last = i - 1;
+            } else {
+                first = i - 1;
+            }
+            found++;
+        }
+    }
+    
+    char buffer[PROFILER_CHUNK_SIZE];
+    size_t length = 0;
+    length += snprintf(buffer, sizeof(buffer), "{\"traceEvents\":[");
+    
+    if (found > 1) {
+        // Timestamps in microseconds from the first record; deltas keep the
+        // 32-bit cycle counter's wraparound harmless
+        uint32_t cyclesPerMicro = ESP.getCpuFreqMHz();
+        uint32_t startCycles = ring[(oldest + first) % PROFILER_RING_SIZE].cycles;
+        bool separator = false;
+        
+        for (uint16_t i = first; i < last; i++) {
+            const Record &entry = ring[(oldest + i) % PROFILER_RING_SIZE];
+            uint32_t elapsed = entry.cycles - startCycles;
+            
+            char event[96];
+            int written = snprintf(event, sizeof(event),
+                                   "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%lu.%03lu,\"pid\":1,\"tid\":1}",
+                                   separator ? "," : "", entry.zone, entry.phase == END ? 'E' : 'B',
+                                   (unsigned long)(elapsed / cyclesPerMicro),
+                                   (unsigned long)((elapsed % cyclesPerMicro) * 1000 / cyclesPerMicro));
+            if (written <= 0 || written >= (int)sizeof(event)) {
+                continue;
+            }
+            separator = true;
+            
+            if (length + written > sizeof(buffer)) {
+                emit(buffer, length);
+                length = 0;
+            }
+            memcpy(buffer + length, event, written);
+            length += written;
+        }
+    }
+    
+    const char *tail = "]}\n";
+    if (length + strlen(tail) > sizeof(buffer)) {
+        emit(buffer, length);
+        length = 0;
+    }
+    memcpy(buffer + length, tail, strlen(tail));
+    length += strlen(tail);
+    emit(buffer, length);
+}
+
+#endif // MAGIC8BALL_PROFILER
@@ -0,0 +1,276 @@
+#include "ResponseCatalog.h"
+#include "ResponseLayout.h"
+
+#define CATALOG_HEADER_SIZE    16
+#define CATALOG_SET_ENTRY_SIZE 16
+#define CATALOG_CHUNK          128
+
+static uint32_t readU32(const uint8_t *bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+           ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static uint16_t readU16(const uint8_t *bytes) {
+    return (uint16_t)bytes[0] | ((uint16_t)bytes[1] << 8);
+}
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t *data, size_t length) {
+    crc = ~crc;
+    while (length--) {
+        crc ^= *data++;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+ResponseCatalog::ResponseCatalog() {
+    setCount = 0;
+    selected = -1;
+    mounted = false;
+    active = false;
+}
+
+bool ResponseCatalog::begin() {
+    mounted = LittleFS.begin();
+    if (!mounted) {
+        Serial.println("LittleFS mount failed - using built-in answers");
+        return false;
+    }
+    if (!open()) {
+        return false;
+    }
+    
+    // Restore the last selection by name, so it survives catalog updates
+    File selection = LittleFS.open(CATALOG_SELECTION_PATH, "r");
+    if (selection) {
+        char name[CATALOG_NAME_LENGTH + 1] = {0};
+        selection.read((uint8_t*)name, CATALOG_NAME_LENGTH);
+        selection.close();
+        select(findSet(name));
+    } else {
+        select(0);
+    }
+    return true;
+}
+
+bool ResponseCatalog::open() {
+    if (file) {
+        file.close();
+    }
+    active = false;
+    setCount = 0;
+    
+    if (!LittleFS.exists(CATALOG_PATH)) {
+        return false;
+    }
+    file = LittleFS.open(CATALOG_PATH, "r");
+    if (!file) {
+        return false;
+    }
+    
+    // Header and set table only; entries are read on demand
+    uint8_t header[CATALOG_HEADER_SIZE];
+    if (file.read(header, sizeof(header)) != sizeof(header) ||
+        memcmp(header, CATALOG_MAGIC, 4) != 0 || header[4] != CATALOG_VERSION ||
+        header[5] == 0 || header[5] > CATALOG_MAX_SETS || readU32(header + 8) != file.size()) {
+        Serial.println("Catalog header invalid - using built-in answers");
+        file.close();
+        return false;
+    }
+    
+    uint8_t count = header[5];
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t entry[CATALOG_SET_ENTRY_SIZE];
+        if (file.read(entry, sizeof(entry)) != sizeof(entry)) {
+            file.close();
+            return false;
+        }
+        SetInfo &set = sets[i];
+        memcpy(set.name, entry, CATALOG_NAME_LENGTH);
+        set.name[CATALOG_NAME_LENGTH] = '\0';
+        set.entryCount = readU16(entry + 10);
+        set.indexOffset = readU32(entry + 12);
+    }
+    setCount = count;
+    
+    Serial.print("Response catalog: ");
+    Serial.print(setCount);
+    Serial.println(" set(s)");
+    return true;
+}
+
+bool ResponseCatalog::validate(const char *path) {
+    File candidate = LittleFS.open(path, "r");
+    if (!candidate) {
+        return false;
+    }
+    
+    uint8_t header[CATALOG_HEADER_SIZE];
+    size_t size = candidate.size();
+    bool ok = candidate.read(header, sizeof(header)) == sizeof(header) &&
+              memcmp(header, CATALOG_MAGIC, 4) == 0 && header[4] == CATALOG_VERSION &&
+              header[5] > 0 && header[5] <= CATALOG_MAX_SETS && readU32(header + 8) == size;
+    
+    // CRC over everything after the header, streamed in small chunks
+    uint32_t crc = 0;
+    uint8_t chunk[CATALOG_CHUNK];
+    while (ok && candidate.position() < size) {
+        size_t length = candidate.read(chunk, sizeof(chunk));
+        if (length == 0) {
+            ok = false;
+            break;
+        }
+        crc = crc32Update(crc, chunk, length);
+    }
+    ok = ok && crc == readU32(header + 12);
+    
+    // Every set's offsets must be increasing, in bounds and within the entry
+    // limit, and every entry must fit on the display. Any short read fails
+    // the check: a catalog that cannot be read back must not be installed.
+    for (uint8_t s = 0; ok && s < header[5]; s++) {
+        uint8_t entry[CATALOG_SET_ENTRY_SIZE];
+        if (!candidate.seek(CATALOG_HEADER_SIZE + s * CATALOG_SET_ENTRY_SIZE) ||
+            candidate.read(entry, sizeof(entry)) != sizeof(entry)) {
+            ok = false;
+            break;
+        }
+        uint16_t count = readU16(entry + 10);
+        uint32_t indexOffset = readU32(entry + 12);
+        uint32_t indexEnd = indexOffset + 4UL * (count + 1);
+        if (count == 0 || indexEnd > size) {
+            ok = false;
+            break;
+        }
+        
+        uint8_t raw[4];
+        ok = candidate.seek(indexOffset) && candidate.read(raw, 4) == 4;
+        uint32_t previous = readU32(raw);
+        ok = ok && previous == indexEnd;
+        for (uint16_t i = 0; ok && i < count; i++) {
+            ok = candidate.read(raw, 4) == 4;
+            uint32_t next = readU32(raw);
+            ok = ok && next >= previous && next <= size && next - previous <= CATALOG_MAX_ENTRY_LENGTH;
+            if (!ok) {
+                break;
+            }
+            
+            // Read the text, then come back to the index
+            char text[CATALOG_MAX_ENTRY_LENGTH];
+            size_t length = next - previous;
+            uint32_t indexPosition = candidate.position();
+            ok = candidate.seek(previous) && candidate.read((uint8_t*)text, length) == length &&
+                 responseFits(text, length) && candidate.seek(indexPosition);
+            previous = next;
+        }
+    }
+    
+    candidate.close();
+    return ok;
+}
+
+bool ResponseCatalog::install(const char *uploadPath) {
+    if (!validate(uploadPath)) {
+        LittleFS.remove(uploadPath);
+        return false;
+    }
+    
+    // Keep the current selection name across the swap
+    char name[CATALOG_NAME_LENGTH + 1] = {0};
+    if (getSelectedSet() >= 0) {
+        strcpy(name, sets[selected].name);
+    }
+    
+    if (file) {
+        file.close();
+    }
+    LittleFS.remove(CATALOG_PATH);
+    LittleFS.rename(uploadPath, CATALOG_PATH);
+    if (!open()) {
+        return false;
+    }
+    select(findSet(name));
+    return true;
+}
+
+const char *ResponseCatalog::getSetName(uint8_t set) const {
+    return set < setCount ? sets[set].name : "";
+}
+
+uint16_t ResponseCatalog::getSetEntryCount(uint8_t set) const {
+    return set < setCount ? sets[set].entryCount : 0;
+}
+
+int8_t ResponseCatalog::findSet(const char *name) const {
+    for (uint8_t i = 0; i < setCount; i++) {
+        if (strcmp(sets[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool ResponseCatalog::select(int8_t set) {
+    if (set >= (int8_t)setCount) {
+        return false;
+    }
+    
+    selected = set;
+    active = set >= 0 && file;
+    saveSelection();
+    return true;
+}
+
+void ResponseCatalog::saveSelection() {
+    if (!mounted) {
+        return;
+    }
+    
+    // Flash wears with every write; begin() and install() re-select the same
+    // set, so only write when the saved name actually changes
+    const char *name = selected >= 0 ? sets[selected].name : "";
+    size_t length = strlen(name);
+    File selection = LittleFS.open(CATALOG_SELECTION_PATH, "r");
+    if (selection) {
+        char saved[CATALOG_NAME_LENGTH + 1];
+        size_t savedLength = selection.read((uint8_t*)saved, CATALOG_NAME_LENGTH + 1);
+        selection.close();
+        if (savedLength == length && memcmp(saved, name, length) == 0) {
+            return;
+        }
+    }
+    
+    selection = LittleFS.open(CATALOG_SELECTION_PATH, "w");
+    if (selection) {
+        selection.write((const uint8_t*)name, length);
+        selection.close();
+    }
+}
+
+uint16_t ResponseCatalog::getEntryCount() const {
+    return active ? sets[selected].entryCount : 0;
+}
+
+size_t ResponseCatalog::getEntry(uint16_t index, char *buffer, size_t bufferSize) {
+    if (!active || index >= sets[selected].entryCount || bufferSize == 0) {
+        return 0;
+    }
+    
+    // One 8-byte index read for the bounds, one read for the text
+    uint8_t raw[8];
+    if (!file.seek(sets[selected].indexOffset + 4UL * index) || file.read(raw, sizeof(raw)) != sizeof(raw)) {
+        return 0;
+    }
+    uint32_t start = readU32(raw);
+    uint32_t length = readU32(raw + 4) - start;
+    if (length >= bufferSize) {
+        length = bufferSize - 1;
+    }
+    
+    if (!file.seek(start) || file.read((uint8_t*)buffer, length) != length) {
+        return 0;
+    }
+    buffer[length] = '\0';
+    return length;
+}
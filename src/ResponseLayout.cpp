@@ -0,0 +1,86 @@
+#include "ResponseLayout.h"
+#include "magic8ball.h"
+
+static uint8_t measureSlice(U8G2 &display, const char *text, uint8_t offset, uint8_t length) {
+    char slice[LAYOUT_MAX_LINE_CHARS + 1];
+    memcpy(slice, text + offset, length);
+    slice[length] = '\0';
+    return display.getStrWidth(slice);
+}
+
+// Greedy word wrap: break at the last space that fits on the first line,
+// or hard-break a single long word. Returns the length of the first line and
+// sets where the second one starts; only called for text over one line.
+static uint8_t breakFirstLine(const char *text, uint8_t &secondOffset) {
+    int breakAt = LAYOUT_MAX_LINE_CHARS;
+    while (breakAt > 0 && text[breakAt] != ' ') {
+        breakAt--;
+    }
+    if (breakAt > 0) {
+        secondOffset = breakAt + 1;
+        return breakAt;
+    }
+    secondOffset = LAYOUT_MAX_LINE_CHARS;
+    return LAYOUT_MAX_LINE_CHARS;
+}
+
+bool responseFits(const char *text, size_t length) {
+    if (length <= LAYOUT_MAX_LINE_CHARS) {
+        return true;
+    }
+    uint8_t secondOffset;
+    breakFirstLine(text, secondOffset);
+    return length - secondOffset <= LAYOUT_MAX_LINE_CHARS;
+}
+
+void layoutResponse(U8G2 &display, const char *text, ResponseLayout &layout) {
+    size_t length = strlen(text);
+    
+    layout.lines[0].offset = 0;
+    layout.lines[1].offset = 0;
+    layout.lines[1].length = 0;
+    if (length <= LAYOUT_MAX_LINE_CHARS) {
+        layout.lineCount = 1;
+        layout.lines[0].length = length;
+    } else {
+        layout.lineCount = 2;
+        layout.lines[0].length = breakFirstLine(text, layout.lines[1].offset);
+        
+        size_t rest = length - layout.lines[1].offset;
+        layout.lines[1].length = rest > LAYOUT_MAX_LINE_CHARS ? LAYOUT_MAX_LINE_CHARS : rest;
+    }
+    
+    // Each reveal step shows a growing share of all characters, filling the
+    // first line before the second; every partial line is centred on its own
+    int totalChars = 0;
+    for (uint8_t line = 0; line < layout.lineCount; line++) {
+        totalChars += layout.lines[line].length;
+    }
+    
+    for (uint8_t step = 0; step < LAYOUT_REVEAL_STEPS; step++) {
+        int remaining = (step + 1) * totalChars / LAYOUT_REVEAL_STEPS;
+        for (uint8_t line = 0; line < LAYOUT_MAX_LINES; line++) {
+            uint8_t shown = 0;
+            if (line < layout.lineCount) {
+                shown = remaining < layout.lines[line].length ? remaining : layout.lines[line].length;
+                remaining -= shown;
+            }
+            uint8_t width = measureSlice(display, text, layout.lines[line].offset, shown);
+            layout.revealLength[step][line] = shown;
+            layout.revealX[step][line] = (SCREEN_WIDTH - width) / 2;
+        }
+    }
+}
+
+void drawResponseLine(U8G2 &display, const char *text, const ResponseLayout &layout,
+                      uint8_t step, uint8_t line, int y) {
+    uint8_t shown = layout.revealLength[step][line];
+    if (shown == 0) {
+        return;
+    }
+    
+    char slice[LAYOUT_MAX_LINE_CHARS + 1];
+    memcpy(slice, text + layout.lines[line].offset, shown);
+    slice[shown] = '\0';
+    display.drawStr(layout.revealX[step][line], y, slice);
+}
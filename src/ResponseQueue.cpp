@@ -0,0 +1,40 @@
+#include "ResponseQueue.h"
+
+ResponseQueue::ResponseQueue() {
+    head = 0;
+    count = 0;
+    maxDepth = 0;
+    enqueued = 0;
+    dropped = 0;
+    stale = 0;
+}
+
+void ResponseQueue::push(const ResponseEvent &event) {
+    if (count == RESPONSE_QUEUE_SIZE) {
+        // Newest answers matter most; make room by dropping the oldest
+        head = (head + 1) % RESPONSE_QUEUE_SIZE;
+        count--;
+        dropped++;
+    }
+    
+    events[(head + count) % RESPONSE_QUEUE_SIZE] = event;
+    count++;
+    enqueued++;
+    if (count > maxDepth) {
+        maxDepth = count;
+    }
+}
+
+bool ResponseQueue::pop(ResponseEvent &event, unsigned long now) {
+    while (count > 0) {
+        event = events[head];
+        head = (head + 1) % RESPONSE_QUEUE_SIZE;
+        count--;
+        
+        if (now - event.queuedAt <= RESPONSE_EVENT_MAX_AGE) {
+            return true;
+        }
+        stale++;
+    }
+    return false;
+}
@@ -0,0 +1,75 @@
+#include "SpriteCache.h"
+
+// Where (int)(2 * sin(phase)) changes value within the 2000ms pulse cycle
+struct PulseBreakpoint {
+    uint16_t startMs;
+    int8_t offset;
+};
+
+static const PulseBreakpoint pulseBreakpoints[] PROGMEM = {
+    {0, 0}, {167, 1}, {500, 2}, {501, 1}, {834, 0},
+    {1167, -1}, {1500, -2}, {1501, -1}, {1834, 0}
+};
+
+int pulseRadiusOffset(unsigned long timeMs) {
+    uint16_t phase = timeMs % 2000;
+    int offset = 0;
+    for (size_t i = 0; i < sizeof(pulseBreakpoints) / sizeof(pulseBreakpoints[0]); i++) {
+        if (phase < pgm_read_word(&pulseBreakpoints[i].startMs)) {
+            break;
+        }
+        offset = (int8_t)pgm_read_byte(&pulseBreakpoints[i].offset);
+    }
+    return offset;
+}
+
+BallSpriteCache::BallSpriteCache() {
+    built = false;
+    uint16_t offset = 0;
+    for (int i = 0; i < BALL_SPRITE_COUNT; i++) {
+        offsets[i] = offset;
+        offset += BALL_SPRITE_BYTES(BALL_SPRITE_MIN_RADIUS + i);
+    }
+}
+
+void BallSpriteCache::build(U8G2 &display, RasterizeFunction rasterize) {
+    const uint8_t *buffer = display.getBufferPtr();
+    uint16_t bufferWidth = display.getBufferTileWidth() * 8;
+    
+    for (int i = 0; i < BALL_SPRITE_COUNT; i++) {
+        int radius = BALL_SPRITE_MIN_RADIUS + i;
+        int side = BALL_SPRITE_SIDE(radius);
+        int rowBytes = (side + 7) / 8;
+        uint8_t *sprite = pool + offsets[i];
+        
+        // Render at the top-left corner so the bounding box starts at (0, 0)
+        display.clearBuffer();
+        rasterize(radius, radius, radius, 0);
+        
+        // Buffer: vertical bytes per page; XBM: horizontal rows, LSB first
+        memset(sprite, 0, BALL_SPRITE_BYTES(radius));
+        for (int y = 0; y < side; y++) {
+            const uint8_t *page = buffer + (y / 8) * bufferWidth;
+            uint8_t bit = 1 << (y % 8);
+            for (int x = 0; x < side; x++) {
+                if (page[x] & bit) {
+                    sprite[y * rowBytes + x / 8] |= 1 << (x % 8);
+                }
+            }
+        }
+    }
+    
+    display.clearBuffer();
+    built = true;
+}
+
+bool BallSpriteCache::draw(U8G2 &display, int centerX, int centerY, int radius) const {
+    if (!built || radius < BALL_SPRITE_MIN_RADIUS || radius > BALL_SPRITE_MAX_RADIUS) {
+        return false;
+    }
+    
+    int index = radius - BALL_SPRITE_MIN_RADIUS;
+    int side = BALL_SPRITE_SIDE(radius);
+    display.drawXBM(centerX - radius, centerY - radius, side, side, pool + offsets[index]);
+    return true;
+}
@@ -0,0 +1,269 @@
+#include "TraceRecorder.h"
+
+static void writeU16(uint8_t *bytes, uint16_t value) {
+    bytes[0] = value & 0xFF;
+    bytes[1] = value >> 8;
+}
+
+static void writeU32(uint8_t *bytes, uint32_t value) {
+    writeU16(bytes, value & 0xFFFF);
+    writeU16(bytes + 2, value >> 16);
+}
+
+static uint32_t readU32(const uint8_t *bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+           ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+TraceRecorder::TraceRecorder() {
+    ready = false;
+    state = TRACE_IDLE;
+    autoMode = false;
+    range = MPU6050_DEFAULT_RANGE;
+    stopAt = 0;
+    fillIndex = 0;
+    fillCount = 0;
+    pending[0] = pending[1] = false;
+    lastSampleTime = 0;
+    nextFlags = 0;
+    pretriggerHead = 0;
+    pretriggerCount = 0;
+    nextSequence = 0;
+    nextBlock = 0;
+    storedBlocks = 0;
+    sampleCount = 0;
+    droppedCount = 0;
+    writeErrors = 0;
+}
+
+bool TraceRecorder::begin(uint8_t accelRange) {
+    range = accelRange;
+    ready = LittleFS.begin();
+    if (!ready) {
+        return false;
+    }
+
+    if (!LittleFS.exists(TRACE_PATH)) {
+        File created = LittleFS.open(TRACE_PATH, "w");
+        created.close();
+    }
+    file = LittleFS.open(TRACE_PATH, "r+");
+    if (!file) {
+        ready = false;
+        return false;
+    }
+
+    // The newest block (highest sequence) tells where the ring continues
+    storedBlocks = min((size_t)TRACE_FILE_BLOCKS, file.size() / TRACE_BLOCK_SIZE);
+    uint16_t newest = 0;
+    bool found = false;
+    for (uint16_t i = 0; i < storedBlocks; i++) {
+        uint8_t header[TRACE_BLOCK_HEADER_SIZE];
+        file.seek((uint32_t)i * TRACE_BLOCK_SIZE);
+        if (file.read(header, sizeof(header)) != sizeof(header) ||
+            memcmp(header, TRACE_MAGIC, 4) != 0) {
+            continue;
+        }
+        uint32_t sequence = readU32(header + 4);
+        if (!found || sequence >= nextSequence) {
+            nextSequence = sequence + 1;
+            newest = i;
+            found = true;
+        }
+    }
+    nextBlock = storedBlocks < TRACE_FILE_BLOCKS ? storedBlocks : (newest + 1) % TRACE_FILE_BLOCKS;
+
+    Serial.print("Trace recorder: ");
+    Serial.print(storedBlocks);
+    Serial.print(" of ");
+    Serial.print(TRACE_FILE_BLOCKS);
+    Serial.println(" blocks stored");
+    return true;
+}
+
+void TraceRecorder::start(unsigned long durationMs, unsigned long now) {
+    if (!ready) {
+        return;
+    }
+
+    stopAt = now + min(durationMs, (unsigned long)TRACE_MAX_MS);
+    if (state == TRACE_RECORDING) {
+        return;
+    }
+
+    // Starting while armed keeps the samples leading up to it
+    bool armed = state == TRACE_ARMED;
+    state = TRACE_RECORDING;
+    nextFlags |= TRACE_FLAG_START;
+    if (armed) {
+        for (uint8_t i = 0; i < pretriggerCount; i++) {
+            const PretriggerSample &entry =
+                pretrigger[(pretriggerHead + TRACE_PRETRIGGER_SAMPLES - pretriggerCount + i) % TRACE_PRETRIGGER_SAMPLES];
+            stage(entry.sample, entry.time);
+        }
+    }
+    pretriggerCount = 0;
+}
+
+void TraceRecorder::stop() {
+    closeBlock();
+    state = autoMode ? TRACE_ARMED : TRACE_IDLE;
+    pretriggerCount = 0;
+}
+
+void TraceRecorder::setAuto(bool enabled) {
+    autoMode = enabled && ready;
+    if (state != TRACE_RECORDING) {
+        state = autoMode ? TRACE_ARMED : TRACE_IDLE;
+        pretriggerCount = 0;
+    }
+}
+
+void TraceRecorder::clear() {
+    if (!ready) {
+        return;
+    }
+
+    // Sequence numbers keep counting up, so old downloads never look newer
+    state = autoMode ? TRACE_ARMED : TRACE_IDLE;
+    fillCount = 0;
+    pending[0] = pending[1] = false;
+    pretriggerCount = 0;
+    file.close();
+    LittleFS.remove(TRACE_PATH);
+    File created = LittleFS.open(TRACE_PATH, "w");
+    created.close();
+    file = LittleFS.open(TRACE_PATH, "r+");
+    nextBlock = 0;
+    storedBlocks = 0;
+}
+
+void TraceRecorder::addSample(const AccelSample &sample, unsigned long sampleTime) {
+    if (state == TRACE_RECORDING) {
+        stage(sample, sampleTime);
+    } else if (state == TRACE_ARMED) {
+        PretriggerSample &entry = pretrigger[pretriggerHead];
+        entry.sample = sample;
+        entry.time = sampleTime;
+        pretriggerHead = (pretriggerHead + 1) % TRACE_PRETRIGGER_SAMPLES;
+        if (pretriggerCount < TRACE_PRETRIGGER_SAMPLES) {
+            pretriggerCount++;
+        }
+    }
+}
+
+void TraceRecorder::trigger(unsigned long sampleTime) {
+    if (state == TRACE_ARMED) {
+        start(TRACE_POSTTRIGGER_MS, sampleTime);
+    } else if (state == TRACE_RECORDING && autoMode &&
+               (long)(sampleTime + TRACE_POSTTRIGGER_MS - stopAt) > 0) {
+        stopAt = sampleTime + TRACE_POSTTRIGGER_MS;
+    }
+
+    if (state == TRACE_RECORDING) {
+        if (fillCount > 0) {
+            staging[fillIndex][15] |= TRACE_FLAG_SHAKE;
+        } else {
+            nextFlags |= TRACE_FLAG_SHAKE;
+        }
+    }
+}
+
+void TraceRecorder::service(unsigned long now) {
+    if (state == TRACE_RECORDING && (long)(now - stopAt) >= 0) {
+        stop();
+        Serial.print("Trace: recording stopped, ");
+        Serial.print(storedBlocks);
+        Serial.println(" blocks stored");
+    }
+
+    // With both pending, the one that fills next is the older
+    for (uint8_t n = 0; n < 2; n++) {
+        uint8_t index = fillIndex ^ n;
+        if (pending[index]) {
+            writeBlock(staging[index]);
+            pending[index] = false;
+        }
+    }
+}
+
+void TraceRecorder::stage(const AccelSample &sample, unsigned long sampleTime) {
+    // Deltas are 16-bit; a longer pause (sensor asleep) starts a new block
+    if (fillCount > 0 && sampleTime - lastSampleTime > 0xFFFF) {
+        closeBlock();
+    }
+    if (fillCount == 0) {
+        if (pending[fillIndex]) {
+            // Both blocks waiting for flash
+            droppedCount++;
+            nextFlags |= TRACE_FLAG_GAP;
+            return;
+        }
+        openBlock(sampleTime);
+    }
+
+    uint8_t *block = staging[fillIndex];
+    uint8_t *entry = block + TRACE_BLOCK_HEADER_SIZE + fillCount * TRACE_SAMPLE_SIZE;
+    writeU16(entry, fillCount > 0 ? sampleTime - lastSampleTime : 0);
+    writeU16(entry + 2, sample.x);
+    writeU16(entry + 4, sample.y);
+    writeU16(entry + 6, sample.z);
+    block[14] = ++fillCount;
+    lastSampleTime = sampleTime;
+    sampleCount++;
+
+    if (fillCount == TRACE_BLOCK_SAMPLES) {
+        closeBlock();
+    }
+}
+
+void TraceRecorder::openBlock(unsigned long sampleTime) {
+    uint8_t *block = staging[fillIndex];
+    memset(block, 0, TRACE_BLOCK_SIZE);
+    memcpy(block, TRACE_MAGIC, 4);
+    writeU32(block + 4, nextSequence++);
+    writeU32(block + 8, sampleTime);
+    block[12] = TRACE_VERSION;
+    block[13] = range;
+    block[15] = nextFlags;
+    nextFlags = 0;
+}
+
+void TraceRecorder::closeBlock() {
+    if (fillCount == 0) {
+        return;
+    }
+    pending[fillIndex] = true;
+    fillIndex ^= 1;
+    fillCount = 0;
+}
+
+void TraceRecorder::writeBlock(uint8_t *block) {
+    file.seek((uint32_t)nextBlock * TRACE_BLOCK_SIZE);
+    if (file.write(block, TRACE_BLOCK_SIZE) != TRACE_BLOCK_SIZE) {
+        writeErrors++;
+        return;
+    }
+    file.flush();
+
+    nextBlock = (nextBlock + 1) % TRACE_FILE_BLOCKS;
+    if (storedBlocks < TRACE_FILE_BLOCKS) {
+        storedBlocks++;
+    }
+}
+
+void TraceRecorder::exportBlocks(void (*emit)(const char *text, size_t length)) {
+    if (!ready) {
+        return;
+    }
+
+    static uint8_t block[TRACE_BLOCK_SIZE];
+    uint16_t first = storedBlocks < TRACE_FILE_BLOCKS ? 0 : nextBlock;
+    for (uint16_t n = 0; n < storedBlocks; n++) {
+        file.seek((uint32_t)((first + n) % TRACE_FILE_BLOCKS) * TRACE_BLOCK_SIZE);
+        if (file.read(block, sizeof(block)) != sizeof(block)) {
+            break;
+        }
+        emit((const char*)block, sizeof(block));
+    }
+}
@@ -1,19 +1,47 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include <SoftwareSerial.h>
-#include <DFRobotDFPlayerMini.h>
 #include <ESP8266WiFi.h>
 #include <ESP8266WebServer.h>
 #include "magic8ball.h"
 #include "MPU6050_Raw.h"
 #include "wifi_config.h"
+#include "benchmarks.h"
+#include "AnimationTimeline.h"
+#include "DisplayFlush.h"
+#include "I2CBus.h"
+#include "SpriteCache.h"
+#include "ResponseLayout.h"
+#include "web_index.h"
+#include "ResponseQueue.h"
+#include "LatencyHistogram.h"
+#include "EventStream.h"
+#include "Metrics.h"
+#include "Profiler.h"
+#include "DeviceMap.h"
+#include "DFPlayerQueue.h"
+#include "PowerManager.h"
+#include "ResponseCatalog.h"
+#include "TraceRecorder.h"
 
 // Initialize SH1106 display object
 U8G2_SH1106_128X64_NONAME_F_HW_I2C display(U8G2_R0, /* reset=*/ U8X8_PIN_NONE);
 
-// DFPlayer Mini setup - Using D0 and D3 pins (GPIO16, GPIO0)
-SoftwareSerial mySoftwareSerial(D0, D3); // RX=D0(GPIO16), TX=D3(GPIO0)
-DFRobotDFPlayerMini myDFPlayer;
+// Sends only the 8x8 tiles that changed since the last frame
+TileFlusher displayFlusher(display);
+unsigned long frameStart = 0;     // micros() at beginFrame()
+unsigned long frameMaxMicros = 0; // Worst render + flush since the last report
+uint32_t framesOverBudgetReported = 0;
+
+// 8-ball bitmaps rendered once at boot
+BallSpriteCache ballSprites;
+
+// DFPlayer Mini setup - Using D0 and D3 pins (GPIO16, GPIO0), see DFPLAYER_RX_PIN
+SoftwareSerial mySoftwareSerial(DFPLAYER_RX_PIN, DFPLAYER_TX_PIN);
+DFPlayerQueue dfplayer;
+
+bool dfplayerReady = false; // Set once bootDFPlayer() has configured it
+bool bootComplete = false;
 
 // Magic 8-ball responses
 const char* responses[] = {
@@ -41,16 +69,51 @@ const char* responses[] = {
 
 const int numResponses = sizeof(responses) / sizeof(responses[0]);
 
+// Answer sets on LittleFS; responses[] is used when none is selected
+ResponseCatalog responseCatalog;
+LatencyHistogram catalogLookup; // getEntry() time, us
+File catalogUpload;
+
+// Raw accelerometer recordings on LittleFS, downloaded from /trace.bin
+TraceRecorder traceRecorder;
+
 // Global variables
 MPU6050_Raw mpu(MPU6050_ALT_ADDR); // Use alternate address 0x69
-float shakeThreshold = 1.5; // Threshold in g
-bool isShaking = false;
+GestureEngine gestureEngine;
+FlipDetector flipDetector;
 bool responseShown = false;
 unsigned long lastShakeTime = 0;
 unsigned long responseDisplayTime = 0;
 const unsigned long responseDisplayDuration = 3000;
 unsigned long welcomeAnimationTime = 0;
 
+// Answers waiting for the display and speaker, from any source
+ResponseQueue responseQueue;
+const char* const responseSourceNames[] = { "shake", "button", "web", "flip" };
+
+// Worst-case loop() work time over the current stats interval
+unsigned long loopMaxMicros = 0;
+unsigned long loopStatsStart = 0;
+
+// Power state (see updatePowerState)
+PowerManager powerManager;
+bool accessPointOn = false;
+bool displayAsleep = false;
+bool dfplayerAsleep = false;
+
+// Motion wake-up state (see initializeMotionWake)
+bool motionWakeEnabled = false;
+volatile bool motionEventPending = false;
+unsigned long motionActiveUntil = 0;
+bool motionWindowOpen = false;
+bool motionWindowHadShake = false;
+uint32_t motionWakeCount = 0;
+uint32_t motionFalseTriggerCount = 0;
+
+// Set by the detectors, which can run inside a display flush; the answer is
+// started from handleShakeDetection() once the frame is out
+bool shakePending = false;
+
 // WiFi Access Point settings
 const char* ap_ssid = WIFI_AP_SSID;
 const char* ap_password = WIFI_AP_PASSWORD;
@@ -63,51 +126,97 @@ ESP8266WebServer server(WEB_SERVER_PORT);
 
 // WiFi status variables
 bool wifiEnabled = ENABLE_WIFI;
-String lastWebResponse = "";
+bool webServerStarted = false;
+const char* lastWebResponse = ""; // Points into responses[] or lastWebResponseText
+char lastWebResponseText[CATALOG_MAX_ENTRY_LENGTH + 1];
 unsigned long lastWebResponseTime = 0;
+uint32_t webBytesSent = 0;         // Response bodies served
+uint32_t webNotModifiedCount = 0;  // Page requests answered with 304
+uint32_t minFreeHeap = 0xFFFFFFFF; // Lowest free heap seen
+LatencyHistogram askLatency;       // /ask request to reply sent, us
+EventStream eventStream;           // Live answers (and accel) for open pages
 
-void scanI2CForDisplay() {
-  Serial.println("Scanning I2C for OLED display...");
-  
-  for (byte address = 1; address < 127; address++) {
-    Wire.beginTransmission(address);
-    byte error = Wire.endTransmission();
-    
-    if (error == 0) {
-      Serial.print("I2C device found at address 0x");
-      Serial.print(address, HEX);
-      if (address == 0x3C) Serial.print(" (SH1106/SSD1306 - common address)");
-      if (address == 0x3D) Serial.print(" (SH1106/SSD1306 - alternate address)");
-      Serial.println();
-    }
+// Exported at /metrics (see registerMetrics)
+enum HttpHandlerId { HANDLER_ROOT, HANDLER_STATUS, HANDLER_ASK, HANDLER_EVENTS, HANDLER_METRICS, HANDLER_CATALOG, HANDLER_FRAME, HANDLER_TRACE, HANDLER_NOT_FOUND, HANDLER_COUNT };
+MetricCounter httpRequests[HANDLER_COUNT];
+LatencyHistogram loopDuration;
+LatencyHistogram shakeDetectionDuration;
+LatencyHistogram displayFlushDuration;
+LatencyHistogram displayRenderDuration;
+MetricCounter displayBytes, framesOverBudget;
+MetricCounter dfplayerCommands, dfplayerTimeouts, dfplayerErrors, dfplayerFinished;
+MetricCounter mpuTransactions, mpuErrors, displayTransactions, displayErrors;
+MetricCounter mpuNacks, mpuTimeouts, mpuRecoveries, displayNacks, displayTimeouts, displayRecoveries;
+MetricCounter sensorReadErrors;
+MetricCounter shakesDetected, flipsDetected, answersQueued, answersDropped, answersStale;
+MetricCounter sseEvents, sseSlowClients, sseDroppedEvents;
+MetricCounter traceSamples, traceDropped;
+MetricGauge queueDepth, sseListeners, wifiStations;
+MetricGauge heapFree, heapMinFree, heapMaxBlock, heapFragmentation;
+MetricCounter powerStateSeconds[POWER_STATE_COUNT];
+MetricGauge powerState, powerMilliAmps, powerAverageMilliAmps;
+
+void beginFrame() {
+  frameStart = micros();
+  display.clearBuffer();
+}
+
+void flushDisplay() {
+  PROFILE_ZONE("sendBuffer");
+  unsigned long start = micros();
+  uint16_t bytes = displayFlusher.flush();
+  unsigned long flushMicros = micros() - start;
+  displayFlushDuration.record(flushMicros);
+  displayBytes.inc(bytes);
+  
+  // Drawing since beginFrame() plus the transfer; a frame over budget
+  // holds up shake sampling and the web server
+  unsigned long renderMicros = start - frameStart;
+  displayRenderDuration.record(renderMicros);
+  if (renderMicros + flushMicros > FRAME_BUDGET_US || bytes > FRAME_BUDGET_BYTES) {
+    framesOverBudget.inc();
+  }
+  if (renderMicros + flushMicros > frameMaxMicros) {
+    frameMaxMicros = renderMicros + flushMicros;
   }
 }
 
 void initializeDisplay() {
-  // Scan for I2C devices first
-  scanI2CForDisplay();
-  
   Serial.println("Initializing SH1106 display...");
+  if (!deviceMap.has(SCREEN_ADDRESS)) {
+    Serial.println("   No device at 0x3C - check the display wiring");
+  }
+  
+  // Join the shared bus; U8g2 applies its bus clock on every transfer
+  int8_t busClient = i2cBus.registerClient("SH1106", SCREEN_ADDRESS, SH1106_MAX_CLOCK);
+  displayFlusher.setBusClient(busClient);
+  display.setBusClock(SH1106_MAX_CLOCK);
   
   // Initialize U8g2 display
+  i2cBus.beginExternal(busClient);
   display.begin();
-  display.clearBuffer();
-  display.sendBuffer();
+  i2cBus.endExternal(busClient, true);
+  
+  // Sprites only set their own pixels, like the shapes they replace
+  display.setBitmapMode(1);
+  ballSprites.build(display, rasterize8Ball);
+  Serial.print("8-ball sprite cache: ");
+  Serial.print(ballSprites.getMemoryUsage());
+  Serial.println(" bytes");
+  buildResponseLayouts();
   
   Serial.println("SH1106 Display initialized successfully!");
-    // Test pattern to verify display is working
-  Serial.println("Displaying startup message...");
-  display.clearBuffer();
-  display.setFont(u8g2_font_6x10_tf);
-  display.drawStr(0, 15, "Starting the");
-  display.drawStr(0, 30, "Magic 8 Ball...");
-  display.drawStr(0, 45, "Please wait");
-  display.drawStr(0, 60, "while loading");
-  display.sendBuffer();
-  delay(3000);
 }
 
 void draw8Ball(int centerX, int centerY, int radius, int shakeOffset) {
+  PROFILE_ZONE("draw8Ball");
+  // Blit the pre-rendered sprite; rasterise only radii that are not cached
+  if (!ballSprites.draw(display, centerX + shakeOffset, centerY + shakeOffset, radius)) {
+    rasterize8Ball(centerX, centerY, radius, shakeOffset);
+  }
+}
+
+void rasterize8Ball(int centerX, int centerY, int radius, int shakeOffset) {
   // Draw the outer black circle (8-ball body)
   display.drawCircle(centerX + shakeOffset, centerY + shakeOffset, radius);
   display.drawCircle(centerX + shakeOffset, centerY + shakeOffset, radius - 1);
@@ -126,7 +235,7 @@ void draw8Ball(int centerX, int centerY, int radius, int shakeOffset) {
 }
 
 void displayText(const char* text, bool center) {
-  display.clearBuffer();
+  beginFrame();
   display.setFont(u8g2_font_6x10_tf);
   
   if (center) {
@@ -139,104 +248,130 @@ void displayText(const char* text, bool center) {
     display.drawStr(0, 15, text);
   }
   
-  display.sendBuffer();
+  flushDisplay();
 }
 
-void displayMagic8BallResponse(const char* response) {
-  // Animation sequence: shake effect, then reveal response
+// Response animation: 6 shake frames (200ms), 3 reveal frames (300ms), final frame
+const uint16_t responseFrameDurations[RESPONSE_FRAME_COUNT] = {
+  200, 200, 200, 200, 200, 200, 300, 300, 300, 0
+};
+AnimationTimeline responseTimeline;
+const char* animationResponse = "";
+ResponseLayout animationLayout;
+
+// Word-wrap and centering for every response, computed once at startup
+ResponseLayout responseLayouts[sizeof(responses) / sizeof(responses[0])];
+const char* const thinkingTexts[4] = { "Thinking", "Thinking.", "Thinking..", "Thinking..." };
+uint8_t thinkingX[4];
+
+// Welcome screen: one looping frame, redrawn every WELCOME_FRAME_INTERVAL ms
+uint16_t welcomeFrameDurations[1] = { WELCOME_FRAME_INTERVAL }; // Slower when idle
+AnimationTimeline welcomeTimeline;
+
+// Draws into the buffer only; the caller clears it first and flushes it
+// (or exports it off-screen) after
+void renderResponseFrame(const char* response, const ResponseLayout& layout, int frame) {
+  display.setFont(u8g2_font_6x10_tf);
   
-  // Shake animation (6 frames)
-  for (int shake = 0; shake < 6; shake++) {
-    display.clearBuffer();
+  if (frame < RESPONSE_SHAKE_FRAMES) {
+    // Shake animation
+    int shake = frame;
     
     // Draw shaking 8-ball
     int shakeOffset = (shake % 2 == 0) ? -2 : 2;
     draw8Ball(SCREEN_WIDTH/2, 30, 18, shakeOffset);
     
     // Draw "Thinking..." text with dots animation
-    display.setFont(u8g2_font_6x10_tf);
-    String thinkingText = "Thinking";
-    for (int i = 0; i < (shake % 4); i++) {
-      thinkingText += ".";
+    int dots = shake % 4;
+    display.drawStr(thinkingX[dots], 58, thinkingTexts[dots]);
+  } else {
+    // Fade-in effect for the response (by showing more of it each frame);
+    // the last frame is the final display with the complete response
+    int step = frame - RESPONSE_SHAKE_FRAMES;
+    if (step >= LAYOUT_REVEAL_STEPS) {
+      step = LAYOUT_REVEAL_STEPS - 1;
     }
-    int textWidth = display.getStrWidth(thinkingText.c_str());
-    display.drawStr((SCREEN_WIDTH - textWidth) / 2, 58, thinkingText.c_str());
-    
-    display.sendBuffer();
-    delay(200);
-  }
-  
-  // Fade-in effect for the response
-  for (int fade = 0; fade < 3; fade++) {
-    display.clearBuffer();
-      // Draw static 8-ball
-    draw8Ball(SCREEN_WIDTH/2, 30, 18, 0);
     
-    // Display the response with fade effect (by showing more of it each frame)
-    display.setFont(u8g2_font_6x10_tf);
-    String responseStr = String(response);
-    int maxCharsPerLine = 21;
-      if ((int)responseStr.length() > maxCharsPerLine) {
-      String line = responseStr.substring(0, maxCharsPerLine);
-      int lastSpace = line.lastIndexOf(' ');
-      if (lastSpace > 0 && lastSpace < maxCharsPerLine - 3) {
-        line = line.substring(0, lastSpace) + "...";
-      }
-      
-      // Show characters progressively during fade
-      int totalChars = (int)line.length();
-      int charsToShow = (fade + 1) * totalChars / 3;
-      if (charsToShow > totalChars) charsToShow = totalChars;
-      String fadeText = line.substring(0, charsToShow);
-      
-      int textWidth = display.getStrWidth(fadeText.c_str());
-      display.drawStr((SCREEN_WIDTH - textWidth) / 2, 58, fadeText.c_str());
+    if (layout.lineCount == 1) {
+      draw8Ball(SCREEN_WIDTH/2, 30, 18, 0);
+      drawResponseLine(display, response, layout, step, 0, 58);
     } else {
-      // Show characters progressively during fade
-      int totalChars = (int)responseStr.length();
-      int charsToShow = (fade + 1) * totalChars / 3;
-      if (charsToShow > totalChars) charsToShow = totalChars;
-      String fadeText = responseStr.substring(0, charsToShow);
-      
-      int textWidth = display.getStrWidth(fadeText.c_str());
-      display.drawStr((SCREEN_WIDTH - textWidth) / 2, 58, fadeText.c_str());
+      // Raise the ball to make room for a second line
+      draw8Ball(SCREEN_WIDTH/2, 20, 18, 0);
+      drawResponseLine(display, response, layout, step, 0, 50);
+      drawResponseLine(display, response, layout, step, 1, 61);
     }
-    
-    display.sendBuffer();
-    delay(300);
   }
-    // Final display - show complete response
-  display.clearBuffer();
-  draw8Ball(SCREEN_WIDTH/2, 30, 18, 0);
-  
+}
+
+void drawResponseFrame(const char* response, const ResponseLayout& layout, int frame) {
+  beginFrame();
+  renderResponseFrame(response, layout, frame);
+  flushDisplay();
+}
+
+void buildResponseLayouts() {
+  // Measure everything the response animation draws once, up front
   display.setFont(u8g2_font_6x10_tf);
-  String responseStr = String(response);
-  int maxCharsPerLine = 21;
-  
-  if ((int)responseStr.length() > maxCharsPerLine) {
-    String line = responseStr.substring(0, maxCharsPerLine);
-    int lastSpace = line.lastIndexOf(' ');
-    if (lastSpace > 0 && lastSpace < maxCharsPerLine - 3) {
-      line = line.substring(0, lastSpace) + "...";
+  for (int i = 0; i < numResponses; i++) {
+    layoutResponse(display, responses[i], responseLayouts[i]);
+  }
+  for (int dots = 0; dots < 4; dots++) {
+    thinkingX[dots] = (SCREEN_WIDTH - display.getStrWidth(thinkingTexts[dots])) / 2;
+  }
+}
+
+void displayMagic8BallResponse(const char* response) {
+  // Starts the animation; updateDisplayAnimation() draws it from loop()
+  animationResponse = response;
+  
+  // Built-in responses use the precomputed table; anything else is laid out once here
+  bool found = false;
+  for (int i = 0; i < numResponses && !found; i++) {
+    if (responses[i] == response) {
+      animationLayout = responseLayouts[i];
+      found = true;
     }
-    int textWidth = display.getStrWidth(line.c_str());
-    display.drawStr((SCREEN_WIDTH - textWidth) / 2, 58, line.c_str());
-  } else {
-    int textWidth = display.getStrWidth(response);
-    display.drawStr((SCREEN_WIDTH - textWidth) / 2, 58, response);
+  }
+  if (!found) {
+    display.setFont(u8g2_font_6x10_tf);
+    layoutResponse(display, response, animationLayout);
+  }
+  
+  responseTimeline.start(responseFrameDurations, RESPONSE_FRAME_COUNT, millis());
+  welcomeTimeline.stop();
+}
+
+bool isResponseAnimating() {
+  return responseTimeline.isRunning();
+}
+
+void updateDisplayAnimation() {
+  unsigned long now = millis();
+  
+  if (responseTimeline.isRunning()) {
+    int frame = responseTimeline.update(now);
+    if (frame != ANIMATION_NO_FRAME) {
+      drawResponseFrame(animationResponse, animationLayout, frame);
+      if (!responseTimeline.isRunning()) {
+        // Hold the answer for responseDisplayDuration from when it appears
+        responseDisplayTime = millis();
+      }
+    }
+    return;
   }
   
-  display.sendBuffer();
+  // Show animated welcome screen when not showing response
+  displayAnimatedWelcome();
 }
 
 void displayWelcomeMessage() {
-  display.clearBuffer();
+  beginFrame();
   display.setFont(u8g2_font_6x10_tf);
   
   // Create a pulsing effect for the 8-ball
   unsigned long currentTime = millis();
-  float pulsePhase = (currentTime % 2000) / 2000.0 * 2 * PI; // 2 second cycle
-  int radiusVariation = (int)(2 * sin(pulsePhase)); // +/- 2 pixels
+  int radiusVariation = pulseRadiusOffset(currentTime); // +/- 2 pixels, 2 second cycle
   int baseRadius = 16;
   
   // Draw the 8-ball in the center-top area with pulsing effect
@@ -267,110 +402,162 @@ void displayWelcomeMessage() {
     display.drawStr((SCREEN_WIDTH - instructWidth) / 2, 56, "Shake to ask!");
   }
   
-  display.sendBuffer();
+  flushDisplay();
 }
 
 void displayAnimatedWelcome() {
   // Only show animated welcome when not showing a response
   if (!responseShown) {
-    displayWelcomeMessage();
+    unsigned long now = millis();
+    if (!welcomeTimeline.isRunning()) {
+      welcomeTimeline.start(welcomeFrameDurations, 1, now, true);
+    }
+    if (welcomeTimeline.update(now) != ANIMATION_NO_FRAME) {
+      displayWelcomeMessage();
+    }
+  }
+}
+
+uint16_t responseCount() {
+  return responseCatalog.isActive() ? responseCatalog.getEntryCount() : numResponses;
+}
+
+const char* lookupResponse(uint16_t index, char* buffer, size_t size) {
+  // Built-in answers need no copy; catalog entries are read into buffer
+  if (!responseCatalog.isActive()) {
+    return responses[index % numResponses];
   }
+  
+  unsigned long start = micros();
+  size_t length = responseCatalog.getEntry(index, buffer, size);
+  catalogLookup.record(micros() - start);
+  return length > 0 ? buffer : responses[index % numResponses];
 }
 
-void showRandomResponse() {
+size_t escapeJson(const char* text, char* out, size_t size) {
+  // Escape quotes and backslashes and drop control characters, for answers inside JSON
+  size_t length = 0;
+  for (; *text && length + 2 < size; text++) {
+    if (*text == '"' || *text == '\\') {
+      out[length++] = '\\';
+      out[length++] = *text;
+    } else if ((uint8_t)*text >= 0x20) {
+      out[length++] = *text;
+    }
+  }
+  out[length] = '\0';
+  return length;
+}
+
+void showRandomResponse(ResponseSource source) {
   randomSeed(millis());
-  int responseIndex = random(numResponses);
+  queueResponse(random(responseCount()), source);
+}
+
+void queueResponse(uint16_t responseIndex, ResponseSource source) {
+  // Shown by playQueuedResponse() once the display is free
+  ResponseEvent event;
+  event.responseIndex = responseIndex;
+  event.source = source;
+  event.queuedAt = millis();
+  responseQueue.push(event);
+  powerManager.noteActivity(event.queuedAt);
+  
+  // Every open page sees the answer, whoever asked
+  char text[CATALOG_MAX_ENTRY_LENGTH + 1];
+  char escaped[2 * CATALOG_MAX_ENTRY_LENGTH + 1];
+  escapeJson(lookupResponse(responseIndex, text, sizeof(text)), escaped, sizeof(escaped));
+  char data[EVENT_MAX_DATA_LENGTH + 1];
+  snprintf(data, sizeof(data), "{\"response\":\"%s\",\"source\":\"%s\"}",
+           escaped, responseSourceNames[source]);
+  eventStream.publish("answer", data);
+}
+
+void playQueuedResponse() {
+  // Let the current answer finish animating and stay readable for a moment
+  if (isResponseAnimating() || responseQueue.size() == 0) {
+    return;
+  }
+  if (responseShown && millis() - responseDisplayTime < RESPONSE_QUEUE_HOLD_MS) {
+    return;
+  }
+  
+  ResponseEvent event;
+  if (!responseQueue.pop(event, millis())) {
+    return;
+  }
+  // Stays valid for the whole animation; only one answer is shown at a time
+  static char displayedText[CATALOG_MAX_ENTRY_LENGTH + 1];
+  const char* response = lookupResponse(event.responseIndex, displayedText, sizeof(displayedText));
   
   // Display on Serial
   Serial.println();
   Serial.println("=== MAGIC 8-BALL RESPONSE ===");
   Serial.print(">> ");
-  Serial.print(responses[responseIndex]);
+  Serial.print(response);
   Serial.println(" <<");
+  Serial.print("(");
+  Serial.print(responseSourceNames[event.source]);
+  Serial.print(", queued ");
+  Serial.print(millis() - event.queuedAt);
+  Serial.println("ms)");
   Serial.println("=============================");
   Serial.println();
   
   // Display on OLED
-  displayMagic8BallResponse(responses[responseIndex]);
+  displayMagic8BallResponse(response);
+  responseShown = true;
+  responseDisplayTime = millis();
+  
+  // Play sound effect with the answer
+  playRandomSound();
 }
 
-void initializeDFPlayer() {
-  Serial.println("Initializing DFPlayer Mini...");
-  
-  // Initialize SoftwareSerial for DFPlayer communication
-  mySoftwareSerial.begin(9600);
-  delay(3000); // Give more time for module to stabilize
-  
-  Serial.println("Attempting DFPlayer connection...");
-  
-  // Try different initialization methods
-  bool success = false;
-  
-  // First try without acknowledgment (more reliable)
-  Serial.print("Attempt 1 (no ACK): ");
-  if (myDFPlayer.begin(mySoftwareSerial, false, false)) {
-    Serial.println("SUCCESS!");
-    success = true;
-  } else {
-    Serial.println("Failed");
-  }
-  
-  if (!success) {
-    Serial.print("Attempt 2 (with ACK): ");
-    if (myDFPlayer.begin(mySoftwareSerial, true, false)) {
-      Serial.println("SUCCESS!");
-      success = true;
-    } else {
-      Serial.println("Failed");
-    }
-  }
-  
-  if (!success) {
-    Serial.print("Attempt 3 (with reset): ");
-    if (myDFPlayer.begin(mySoftwareSerial, true, true)) {
-      Serial.println("SUCCESS!");
-      success = true;
-    } else {
-      Serial.println("Failed");
-    }
+bool bootDFPlayer(BootTask& task, unsigned long now) {
+  // The module has been powering up since reset, so the wait counts from boot
+  switch (task.state) {
+    case 0:
+      Serial.println("Initializing DFPlayer Mini...");
+      mySoftwareSerial.begin(9600);
+      task.resumeAt = DFPLAYER_POWERUP_MS;
+      break;
+      
+    case 1:
+      // Configuration goes out paced by ACKs if replies can be received,
+      // otherwise by time and the BUSY pin (see DFPlayerQueue)
+      dfplayer.begin(mySoftwareSerial, DFPLAYER_RX_WORKS, DFPLAYER_BUSY_PIN);
+      dfplayer.send(DFPLAYER_CMD_VOLUME, 20);      // Volume (0~30)
+      dfplayer.send(DFPLAYER_CMD_LOOP_ALL, 0);     // Disable loop all tracks
+      dfplayer.send(DFPLAYER_CMD_SINGLE_LOOP, 1);  // Disable loop current track
+      dfplayer.send(DFPLAYER_CMD_DAC, 1);          // Disable DAC output (if applicable)
+      dfplayer.send(DFPLAYER_CMD_EQ, DFPLAYER_EQ_NORMAL);
+      dfplayer.send(DFPLAYER_CMD_OUTPUT, DFPLAYER_DEVICE_SD); // Play from the SD card
+      break;
+      
+    default:
+      if (!dfplayer.isIdle()) {
+        return false;
+      }
+      Serial.print("DFPlayer Mini configured (");
+      Serial.print(dfplayer.getAckCount());
+      Serial.print(" ACKs, ");
+      Serial.print(dfplayer.getTimeoutCount());
+      Serial.println(" timeouts)");
+      dfplayerReady = true;
+      return true;
   }
   
-  // Even if begin() fails, the module might still work
-  // Let's try sending commands anyway since you see the light flashing
-  if (!success) {
-    Serial.println("DFPlayer begin() failed, but trying commands anyway...");
-    Serial.println("(Light flashing suggests module is responding)");
-  } else {
-    Serial.println("DFPlayer Mini online!");
-  }  // Give time before sending commands
-  delay(2000);
-  
-  // Set volume value (0~30) - start lower for testing
-  Serial.println("Setting volume...");
-  myDFPlayer.volume(20);
-  delay(1000);
-    // Configure playback mode to prevent auto-looping
-  Serial.println("Configuring single play mode...");
-  
-  // Set single cycle mode (play one track and stop)
-  myDFPlayer.disableLoopAll(); // Disable loop all tracks
-  myDFPlayer.disableLoop(); // Disable loop current track
-  myDFPlayer.disableDAC(); // Disable DAC output (if applicable)
-  delay(500);
-  
-  // Try to set single play mode using EQ setting trick
-  // Some DFPlayer modules use EQ settings to control play mode
-  myDFPlayer.EQ(DFPLAYER_EQ_NORMAL); // Reset to normal mode
-  delay(500);
-  
-  // Ensure we're using SD card as source
-  myDFPlayer.outputDevice(DFPLAYER_DEVICE_SD);
-  delay(500);
-  
-  Serial.println("DFPlayer initialization complete (may work despite errors)");
+  task.state++;
+  return false;
 }
 
 void playRandomSound() {
+  PROFILE_ZONE("playRandomSound");
+  if (!dfplayerReady) {
+    Serial.println("DFPlayer still starting - no sound");
+    return;
+  }
+  
   // Randomly choose between the two sound files
   // Files: 0001.mp3, 0002.mp3
   randomSeed(millis());
@@ -383,58 +570,247 @@ void playRandomSound() {
     Serial.println("0002.mp3");
   }
   
-  // Stop any currently playing audio first
-  myDFPlayer.stop();
-  delay(100);
-  
-  // Play the selected file
-  myDFPlayer.play(soundChoice);
+  // Replaces the sound in flight (or one still queued) without a stop first
+  dfplayer.play(soundChoice);
   
   // Note: File should stop automatically when finished
   // If it continues to next file, this indicates the DFPlayer 
   // is in repeat/loop mode which we try to prevent in initialization
 }
 
-void handleShakeDetection() {
-  if (mpu.isInitialized()) {
-    // Print accelerometer data for debugging
-    mpu.printAccelData();
+void IRAM_ATTR onMotionInterrupt() {
+  motionEventPending = true;
+}
+
+// An unwired INT line floats, and deep idle would then sleep forever waiting
+// for an edge. Check the pin follows the sensor: low once INT_STATUS is read,
+// high within a few samples of enabling the data-ready interrupt.
+bool motionPinConnected() {
+  mpu.setInterruptSources(0);
+  mpu.readInterruptStatus();
+  bool low = digitalRead(MPU_INT_PIN) == LOW;
+  
+  mpu.setInterruptSources(INT_ENABLE_DATA_RDY);
+  bool raised = false;
+  unsigned long start = millis();
+  while (low && !raised && millis() - start < MOTION_PIN_TEST_MS) {
+    delay(1);
+    raised = digitalRead(MPU_INT_PIN) == HIGH;
+  }
+  
+  mpu.setInterruptSources(INT_ENABLE_MOT);
+  mpu.readInterruptStatus();
+  return low && raised;
+}
+
+void initializeMotionWake() {
+  if (!ENABLE_MOTION_WAKE) {
+    return;
+  }
+  
+  pinMode(MPU_INT_PIN, INPUT);
+  if (!mpu.enableMotionInterrupt(MOTION_WAKE_THRESHOLD, MOTION_WAKE_DURATION)) {
+    Serial.println("   Motion wake-up unavailable - polling continuously");
+    return;
+  }
+  if (!motionPinConnected()) {
+    mpu.disableMotionInterrupt();
+    Serial.println("   MPU6050 INT not seen on D5 - check the wiring; polling continuously");
+    return;
+  }
+  
+  attachInterrupt(digitalPinToInterrupt(MPU_INT_PIN), onMotionInterrupt, RISING);
+  motionWakeEnabled = true;
+  Serial.println("   Motion wake-up enabled - sensor idle until moved");
+}
+
+bool motionWindowActive() {
+  // Without the interrupt, poll on every loop as before
+  if (!motionWakeEnabled) {
+    return true;
+  }
+  
+  if (motionEventPending) {
+    motionEventPending = false;
+    mpu.readInterruptStatus(); // Release the latched INT pin for the next edge
     
-    // Use accelerometer for shake detection
-    if (mpu.detectShake(shakeThreshold)) {
-      if (!isShaking && (millis() - lastShakeTime > 1000)) {
-        isShaking = true;
-        lastShakeTime = millis();
-        Serial.println("SHAKE DETECTED!");
-        showRandomResponse();
-        responseShown = true;
-        responseDisplayTime = millis();
-        
-        // Play sound effect on shake
-        playRandomSound();
+    if (!motionWindowOpen) {
+      motionWindowOpen = true;
+      motionWindowHadShake = false;
+      motionWakeCount++;
+      powerManager.noteActivity(millis());
+      // Samples buffered while idle are stale (and have likely overflowed)
+      mpu.resetFifo();
+      gestureEngine.reset();
+    }
+    motionActiveUntil = millis() + MOTION_ACTIVE_WINDOW;
+  }
+  
+  if (motionWindowOpen && (long)(millis() - motionActiveUntil) >= 0) {
+    motionWindowOpen = false;
+    if (!motionWindowHadShake) {
+      motionFalseTriggerCount++;
+    }
+  }
+  
+  return motionWindowOpen;
+}
+
+bool processShakeSample(const AccelSample &sample, unsigned long sampleTime) {
+  eventStream.publishAccel(sample, mpu.getAccelerometerRange());
+  traceRecorder.addSample(sample, sampleTime);
+  
+  if (!gestureEngine.update(sample)) {
+    return false;
+  }
+  
+  traceRecorder.trigger(sampleTime);
+  motionWindowHadShake = true;
+  lastShakeTime = millis();
+  shakePending = true;
+  return true;
+}
+
+void announceShake() {
+  // Catalog read, SSE publish and logging; kept out of the flush callback
+  shakePending = false;
+  Serial.print("SHAKE DETECTED! (energy=");
+  Serial.print(gestureEngine.getEnergyMilliG());
+  Serial.print("mg, reversals=");
+  Serial.print(gestureEngine.getDominantReversals());
+  Serial.print(", jerk=");
+  Serial.print(gestureEngine.getJerkMilliG());
+  Serial.println("mg)");
+  showRandomResponse(SOURCE_SHAKE);
+}
+
+unsigned long nextFifoSampleTime(unsigned long now) {
+  // The FIFO fills at a fixed rate, so samples are one period apart; the
+  // estimate is pulled back to millis() if it drifts (e.g. after a reset)
+  static unsigned long sampleTime = 0;
+  sampleTime += SHAKE_SAMPLE_PERIOD_MS;
+  if ((long)(sampleTime - now) > 0 || now - sampleTime > SHAKE_FIFO_RESYNC_MS) {
+    sampleTime = now;
+  }
+  return sampleTime;
+}
+
+void drainShakeFifo() {
+  // Also runs from the bus scheduler in the middle of display flushes, so
+  // it only feeds the detectors; a shake is announced after the frame
+  if (!mpu.isFifoEnabled() ||
+      (motionWakeEnabled && !motionWindowOpen && !traceRecorder.isRecording())) {
+    return;
+  }
+  
+  // Run detection over every sample buffered since the last call
+  static AccelSample samples[SHAKE_FIFO_BATCH];
+  size_t count;
+  while ((count = mpu.readFifo(samples, SHAKE_FIFO_BATCH)) > 0) {
+    // The gesture engine stays disarmed for the rest of a shake
+    unsigned long now = millis();
+    for (size_t i = 0; i < count; i++) {
+      processShakeSample(samples[i], nextFifoSampleTime(now));
+    }
+  }
+}
+
+bool processFlipSample(const MotionSample &sample) {
+  if (!flipDetector.update(sample, millis())) {
+    return false;
+  }
+  
+  motionWindowHadShake = true;
+  Serial.println("FLIP DETECTED!");
+  showRandomResponse(SOURCE_FLIP);
+  return true;
+}
+
+void reportSensorError() {
+  // The bus has already retried; log the cause without flooding serial
+  static unsigned long lastLog = 0;
+  static uint32_t unreported = 0;
+  sensorReadErrors.inc();
+  unreported++;
+  if (lastLog != 0 && millis() - lastLog < SENSOR_ERROR_LOG_MS) {
+    return;
+  }
+  lastLog = millis();
+  Serial.print("ERROR: MPU6050 read failed (");
+  Serial.print(I2CBus::statusName(mpu.getLastStatus()));
+  Serial.print("), ");
+  Serial.print(unreported);
+  Serial.println(" failures since last report");
+  unreported = 0;
+}
+
+void sampleShakeSensor() {
+  // Print accelerometer data for debugging
+  mpu.printAccelData();
+  
+  MotionSample motion;
+  if (mpu.isFifoEnabled()) {
+    drainShakeFifo();
+    // Orientation only needs the loop rate: one burst of all channels
+    if (ENABLE_FLIP_TRIGGER) {
+      if (mpu.readMotionRaw(motion)) {
+        processFlipSample(motion);
+      } else {
+        reportSensorError();
       }
+    }
+  } else if (ENABLE_FLIP_TRIGGER) {
+    // The same burst feeds both detectors
+    if (mpu.readMotionRaw(motion)) {
+      processShakeSample(motion.accel, millis());
+      processFlipSample(motion);
     } else {
-      isShaking = false;
+      reportSensorError();
+    }
+  } else {
+    // Feed one accelerometer sample per loop
+    AccelSample sample;
+    if (mpu.readAccelerometerRaw(sample)) {
+      processShakeSample(sample, millis());
+    } else {
+      reportSensorError();
+    }
+  }
+}
+
+void handleShakeDetection() {
+  PROFILE_ZONE("handleShakeDetection");
+  if (mpu.isInitialized()) {
+    // Device at rest: no I2C traffic until the motion interrupt fires,
+    // unless a trace is being recorded
+    if (motionWindowActive() || traceRecorder.isRecording()) {
+      sampleShakeSensor();
+    }
+    // Also picks up a shake found by drainShakeFifo() during the last flush
+    if (shakePending) {
+      announceShake();
     }
   } else {
     // Use button as fallback
     handleButtonPress();
   }
     // Clear response flag after display duration
-  if (responseShown && (millis() - responseDisplayTime > responseDisplayDuration)) {
+  if (responseShown && !isResponseAnimating() &&
+      (millis() - responseDisplayTime > responseDisplayDuration)) {
     responseShown = false;
     welcomeAnimationTime = millis(); // Start welcome animation
     if (mpu.isInitialized()) {
       Serial.println("Ready for next shake...");
+      if (motionWakeEnabled) {
+        Serial.print("Motion wake-ups: ");
+        Serial.print(motionWakeCount);
+        Serial.print(", false triggers: ");
+        Serial.println(motionFalseTriggerCount);
+      }
     } else {
       Serial.println("Ready for next button press...");
     }
   }
-  
-  // Show animated welcome screen when not showing response
-  if (!responseShown) {
-    displayAnimatedWelcome();
-  }
 }
 
 void handleButtonPress() {
@@ -454,24 +830,34 @@ void handleButtonPress() {
       if (!responseShown && (millis() - lastShakeTime > 1000)) {
         Serial.println("BUTTON PRESSED!");
         lastShakeTime = millis();
-        showRandomResponse();
-        responseShown = true;
-        responseDisplayTime = millis();
+        showRandomResponse(SOURCE_BUTTON);
       }
     }
   }
     lastButtonState = buttonState;
 }
 
-void initializeWiFi() {
-  Serial.println("Initializing WiFi Access Point...");
-  
+void startAccessPoint() {
   // Configure Access Point
+  WiFi.forceSleepWake();
   WiFi.mode(WIFI_AP);
   WiFi.softAPConfig(local_ip, gateway, subnet);
   WiFi.softAP(ap_ssid, ap_password);
+  accessPointOn = true;
+}
+
+bool bootWiFi(BootTask& task, unsigned long now) {
+  if (!wifiEnabled) {
+    return true;
+  }
   
-  delay(100);
+  if (task.state == 0) {
+    Serial.println("Initializing WiFi Access Point...");
+    startAccessPoint();
+    task.state++;
+    task.resumeAt = now + WIFI_AP_SETTLE_MS;
+    return false;
+  }
   
   Serial.println("WiFi Access Point started!");
   Serial.print("AP SSID: ");
@@ -481,147 +867,836 @@ void initializeWiFi() {
   Serial.print("AP IP address: ");
   Serial.println(WiFi.softAPIP());
   Serial.println("Connect to the WiFi network and visit http://192.168.4.1");
+  
+  registerMetrics();
+  initializeWebServer();
+  webServerStarted = true;
+  return true;
 }
 
 void handleRoot() {
-  String html = "<!DOCTYPE html><html><head>";
-  html += "<title>Magic 8-Ball WiFi</title>";
-  html += "<meta name='viewport' content='width=device-width, initial-scale=1'>";
-  html += "<style>";
-  html += "body { font-family: Arial, sans-serif; text-align: center; background: linear-gradient(135deg, #667eea 0%, #764ba2 100%); color: white; margin: 0; padding: 20px; }";
-  html += ".container { max-width: 500px; margin: 0 auto; background: rgba(255,255,255,0.1); padding: 30px; border-radius: 20px; box-shadow: 0 8px 32px rgba(0,0,0,0.3); }";
-  html += "h1 { font-size: 2.5em; margin-bottom: 20px; text-shadow: 2px 2px 4px rgba(0,0,0,0.5); }";
-  html += ".ball { width: 120px; height: 120px; background: #000; border-radius: 50%; margin: 20px auto; position: relative; box-shadow: 0 0 20px rgba(0,0,0,0.5); }";
-  html += ".ball::after { content: '8'; position: absolute; top: 25px; left: 50%; transform: translateX(-50%); color: white; font-size: 24px; font-weight: bold; }";
-  html += "button { background: #ff6b6b; color: white; border: none; padding: 15px 30px; font-size: 18px; border-radius: 50px; cursor: pointer; margin: 10px; transition: all 0.3s; }";
-  html += "button:hover { background: #ff5252; transform: translateY(-2px); box-shadow: 0 4px 8px rgba(0,0,0,0.2); }";
-  html += ".response { background: rgba(255,255,255,0.2); padding: 20px; border-radius: 15px; margin: 20px 0; min-height: 60px; display: flex; align-items: center; justify-content: center; }";
-  html += ".response h2 { margin: 0; font-size: 1.5em; }";
-  html += ".info { font-size: 0.9em; opacity: 0.8; margin-top: 20px; }";
-  html += "@keyframes shake { 0%, 100% { transform: translateX(0); } 25% { transform: translateX(-5px); } 75% { transform: translateX(5px); } }";
-  html += ".shaking { animation: shake 0.5s ease-in-out; }";
-  html += "</style></head><body>";
-  
-  html += "<div class='container'>";
-  html += "<h1>STR Magic 8-Ball</h1>";
-  html += "<div class='ball' id='ball'></div>";
-  html += "<button onclick='askQuestion()'>Ask the Magic 8-Ball!</button>";
-  html += "<div class='response' id='response'>";
-  if (lastWebResponse != "") {
-    html += "<h2>" + lastWebResponse + "</h2>";
-  } else {
-    html += "<p>Click the button to get a response!</p>";
-  }
-  html += "</div>";
-  html += "<div class='info'>";
-  html += "<p>You can also shake the physical device!</p>";
-  html += "<p>Connected clients: " + String(WiFi.softAPgetStationNum()) + "</p>";
-  html += "</div></div>";
-  
-  html += "<script>";
-  html += "function askQuestion() {";
-  html += "  document.getElementById('ball').classList.add('shaking');";
-  html += "  document.getElementById('response').innerHTML = '<p>Thinking...</p>';";
-  html += "  fetch('/ask').then(response => response.text()).then(data => {";
-  html += "    setTimeout(() => {";
-  html += "      document.getElementById('response').innerHTML = '<h2>' + data + '</h2>';";
-  html += "      document.getElementById('ball').classList.remove('shaking');";
-  html += "    }, 1000);";
-  html += "  });";
-  html += "}";
-  html += "</script></body></html>";
-  
-  server.send(200, "text/html", html);
+  httpRequests[HANDLER_ROOT].inc();
+  powerManager.noteActivity(millis());
+  
+  // Static page from flash; the browser revalidates with the ETag and gets a
+  // 304 with no body when the firmware (and so the page) has not changed
+  server.sendHeader("ETag", WEB_INDEX_ETAG);
+  server.sendHeader("Cache-Control", "no-cache");
+  
+  if (server.header("If-None-Match") == WEB_INDEX_ETAG) {
+    server.send(304);
+    webNotModifiedCount++;
+    return;
+  }
+  
+  server.sendHeader("Content-Encoding", "gzip");
+  server.send_P(200, "text/html", (PGM_P)WEB_INDEX_GZ, WEB_INDEX_GZ_LENGTH);
+  webBytesSent += WEB_INDEX_GZ_LENGTH;
+}
+
+size_t buildStatusJson(char* json, size_t size) {
+  // Dynamic bits of the page: last answer, connected clients and queue state
+  char escaped[2 * CATALOG_MAX_ENTRY_LENGTH + 1];
+  escapeJson(lastWebResponse, escaped, sizeof(escaped));
+  int length = snprintf(json, size,
+                        "{\"response\":\"%s\",\"clients\":%d,\"listeners\":%u,\"queued\":%u,\"dropped\":%lu,\"askP99us\":%lu}",
+                        escaped, WiFi.softAPgetStationNum(), eventStream.getClientCount(), responseQueue.size(),
+                        (unsigned long)(responseQueue.getDroppedCount() + responseQueue.getStaleCount()),
+                        (unsigned long)askLatency.percentile(99));
+  return length < (int)size ? length : size - 1;
+}
+
+void handleStatus() {
+  httpRequests[HANDLER_STATUS].inc();
+  powerManager.noteActivity(millis());
+  
+  char json[STATUS_JSON_SIZE];
+  size_t length = buildStatusJson(json, sizeof(json));
+  server.send(200, "application/json", json);
+  webBytesSent += length;
 }
 
 void handleAsk() {
+  unsigned long requestStart = micros();
+  httpRequests[HANDLER_ASK].inc();
+  
   // Generate random response
   randomSeed(millis());
-  int responseIndex = random(numResponses);
-  String response = String(responses[responseIndex]);
+  uint16_t responseIndex = random(responseCount());
+  const char* response = lookupResponse(responseIndex, lastWebResponseText, sizeof(lastWebResponseText));
   
   // Store for display on physical device
   lastWebResponse = response;
   lastWebResponseTime = millis();
   
-  // Show on physical display
-  displayMagic8BallResponse(responses[responseIndex]);
-  responseShown = true;
-  responseDisplayTime = millis();
-  
-  // Play sound if available
-  playRandomSound();
+  // The device animates and plays sound from loop(); reply right away
+  queueResponse(responseIndex, SOURCE_WEB);
   
-  Serial.println("Web request - Response: " + response);
+  Serial.print("Web request - Response: ");
+  Serial.println(response);
   
   server.send(200, "text/plain", response);
+  webBytesSent += strlen(response);
+  askLatency.record(micros() - requestStart);
+}
+
+void sendCatalogStatus() {
+  // {"selected":"office","sets":[{"name":"classic","entries":20},...]}
+  char json[64 + CATALOG_MAX_SETS * 48];
+  int8_t selected = responseCatalog.getSelectedSet();
+  int length = snprintf(json, sizeof(json), "{\"selected\":\"%s\",\"sets\":[",
+                        selected >= 0 ? responseCatalog.getSetName(selected) : "builtin");
+  for (uint8_t i = 0; i < responseCatalog.getSetCount(); i++) {
+    length += snprintf(json + length, sizeof(json) - length, "%s{\"name\":\"%s\",\"entries\":%u}",
+                       i ? "," : "", responseCatalog.getSetName(i), responseCatalog.getSetEntryCount(i));
+  }
+  length += snprintf(json + length, sizeof(json) - length, "]}");
+  server.send(200, "application/json", json);
+  webBytesSent += length;
+}
+
+void handleCatalog() {
+  httpRequests[HANDLER_CATALOG].inc();
+  sendCatalogStatus();
+}
+
+void handleCatalogUpload() {
+  // Streams the POSTed file to LittleFS; handleCatalogUploaded() installs it
+  HTTPUpload& upload = server.upload();
+  if (upload.status == UPLOAD_FILE_START) {
+    catalogUpload = LittleFS.open(CATALOG_UPLOAD_PATH, "w");
+  } else if (upload.status == UPLOAD_FILE_WRITE) {
+    if (catalogUpload) {
+      catalogUpload.write(upload.buf, upload.currentSize);
+    }
+  } else if (catalogUpload) {
+    catalogUpload.close();
+    if (upload.status == UPLOAD_FILE_ABORTED) {
+      LittleFS.remove(CATALOG_UPLOAD_PATH);
+    }
+  }
+}
+
+void handleCatalogUploaded() {
+  httpRequests[HANDLER_CATALOG].inc();
+  if (!responseCatalog.install(CATALOG_UPLOAD_PATH)) {
+    server.send(400, "text/plain", "Invalid catalog (check it with tools/build_catalog.py)");
+    return;
+  }
+  Serial.println("Response catalog replaced");
+  sendCatalogStatus();
+}
+
+void handleCatalogSelect() {
+  httpRequests[HANDLER_CATALOG].inc();
+  String name = server.arg("set");
+  int8_t set = name == "builtin" ? -1 : responseCatalog.findSet(name.c_str());
+  if ((set < 0 && name != "builtin") || !responseCatalog.select(set)) {
+    server.send(404, "text/plain", "Unknown set");
+    return;
+  }
+  Serial.print("Answer set: ");
+  Serial.println(name);
+  sendCatalogStatus();
+}
+
+void handleEvents() {
+  httpRequests[HANDLER_EVENTS].inc();
+  
+  // The connection stays open; eventStream writes to it from loop()
+  WiFiClient client = server.client();
+  if (!eventStream.subscribe(client, server.hasArg("accel"))) {
+    server.send(503, "text/plain", "Too many listeners");
+  }
+}
+
+void sendTraceStatus() {
+  static const char* const stateNames[] = { "idle", "armed", "recording" };
+  char json[160];
+  snprintf(json, sizeof(json),
+           "{\"state\":\"%s\",\"auto\":%s,\"blocks\":%u,\"samples\":%lu,\"dropped\":%lu}",
+           stateNames[traceRecorder.getState()], traceRecorder.isAuto() ? "true" : "false",
+           traceRecorder.getStoredBlocks(), (unsigned long)traceRecorder.getSampleCount(),
+           (unsigned long)traceRecorder.getDroppedCount());
+  server.send(200, "application/json", json);
+}
+
+void handleTrace() {
+  httpRequests[HANDLER_TRACE].inc();
+  sendTraceStatus();
+}
+
+void handleTraceStart() {
+  // /trace/start?seconds=N records for N seconds (default 30)
+  httpRequests[HANDLER_TRACE].inc();
+  unsigned long duration = TRACE_DEFAULT_MS;
+  if (server.hasArg("seconds")) {
+    duration = constrain(server.arg("seconds").toInt(), 1, TRACE_MAX_MS / 1000) * 1000UL;
+  }
+  traceRecorder.start(duration, millis());
+  powerManager.noteActivity(millis());
+  Serial.print("Trace: recording for ");
+  Serial.print(duration / 1000);
+  Serial.println("s");
+  sendTraceStatus();
+}
+
+void handleTraceStop() {
+  httpRequests[HANDLER_TRACE].inc();
+  traceRecorder.stop();
+  traceRecorder.service(millis());
+  sendTraceStatus();
+}
+
+void handleTraceAuto() {
+  // /trace/auto?on=1 records around every shake until turned off
+  httpRequests[HANDLER_TRACE].inc();
+  traceRecorder.setAuto(server.arg("on") != "0");
+  sendTraceStatus();
+}
+
+void handleTraceClear() {
+  httpRequests[HANDLER_TRACE].inc();
+  traceRecorder.clear();
+  sendTraceStatus();
+}
+
+void handleTraceDownload() {
+  httpRequests[HANDLER_TRACE].inc();
+  traceRecorder.service(millis()); // Staged blocks first
+  
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.sendHeader("Content-Disposition", "attachment; filename=\"magic8ball-trace.bin\"");
+  server.send(200, "application/octet-stream", "");
+  traceRecorder.exportBlocks(sendChunk);
+  server.sendContent("");
+}
+
+void handleFrame() {
+  httpRequests[HANDLER_FRAME].inc();
+  
+  // ?answer=N renders the final frame of built-in answer N off-screen, so the
+  // same screen can be captured from two builds and compared pixel by pixel
+  // without disturbing what the display shows
+  if (server.hasArg("answer")) {
+    int index = server.arg("answer").toInt();
+    if (index < 0 || index >= numResponses) {
+      server.send(404, "text/plain", "No such answer");
+      return;
+    }
+    display.clearBuffer();
+    renderResponseFrame(responses[index], responseLayouts[index], RESPONSE_FRAME_COUNT - 1);
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "image/x-portable-bitmap", "");
+    displayFlusher.exportBufferPbm(sendChunk);
+    displayFlusher.restoreBuffer();
+    server.sendContent("");
+    return;
+  }
+  
+  // Check before the 200 goes out; a failed export could not change it after
+  if (!displayFlusher.hasFrame()) {
+    server.send(500, "text/plain", "No frame sent yet");
+    return;
+  }
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "image/x-portable-bitmap", "");
+  displayFlusher.exportPbm(sendChunk);
+  server.sendContent("");
+}
+
+void sendChunk(const char* text, size_t length) {
+  server.sendContent(text, length);
+  webBytesSent += length;
+}
+
+void handleMetrics() {
+  httpRequests[HANDLER_METRICS].inc();
+  updateMetrics();
+  
+  // Chunked, so the text is never held in memory as a whole
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/plain; version=0.0.4", "");
+  metrics.exportText(sendChunk);
+  server.sendContent("");
+}
+
+#ifdef MAGIC8BALL_PROFILER
+void handleProfile() {
+  // Last complete loop() iterations as Chrome trace JSON
+  uint8_t frames = PROFILER_DEFAULT_FRAMES;
+  if (server.hasArg("frames")) {
+    frames = constrain(server.arg("frames").toInt(), 1, 32);
+  }
+  
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.sendHeader("Content-Disposition", "attachment; filename=\"magic8ball-trace.json\"");
+  server.send(200, "application/json", "");
+  profiler.exportTrace(frames, sendChunk);
+  server.sendContent("");
+}
+#endif
+
+void registerMetrics() {
+  metrics.addHistogram("loop_duration_us", "Work time of one loop() iteration", loopDuration);
+  metrics.addHistogram("shake_detection_duration_us", "Time in handleShakeDetection()", shakeDetectionDuration);
+  metrics.addHistogram("display_flush_duration_us", "Time to send one frame to the SH1106", displayFlushDuration);
+  metrics.addHistogram("display_render_duration_us", "Time to draw one frame into the buffer", displayRenderDuration);
+  metrics.addHistogram("ask_reply_duration_us", "/ask request to reply sent", askLatency);
+  metrics.addHistogram("catalog_lookup_duration_us", "Time to read one answer from the catalog", catalogLookup);
+  
+  metrics.addCounter("i2c_transactions_total", "I2C transactions per device", mpuTransactions, "device=\"mpu6050\"");
+  metrics.addCounter("i2c_transactions_total", "I2C transactions per device", displayTransactions, "device=\"sh1106\"");
+  metrics.addCounter("i2c_errors_total", "Failed I2C transactions per device", mpuErrors, "device=\"mpu6050\"");
+  metrics.addCounter("i2c_errors_total", "Failed I2C transactions per device", displayErrors, "device=\"sh1106\"");
+  metrics.addCounter("i2c_nacks_total", "I2C attempts not acknowledged", mpuNacks, "device=\"mpu6050\"");
+  metrics.addCounter("i2c_nacks_total", "I2C attempts not acknowledged", displayNacks, "device=\"sh1106\"");
+  metrics.addCounter("i2c_timeouts_total", "I2C attempts over the time limit", mpuTimeouts, "device=\"mpu6050\"");
+  metrics.addCounter("i2c_timeouts_total", "I2C attempts over the time limit", displayTimeouts, "device=\"sh1106\"");
+  metrics.addCounter("i2c_recoveries_total", "I2C bus clears after a stuck transaction", mpuRecoveries, "device=\"mpu6050\"");
+  metrics.addCounter("i2c_recoveries_total", "I2C bus clears after a stuck transaction", displayRecoveries, "device=\"sh1106\"");
+  metrics.addCounter("sensor_read_errors_total", "Accelerometer reads that failed after retries", sensorReadErrors);
+  metrics.addCounter("display_bytes_total", "Frame bytes sent to the SH1106", displayBytes);
+  metrics.addCounter("display_frames_over_budget_total", "Frames over the render time or byte budget", framesOverBudget);
+  metrics.addCounter("dfplayer_commands_total", "Commands sent to the DFPlayer", dfplayerCommands);
+  metrics.addCounter("dfplayer_timeouts_total", "DFPlayer commands without an ACK (or BUSY change) in time", dfplayerTimeouts);
+  metrics.addCounter("dfplayer_errors_total", "Error messages and bad frames from the DFPlayer", dfplayerErrors);
+  metrics.addCounter("dfplayer_tracks_finished_total", "Tracks the DFPlayer reported as finished", dfplayerFinished);
+  
+  static const char* const handlerLabels[HANDLER_COUNT] = {
+    "handler=\"root\"", "handler=\"status\"", "handler=\"ask\"",
+    "handler=\"events\"", "handler=\"metrics\"", "handler=\"catalog\"",
+    "handler=\"frame\"", "handler=\"trace\"", "handler=\"not_found\""
+  };
+  for (int i = 0; i < HANDLER_COUNT; i++) {
+    metrics.addCounter("http_requests_total", "HTTP requests per handler", httpRequests[i], handlerLabels[i]);
+  }
+  
+  metrics.addCounter("shakes_total", "Shakes recognised by the gesture engine", shakesDetected);
+  metrics.addCounter("flips_total", "Turn-overs recognised by the flip detector", flipsDetected);
+  metrics.addCounter("answers_queued_total", "Answers queued from any source", answersQueued);
+  metrics.addCounter("answers_dropped_total", "Answers dropped because the queue was full", answersDropped);
+  metrics.addCounter("answers_stale_total", "Answers discarded as too old to show", answersStale);
+  metrics.addGauge("answer_queue_depth", "Answers waiting for the display", queueDepth);
+  metrics.addCounter("sse_events_total", "Events published to /events", sseEvents);
+  metrics.addCounter("sse_slow_clients_total", "Listeners dropped for not keeping up", sseSlowClients);
+  metrics.addCounter("sse_events_dropped_total", "Events too long to publish", sseDroppedEvents);
+  metrics.addCounter("trace_samples_total", "Accelerometer samples recorded to the trace file", traceSamples);
+  metrics.addCounter("trace_dropped_samples_total", "Trace samples lost waiting for flash", traceDropped);
+  metrics.addGauge("sse_listeners", "Open /events connections", sseListeners);
+  metrics.addGauge("wifi_stations", "Stations connected to the access point", wifiStations);
+  
+  static const char* const powerLabels[POWER_STATE_COUNT] = {
+    "state=\"active\"", "state=\"idle\"", "state=\"deep_idle\""
+  };
+  for (int i = 0; i < POWER_STATE_COUNT; i++) {
+    metrics.addCounter("power_state_seconds_total", "Time spent in each power state", powerStateSeconds[i], powerLabels[i]);
+  }
+  metrics.addGauge("power_state", "0 = active, 1 = idle, 2 = deep idle", powerState);
+  metrics.addGauge("power_estimated_milliamps", "Estimated current draw now", powerMilliAmps);
+  metrics.addGauge("power_average_milliamps", "Estimated average current since boot", powerAverageMilliAmps);
+  
+  metrics.addGauge("heap_free_bytes", "Free heap", heapFree);
+  metrics.addGauge("heap_min_free_bytes", "Lowest free heap since boot", heapMinFree);
+  metrics.addGauge("heap_max_block_bytes", "Largest allocatable heap block", heapMaxBlock);
+  metrics.addGauge("heap_fragmentation_percent", "Heap fragmentation", heapFragmentation);
+}
+
+void updateMetrics() {
+  // Counts kept by their own modules are copied in at scrape time
+  const I2CClientStats* stats = i2cBus.getStats(mpu.getBusClient());
+  if (stats) {
+    mpuTransactions.set(stats->lifetimeTransactions);
+    mpuErrors.set(stats->lifetimeErrors);
+    mpuNacks.set(stats->nacks);
+    mpuTimeouts.set(stats->timeouts);
+    mpuRecoveries.set(stats->recoveries);
+  }
+  stats = i2cBus.getStats(displayFlusher.getBusClient());
+  if (stats) {
+    displayTransactions.set(stats->lifetimeTransactions);
+    displayErrors.set(stats->lifetimeErrors);
+    displayNacks.set(stats->nacks);
+    displayTimeouts.set(stats->timeouts);
+    displayRecoveries.set(stats->recoveries);
+  }
+  
+  dfplayerCommands.set(dfplayer.getCommandCount());
+  dfplayerTimeouts.set(dfplayer.getTimeoutCount());
+  dfplayerErrors.set(dfplayer.getErrorCount());
+  dfplayerFinished.set(dfplayer.getFinishedCount());
+  
+  shakesDetected.set(gestureEngine.getShakeCount());
+  flipsDetected.set(flipDetector.getFlipCount());
+  answersQueued.set(responseQueue.getEnqueuedCount());
+  answersDropped.set(responseQueue.getDroppedCount());
+  answersStale.set(responseQueue.getStaleCount());
+  queueDepth.set(responseQueue.size());
+  sseEvents.set(eventStream.getEventCount());
+  sseSlowClients.set(eventStream.getDroppedClientCount());
+  sseDroppedEvents.set(eventStream.getDroppedEventCount());
+  sseListeners.set(eventStream.getClientCount());
+  traceSamples.set(traceRecorder.getSampleCount());
+  traceDropped.set(traceRecorder.getDroppedCount());
+  wifiStations.set(WiFi.softAPgetStationNum());
+  
+  unsigned long now = millis();
+  for (int i = 0; i < POWER_STATE_COUNT; i++) {
+    powerStateSeconds[i].set(powerManager.getTimeInState((PowerState)i, now) / 1000);
+  }
+  powerState.set(powerManager.getState());
+  powerMilliAmps.set(powerManager.getLoad());
+  powerAverageMilliAmps.set(powerManager.getAverageMilliAmps(now));
+  
+  heapFree.set(ESP.getFreeHeap());
+  heapMinFree.set(minFreeHeap);
+  heapMaxBlock.set(ESP.getMaxFreeBlockSize());
+  heapFragmentation.set(ESP.getHeapFragmentation());
 }
 
 void handleNotFound() {
+  httpRequests[HANDLER_NOT_FOUND].inc();
+  
   server.send(404, "text/plain", "Page not found");
 }
 
 void initializeWebServer() {
   server.on("/", handleRoot);
+  server.on("/status", handleStatus);
   server.on("/ask", handleAsk);
+  server.on("/events", handleEvents);
+  server.on("/metrics", handleMetrics);
+  server.on("/catalog", HTTP_GET, handleCatalog);
+  server.on("/catalog", HTTP_POST, handleCatalogUploaded, handleCatalogUpload);
+  server.on("/catalog/select", handleCatalogSelect);
+  server.on("/frame.pbm", handleFrame);
+  server.on("/trace", handleTrace);
+  server.on("/trace/start", handleTraceStart);
+  server.on("/trace/stop", handleTraceStop);
+  server.on("/trace/auto", handleTraceAuto);
+  server.on("/trace/clear", handleTraceClear);
+  server.on("/trace.bin", handleTraceDownload);
+#ifdef MAGIC8BALL_PROFILER
+  server.on("/profile", handleProfile);
+#endif
   server.onNotFound(handleNotFound);
   
+  // Needed for ETag revalidation of the page
+  static const char* cacheHeaders[] = { "If-None-Match" };
+  server.collectHeaders(cacheHeaders, 1);
+  
   server.begin();
   Serial.println("Web server started on port 80");
 }
 
+bool bootDisplay(BootTask& task, unsigned long now) {
+  initializeDisplay();
+  displayWelcomeMessage();
+  return true;
+}
+
+bool bootCatalog(BootTask& task, unsigned long now) {
+  responseCatalog.begin();
+  Serial.print("Answers: ");
+  if (responseCatalog.isActive()) {
+    Serial.print(responseCatalog.getSetName(responseCatalog.getSelectedSet()));
+    Serial.print(" (");
+    Serial.print(responseCatalog.getEntryCount());
+    Serial.println(" entries)");
+  } else {
+    Serial.println("built-in");
+  }
+  return true;
+}
+
+bool bootTrace(BootTask& task, unsigned long now) {
+  traceRecorder.begin(mpu.getAccelerometerRange());
+  return true;
+}
+
+bool bootSensor(BootTask& task, unsigned long now) {
+  // Initialize MPU6050
+  bool mpuInitialized = mpu.begin();
+  
+  if (mpuInitialized) {
+    // Sample at a fixed rate into the FIFO so no motion is missed between polls
+    mpu.setDigitalLowPassFilter(SHAKE_DLPF_MODE);
+    mpu.setSampleRateDivider(SHAKE_SAMPLE_RATE_DIV);
+    if (!mpu.enableFifo()) {
+      Serial.println("   FIFO unavailable - falling back to polling");
+    }
+    initializeMotionWake();
+    flipDetector.begin(mpu.getAccelerometerRange(), mpu.getGyroRange());
+    gestureEngine.begin(mpu.getAccelerometerRange(),
+                        mpu.isFifoEnabled() ? SHAKE_SAMPLE_RATE_HZ : SHAKE_POLL_RATE_HZ);
+    i2cBus.setServiceCallback(mpu.getBusClient(), drainShakeFifo, SHAKE_SERVICE_INTERVAL);
+    
+    Serial.println("Shake detection enabled!");
+    Serial.println("   Shake the device to get a response!");
+    Serial.println("   Monitoring accelerometer data...");
+  } else {
+    Serial.println("MPU6050 initialization failed");
+    Serial.println("   Button mode enabled - press built-in button (D3)");
+  }
+  
+  // A cached map that disagrees with the hardware is stale; rescan next boot
+  if (deviceMap.isCached() && deviceMap.has(MPU6050_ALT_ADDR) != mpuInitialized) {
+    deviceMap.invalidateRtc();
+  }
+  return true;
+}
+
+// Bring-up order; display and sensor finish in their first step, so shakes
+// are handled while the DFPlayer and access point are still starting
+BootTask bootTasks[] = {
+  { "display",  bootDisplay,  0, 0, 0, false },
+  { "sensor",   bootSensor,   0, 0, 0, false },
+  { "catalog",  bootCatalog,  0, 0, 0, false },
+  { "trace",    bootTrace,    0, 0, 0, false },
+  { "wifi",     bootWiFi,     0, 0, 0, false },
+  { "dfplayer", bootDFPlayer, 0, 0, 0, false },
+};
+const int numBootTasks = sizeof(bootTasks) / sizeof(bootTasks[0]);
+
+void logBootStage(const char* name, unsigned long activeMicros) {
+  Serial.print("Boot: ");
+  Serial.print(name);
+  Serial.print(" ready at ");
+  Serial.print(millis());
+  Serial.print("ms (busy ");
+  Serial.print(activeMicros / 1000);
+  Serial.println("ms)");
+}
+
+void serviceBoot() {
+  unsigned long now = millis();
+  bool allDone = true;
+  
+  for (int i = 0; i < numBootTasks; i++) {
+    BootTask& task = bootTasks[i];
+    if (task.done) {
+      continue;
+    }
+    allDone = false;
+    if ((long)(now - task.resumeAt) < 0) {
+      continue;
+    }
+    
+    unsigned long stepStart = micros();
+    task.done = task.step(task, now);
+    task.activeMicros += micros() - stepStart;
+    if (task.done) {
+      logBootStage(task.name, task.activeMicros);
+    }
+  }
+  
+  if (allDone) {
+    bootComplete = true;
+    Serial.print("Boot complete in ");
+    Serial.print(millis());
+    Serial.println("ms");
+    Serial.println();
+    Serial.println("Ask the Magic 8-Ball a question...");
+    if (wifiEnabled) {
+      Serial.println("You can also connect to WiFi and visit http://192.168.4.1");
+    }
+    Serial.println("====================================");
+    
+#ifdef MAGIC8BALL_BENCHMARKS
+    // Once everything is up, so the catalog and metrics are measured too
+    runBenchmarks();
+#endif
+  }
+}
+
 void setup() {
   Serial.begin(115200);
-  delay(1000);
   
   Serial.println();  Serial.println("=== MAGIC 8-BALL ===");
   Serial.println("With SH1106 OLED Display");
   Serial.println();
   
-  // Initialize I2C
-  Wire.begin(MPU_SDA, MPU_SCL);
+  // The bus manager owns Wire for the display and the MPU6050
+  i2cBus.begin(MPU_SDA, MPU_SCL);
   
-  // Initialize SH1106 OLED display
-  initializeDisplay();
-  displayWelcomeMessage();
+  // One bus scan per power-on; warm boots reuse the map from RTC memory
+  unsigned long scanStart = micros();
+  if (!deviceMap.loadFromRtc()) {
+    deviceMap.scan();
+    deviceMap.saveToRtc();
+  }
+  deviceMap.print();
+  logBootStage("i2c map", micros() - scanStart);
   
   // Initialize button pin
   pinMode(BUTTON_PIN, INPUT_PULLUP);
   
-  // Initialize MPU6050
-  bool mpuInitialized = mpu.begin(MPU_SDA, MPU_SCL); // D2=GPIO4, D1=GPIO5
+  // Display and sensor come up here; the rest continues from loop()
+  serviceBoot();
+}
+
+uint16_t estimateCurrent() {
+  // Sum of rough per-component figures for the current configuration
+  uint16_t milliAmps = POWER_MA_MPU6050;
+  bool lightSleeping = !accessPointOn && powerManager.getState() != POWER_ACTIVE;
+  milliAmps += lightSleeping ? POWER_MA_CPU_SLEEP : POWER_MA_CPU;
+  if (accessPointOn) {
+    milliAmps += POWER_MA_RADIO_AP;
+  }
+  if (!displayAsleep) {
+    milliAmps += POWER_MA_OLED;
+  }
+  milliAmps += dfplayerAsleep ? POWER_MA_DFPLAYER_SLEEP : POWER_MA_DFPLAYER;
+  return milliAmps;
+}
+
+void enterDeepIdle() {
+  // Blank the panel; the frame buffer is kept and resent on wake
+  i2cBus.beginExternal(displayFlusher.getBusClient());
+  display.setPowerSave(1);
+  i2cBus.endExternal(displayFlusher.getBusClient(), true);
+  displayAsleep = true;
+  
+  if (dfplayerReady) {
+    dfplayer.send(DFPLAYER_CMD_SLEEP);
+    dfplayerAsleep = true;
+  }
   
-  if (mpuInitialized) {
-    Serial.println("Shake detection enabled!");
-    Serial.println("   Shake the device to get a response!");
-    Serial.println("   Monitoring accelerometer data...");
-  } else {
-    Serial.println("MPU6050 initialization failed");
-    Serial.println("   Button mode enabled - press built-in button (D3)");
+  // Without the motion interrupt nothing could bring the AP back
+  if (POWER_AP_OFF_IN_DEEP_IDLE && motionWakeEnabled && accessPointOn) {
+    WiFi.softAPdisconnect(true);
+    WiFi.mode(WIFI_OFF);
+    WiFi.forceSleepBegin();
+    accessPointOn = false;
+    Serial.println("Power: access point off until motion");
+  }
+}
+
+void leaveDeepIdle() {
+  if (displayAsleep) {
+    i2cBus.beginExternal(displayFlusher.getBusClient());
+    display.setPowerSave(0);
+    i2cBus.endExternal(displayFlusher.getBusClient(), true);
+    displayFlusher.invalidate();
+    displayAsleep = false;
   }
-    // Initialize DFPlayer Mini
-  initializeDFPlayer();
   
-  // Initialize WiFi Access Point and Web Server
-  if (wifiEnabled) {
-    initializeWiFi();
-    initializeWebServer();
+  if (dfplayerAsleep) {
+    dfplayer.send(DFPLAYER_CMD_WAKE);
+    dfplayerAsleep = false;
   }
   
-  Serial.println();
-  Serial.println("Ask the Magic 8-Ball a question...");
-  if (wifiEnabled) {
-    Serial.println("You can also connect to WiFi and visit http://192.168.4.1");
+  if (webServerStarted && !accessPointOn) {
+    startAccessPoint();
+    Serial.println("Power: access point back on");
+  }
+}
+
+void updatePowerState() {
+  unsigned long now = millis();
+  
+  if (powerManager.update(now)) {
+    PowerState state = powerManager.getState();
+    Serial.print("Power: ");
+    Serial.println(PowerManager::getStateName(state));
+    
+    if (state == POWER_DEEP_IDLE) {
+      enterDeepIdle();
+    } else {
+      leaveDeepIdle();
+    }
+    welcomeFrameDurations[0] = state == POWER_ACTIVE ? WELCOME_FRAME_INTERVAL : WELCOME_FRAME_INTERVAL_IDLE;
+  }
+  
+  powerManager.setLoad(estimateCurrent(), now);
+}
+
+void waitForNextLoop() {
+  PowerState state = powerManager.getState();
+  if (state == POWER_ACTIVE || !bootComplete) {
+    delay(LOOP_INTERVAL_MS);
+    return;
+  }
+  
+  // The ESP8266 cannot light-sleep while it runs the access point, and
+  // DFPlayer replies would be lost, so those cases only slow the loop down
+  uint32_t interval = state == POWER_IDLE ? LOOP_INTERVAL_IDLE_MS : LOOP_INTERVAL_DEEP_IDLE_MS;
+  if (accessPointOn || !dfplayer.isIdle()) {
+    delay(interval);
+    return;
+  }
+  
+  // The FIFO keeps sampling while the CPU sleeps between loops; in deep
+  // idle the screen is off, so sleep until the sensor reports motion
+  bool untilMotion = state == POWER_DEEP_IDLE && motionWakeEnabled;
+  PowerManager::lightSleep(untilMotion ? 0 : interval, MPU_INT_PIN);
+  
+  // The wake-up setup took over the pin's interrupt; the RISING edge may
+  // also have happened while asleep
+  if (motionWakeEnabled) {
+    attachInterrupt(digitalPinToInterrupt(MPU_INT_PIN), onMotionInterrupt, RISING);
+    if (digitalRead(MPU_INT_PIN) == HIGH) {
+      motionEventPending = true;
+    }
+  }
+}
+
+void recordLoopLatency(unsigned long elapsedMicros) {
+  loopDuration.record(elapsedMicros);
+  if (elapsedMicros > loopMaxMicros) {
+    loopMaxMicros = elapsedMicros;
+  }
+  
+  uint32_t freeHeap = ESP.getFreeHeap();
+  if (freeHeap < minFreeHeap) {
+    minFreeHeap = freeHeap;
+  }
+  
+  if (millis() - loopStatsStart > LOOP_STATS_INTERVAL) {
+    Serial.print("Loop latency: max ");
+    Serial.print(loopMaxMicros);
+    Serial.println("us");
+    
+    uint32_t frames = displayFlusher.getFlushCount();
+    Serial.print("Display: ");
+    Serial.print(frames);
+    Serial.print(" frames sent, ");
+    Serial.print(displayFlusher.getSkippedCount());
+    Serial.print(" unchanged, ");
+    Serial.print(frames ? displayFlusher.getTotalBytes() / frames : 0);
+    Serial.print(" bytes/frame, max ");
+    Serial.print(frameMaxMicros);
+    Serial.print("us, ");
+    Serial.print(framesOverBudget.get() - framesOverBudgetReported);
+    Serial.println(" over budget");
+    framesOverBudgetReported = framesOverBudget.get();
+    frameMaxMicros = 0;
+    displayFlusher.resetStats();
+    
+    i2cBus.printStats();
+    i2cBus.resetStats();
+    
+    if (wifiEnabled) {
+      Serial.print("Web: ");
+      Serial.print(webBytesSent);
+      Serial.print(" bytes sent, ");
+      Serial.print(webNotModifiedCount);
+      Serial.print(" page requests not modified, ");
+      Serial.print(eventStream.getClientCount());
+      Serial.print(" event listeners (");
+      Serial.print(eventStream.getDroppedClientCount());
+      Serial.print(" dropped as slow, ");
+      Serial.print(eventStream.getDroppedEventCount());
+      Serial.println(" events too long)");
+    }
+    Serial.print("DFPlayer: ");
+    Serial.print(dfplayer.getCommandCount());
+    Serial.print(" commands, ");
+    Serial.print(dfplayer.getTimeoutCount());
+    Serial.print(" timeouts, ");
+    Serial.print(dfplayer.getErrorCount());
+    Serial.print(" errors (last 0x");
+    Serial.print(dfplayer.getLastError(), HEX);
+    Serial.print("), ");
+    Serial.print(dfplayer.getReplacedCount());
+    Serial.println(" sounds replaced");
+    
+    Serial.print("Responses: ");
+    Serial.print(responseQueue.getEnqueuedCount());
+    Serial.print(" queued, depth ");
+    Serial.print(responseQueue.size());
+    Serial.print(" (max ");
+    Serial.print(responseQueue.getMaxDepth());
+    Serial.print("), ");
+    Serial.print(responseQueue.getDroppedCount());
+    Serial.print(" dropped, ");
+    Serial.print(responseQueue.getStaleCount());
+    Serial.println(" stale");
+    
+    if (catalogLookup.getCount() > 0) {
+      Serial.print("Catalog lookup: p50 ");
+      Serial.print(catalogLookup.percentile(50));
+      Serial.print("us, max ");
+      Serial.print(catalogLookup.getMax());
+      Serial.println("us");
+    }
+    
+    if (askLatency.getCount() > 0) {
+      Serial.print("Ask latency: p50 ");
+      Serial.print(askLatency.percentile(50));
+      Serial.print("us, p99 ");
+      Serial.print(askLatency.percentile(99));
+      Serial.print("us, max ");
+      Serial.print(askLatency.getMax());
+      Serial.print("us over ");
+      Serial.print(askLatency.getCount());
+      Serial.println(" requests");
+    }
+    
+    unsigned long now = millis();
+    Serial.print("Power: ");
+    Serial.print(PowerManager::getStateName(powerManager.getState()));
+    for (int i = 0; i < POWER_STATE_COUNT; i++) {
+      Serial.print(i == 0 ? " (" : ", ");
+      Serial.print(PowerManager::getStateName((PowerState)i));
+      Serial.print(" ");
+      Serial.print(powerManager.getTimeInState((PowerState)i, now) / 1000);
+      Serial.print("s");
+    }
+    Serial.print("), ~");
+    Serial.print(powerManager.getLoad());
+    Serial.print("mA now, ~");
+    Serial.print(powerManager.getAverageMilliAmps(now));
+    Serial.println("mA average");
+    
+    Serial.print("Heap: free ");
+    Serial.print(freeHeap);
+    Serial.print(", lowest ");
+    Serial.println(minFreeHeap);
+    loopMaxMicros = 0;
+    loopStatsStart = millis();
   }
-  Serial.println("====================================");
 }
 
 void loop() {
+  PROFILE_FRAME("loop");
+  unsigned long loopStart = micros();
+  
+  if (!bootComplete) {
+    serviceBoot();
+  }
+  
+  // Send queued DFPlayer commands and read its status messages
+  dfplayer.service();
+  
   // Handle web server requests
-  if (wifiEnabled) {
+  if (webServerStarted) {
+    eventStream.service();
+    PROFILE_ZONE("handleClient");
     server.handleClient();
   }
   
+  unsigned long shakeStart = micros();
   handleShakeDetection();
-  delay(100); // Small delay to prevent excessive polling
+  shakeDetectionDuration.record(micros() - shakeStart);
+  
+  // Recorded samples go to flash here, outside the sensor and display paths
+  traceRecorder.service(millis());
+  if (traceRecorder.isRecording()) {
+    powerManager.noteActivity(millis());
+  }
+  
+  // Start the next queued answer once the display is free
+  playQueuedResponse();
+  
+  // Step between active, idle and deep idle
+  updatePowerState();
+  
+  // Draw at most one animation frame per iteration
+  if (!displayAsleep) {
+    updateDisplayAnimation();
+  }
+  
+  recordLoopLatency(micros() - loopStart);
+  waitForNextLoop();
 }
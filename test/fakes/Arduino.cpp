@@ -0,0 +1,316 @@
+#include "Arduino.h"
+#include <stdarg.h>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+HardwareSerial Serial;
+EspClass ESP;
+
+static unsigned long long fakeMicrosNow = 0;
+static uint32_t randomState = 1;
+static uint32_t rtcMemory[128];
+
+struct FakePin {
+    uint8_t mode;
+    int external;   // Level driven from outside (pull-ups read HIGH)
+    int output;
+    void (*handler)();
+    int interruptMode;
+    void (*refresh)(void *context);
+    void *refreshContext;
+};
+static FakePin pins[FAKE_PIN_COUNT];
+static bool pinsReady = false;
+
+static void initPins() {
+    if (pinsReady) {
+        return;
+    }
+    for (int i = 0; i < FAKE_PIN_COUNT; i++) {
+        pins[i].mode = INPUT;
+        pins[i].external = HIGH;
+        pins[i].output = HIGH;
+        pins[i].handler = 0;
+        pins[i].interruptMode = 0;
+        pins[i].refresh = 0;
+        pins[i].refreshContext = 0;
+    }
+    pinsReady = true;
+}
+
+String::String(float value, unsigned int decimals) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, value);
+    text = buffer;
+}
+
+bool String::endsWith(const char *suffix) const {
+    size_t length = strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+int String::indexOf(char c) const {
+    size_t at = text.find(c);
+    return at == std::string::npos ? -1 : (int)at;
+}
+
+int String::lastIndexOf(char c) const {
+    size_t at = text.rfind(c);
+    return at == std::string::npos ? -1 : (int)at;
+}
+
+String String::substring(unsigned int from) const {
+    return from < text.size() ? String(text.substr(from)) : String();
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+        unsigned int swap = from;
+        from = to;
+        to = swap;
+    }
+    return from < text.size() ? String(text.substr(from, to - from)) : String();
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+    size_t written = 0;
+    while (size--) {
+        written += write(*buffer++);
+    }
+    return written;
+}
+
+size_t Print::printNumber(unsigned long long value, int base) {
+    char buffer[72];
+    char *p = &buffer[sizeof(buffer) - 1];
+    *p = 0;
+    if (base < 2) {
+        base = DEC;
+    }
+    do {
+        int digit = value % base;
+        *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+        value /= base;
+    } while (value);
+    return write(p);
+}
+
+size_t Print::printSigned(long long value, int base) {
+    if (base == DEC && value < 0) {
+        return write((uint8_t)'-') + printNumber(-(unsigned long long)value, base);
+    }
+    // Like the core, other bases print the two's complement of the type
+    return printNumber((uint32_t)value, base);
+}
+
+size_t Print::print(double value, int digits) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+    return write(buffer);
+}
+
+size_t Print::printf(const char *format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) {
+        return 0;
+    }
+    return write((const uint8_t *)buffer, min((size_t)length, sizeof(buffer) - 1));
+}
+
+size_t Stream::readBytes(uint8_t *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length && available() > 0) {
+        buffer[count++] = read();
+    }
+    return count;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    log += (char)c;
+    if (echo) {
+        fputc(c, stdout);
+    }
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+    log.append((const char *)buffer, size);
+    if (echo) {
+        fwrite(buffer, 1, size, stdout);
+    }
+    return size;
+}
+
+unsigned long millis() {
+    return (unsigned long)(fakeMicrosNow / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)fakeMicrosNow;
+}
+
+void delay(unsigned long ms) {
+    fakeMicrosNow += (unsigned long long)ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us) {
+    fakeMicrosNow += us;
+}
+
+void yield() {
+}
+
+void fakeAdvanceMicros(unsigned long us) {
+    fakeMicrosNow += us;
+}
+
+void fakeResetClock() {
+    fakeMicrosNow = 0;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    initPins();
+    if (pin < FAKE_PIN_COUNT) {
+        pins[pin].mode = mode;
+        pins[pin].output = HIGH;
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    initPins();
+    if (pin >= FAKE_PIN_COUNT) {
+        return LOW;
+    }
+    if (pins[pin].refresh) {
+        pins[pin].refresh(pins[pin].refreshContext);
+    }
+    const FakePin &p = pins[pin];
+    if (p.mode == OUTPUT) {
+        return p.output;
+    }
+    if (p.mode == OUTPUT_OPEN_DRAIN) {
+        return p.output && p.external;
+    }
+    return p.external;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    initPins();
+    if (pin < FAKE_PIN_COUNT) {
+        pins[pin].output = value ? HIGH : LOW;
+    }
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode) {
+    initPins();
+    if (pin < FAKE_PIN_COUNT) {
+        pins[pin].handler = handler;
+        pins[pin].interruptMode = mode;
+    }
+}
+
+void detachInterrupt(uint8_t pin) {
+    fakeDetachInterruptSilently(pin);
+}
+
+void noInterrupts() {
+}
+
+void interrupts() {
+}
+
+void fakeSetPin(uint8_t pin, int level) {
+    initPins();
+    if (pin >= FAKE_PIN_COUNT) {
+        return;
+    }
+    FakePin &p = pins[pin];
+    int previous = p.external;
+    p.external = level ? HIGH : LOW;
+    if (!p.handler || previous == p.external) {
+        return;
+    }
+    bool rising = p.external == HIGH;
+    if (p.interruptMode == CHANGE || (p.interruptMode == RISING && rising) ||
+        (p.interruptMode == FALLING && !rising)) {
+        p.handler();
+    }
+}
+
+int fakePinMode(uint8_t pin) {
+    initPins();
+    return pin < FAKE_PIN_COUNT ? pins[pin].mode : -1;
+}
+
+int fakeOutputLevel(uint8_t pin) {
+    initPins();
+    return pin < FAKE_PIN_COUNT ? pins[pin].output : -1;
+}
+
+bool fakeInterruptAttached(uint8_t pin) {
+    initPins();
+    return pin < FAKE_PIN_COUNT && pins[pin].handler != 0;
+}
+
+void fakeDetachInterruptSilently(uint8_t pin) {
+    initPins();
+    if (pin < FAKE_PIN_COUNT) {
+        pins[pin].handler = 0;
+        pins[pin].interruptMode = 0;
+    }
+}
+
+void fakeSetPinRefresh(uint8_t pin, void (*refresh)(void *context), void *context) {
+    initPins();
+    if (pin < FAKE_PIN_COUNT) {
+        pins[pin].refresh = refresh;
+        pins[pin].refreshContext = context;
+    }
+}
+
+long random(long max) {
+    return max > 0 ? random(0, max) : 0;
+}
+
+long random(long min, long max) {
+    if (max <= min) {
+        return min;
+    }
+    randomState = randomState * 1103515245 + 12345;
+    return min + (long)((randomState >> 8) % (uint32_t)(max - min));
+}
+
+void randomSeed(unsigned long seed) {
+    randomState = seed ? seed : 1;
+}
+
+uint32_t EspClass::getCycleCount() {
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size) {
+    if (offset * 4 + size > sizeof(rtcMemory)) {
+        return false;
+    }
+    memcpy(data, (uint8_t *)rtcMemory + offset * 4, size);
+    return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size) {
+    if (offset * 4 + size > sizeof(rtcMemory)) {
+        return false;
+    }
+    memcpy((uint8_t *)rtcMemory + offset * 4, data, size);
+    return true;
+}
@@ -0,0 +1,243 @@
+#ifndef FAKE_ARDUINO_H
+#define FAKE_ARDUINO_H
+
+// Host stand-in for the ESP8266 Arduino core, enough to build the firmware
+// in the native environment. Time only moves when the code under test calls
+// delay()/delayMicroseconds() or a test calls fakeAdvanceMicros(), so runs
+// are deterministic. Pins, interrupts and the serial log are inspectable
+// through the fake* functions at the end.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW  0
+#define INPUT             0x00
+#define OUTPUT            0x01
+#define INPUT_PULLUP      0x02
+#define OUTPUT_OPEN_DRAIN 0x03
+#define RISING  1
+#define FALLING 2
+#define CHANGE  3
+
+#define PI      3.1415926535897932384626433832795
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+// NodeMCU pin labels
+#define D0 16
+#define D1 5
+#define D2 4
+#define D3 0
+#define D4 2
+#define D5 14
+#define D6 12
+#define D7 13
+#define D8 15
+#define FAKE_PIN_COUNT 17
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define F(s) ((const __FlashStringHelper *)(s))
+#define pgm_read_byte(p)  (*(const uint8_t *)(p))
+#define pgm_read_word(p)  (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define pgm_read_ptr(p)   (*(void *const *)(p))
+#define memcpy_P   memcpy
+#define strlen_P   strlen
+#define strcmp_P   strcmp
+#define strcpy_P   strcpy
+#define strncpy_P  strncpy
+#define snprintf_P snprintf
+#define digitalPinToInterrupt(p) (p)
+
+class __FlashStringHelper;
+
+class String {
+public:
+    String(const char *s = "") : text(s ? s : "") {}
+    String(const __FlashStringHelper *s) : text((const char *)s) {}
+    String(const std::string &s) : text(s) {}
+    String(char c) : text(1, c) {}
+    String(int value) : text(std::to_string(value)) {}
+    String(unsigned int value) : text(std::to_string(value)) {}
+    String(long value) : text(std::to_string(value)) {}
+    String(unsigned long value) : text(std::to_string(value)) {}
+    String(float value, unsigned int decimals = 2);
+
+    String &operator+=(const String &other) { text += other.text; return *this; }
+    String &operator+=(const char *other) { text += other; return *this; }
+    String &operator+=(char other) { text += other; return *this; }
+    friend String operator+(const String &a, const String &b) { String r(a); r += b; return r; }
+    friend String operator+(const char *a, const String &b) { String r(a); r += b; return r; }
+    friend String operator+(const String &a, const char *b) { String r(a); r += b; return r; }
+    bool operator==(const char *other) const { return text == other; }
+    bool operator==(const String &other) const { return text == other.text; }
+    bool operator!=(const char *other) const { return text != other; }
+    char operator[](unsigned int index) const { return index < text.size() ? text[index] : 0; }
+
+    const char *c_str() const { return text.c_str(); }
+    unsigned int length() const { return text.size(); }
+    bool isEmpty() const { return text.empty(); }
+    void reserve(unsigned int size) { text.reserve(size); }
+    bool equals(const char *other) const { return text == other; }
+    bool startsWith(const char *prefix) const { return text.compare(0, strlen(prefix), prefix) == 0; }
+    bool endsWith(const char *suffix) const;
+    int indexOf(char c) const;
+    int lastIndexOf(char c) const;
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+    long toInt() const { return atol(text.c_str()); }
+    float toFloat() const { return atof(text.c_str()); }
+
+private:
+    std::string text;
+};
+
+class Print;
+
+class Printable {
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print &out) const = 0;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *text) { return text ? write((const uint8_t *)text, strlen(text)) : 0; }
+    size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const char *text) { return write(text); }
+    size_t print(const __FlashStringHelper *text) { return write((const char *)text); }
+    size_t print(const String &text) { return write(text.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char value, int base = DEC) { return printNumber(value, base); }
+    size_t print(int value, int base = DEC) { return printSigned(value, base); }
+    size_t print(unsigned int value, int base = DEC) { return printNumber(value, base); }
+    size_t print(long value, int base = DEC) { return printSigned(value, base); }
+    size_t print(unsigned long value, int base = DEC) { return printNumber(value, base); }
+    size_t print(long long value, int base = DEC) { return printSigned(value, base); }
+    size_t print(unsigned long long value, int base = DEC) { return printNumber(value, base); }
+    size_t print(double value, int digits = 2);
+    size_t print(const Printable &value) { return value.printTo(*this); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T> size_t println(const T &value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(const T &value, int format) { size_t n = print(value, format); return n + println(); }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+private:
+    size_t printNumber(unsigned long long value, int base);
+    size_t printSigned(long long value, int base);
+};
+
+class Stream : public Print {
+public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+    size_t readBytes(uint8_t *buffer, size_t length);
+    size_t readBytes(char *buffer, size_t length) { return readBytes((uint8_t *)buffer, length); }
+    void setTimeout(unsigned long) {}
+};
+
+// Serial log, kept for tests to inspect; echoed to stdout when enabled
+class HardwareSerial : public Stream {
+public:
+    HardwareSerial() : echo(false) {}
+    void begin(unsigned long) {}
+    operator bool() const { return true; }
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+    const std::string &output() const { return log; }
+    void clearOutput() { log.clear(); }
+    void setEcho(bool on) { echo = on; }
+
+private:
+    std::string log;
+    bool echo;
+};
+extern HardwareSerial Serial;
+
+// The sketch entry points; a test calls them in place of the core's main()
+void setup();
+void loop();
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode);
+void detachInterrupt(uint8_t pin);
+void noInterrupts();
+void interrupts();
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+template <class T> T min(T a, T b) { return a < b ? a : b; }
+template <class T> T max(T a, T b) { return a > b ? a : b; }
+// A macro in the core, so the bounds may differ in type from the value
+template <class T, class L, class H> T constrain(T value, L low, H high) { return value < (T)low ? (T)low : (value > (T)high ? (T)high : value); }
+
+struct rst_info {
+    uint32_t reason;
+};
+#define REASON_DEFAULT_RST      0
+#define REASON_DEEP_SLEEP_AWAKE 5
+
+class EspClass {
+public:
+    // Host timestamp counter, so cycle-based benchmarks run unchanged
+    uint32_t getCycleCount();
+    uint32_t getCpuFreqMHz() { return 80; }
+    uint32_t getFreeHeap() { return 40000; }
+    uint32_t getMaxFreeBlockSize() { return 30000; }
+    uint8_t getHeapFragmentation() { return 10; }
+    bool rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size);
+    bool rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size);
+    rst_info *getResetInfoPtr() { return &resetInfo; }
+    uint32_t getChipId() { return 0x00C0FFEE; }
+
+    rst_info resetInfo;
+};
+extern EspClass ESP;
+
+// Test controls
+void fakeAdvanceMicros(unsigned long us);
+void fakeResetClock();
+void fakeSetPin(uint8_t pin, int level);  // Input level; fires an attached interrupt on its edge
+int fakePinMode(uint8_t pin);
+int fakeOutputLevel(uint8_t pin);          // Last digitalWrite() value
+bool fakeInterruptAttached(uint8_t pin);
+void fakeDetachInterruptSilently(uint8_t pin); // What the SDK does to a wake-up pin
+// A model driving a pin from the fake clock brings it up to date before each digitalRead()
+void fakeSetPinRefresh(uint8_t pin, void (*refresh)(void *context), void *context);
+
+#endif // FAKE_ARDUINO_H
@@ -0,0 +1,127 @@
+#include "ESP8266WebServer.h"
+
+void ESP8266WebServer::on(const String &uri, HTTPMethod method, THandlerFunction handler,
+                          THandlerFunction uploadHandler) {
+    Route route;
+    route.uri = uri.c_str();
+    route.method = method;
+    route.handler = handler;
+    route.uploadHandler = uploadHandler;
+    routes.push_back(route);
+}
+
+void ESP8266WebServer::send(int code, const char *contentType, const String &content) {
+    response.code = code;
+    response.contentType = contentType ? contentType : "";
+    response.headers.insert(pendingHeaders.begin(), pendingHeaders.end());
+    pendingHeaders.clear();
+    response.chunked = contentLength == CONTENT_LENGTH_UNKNOWN && content.length() == 0 && code != 304;
+    response.body.append(content.c_str(), content.length());
+}
+
+void ESP8266WebServer::send_P(int code, PGM_P contentType, PGM_P content, size_t length) {
+    send(code, contentType);
+    response.chunked = false;
+    response.body.append(content, length);
+}
+
+void ESP8266WebServer::sendHeader(const String &name, const String &value, bool first) {
+    pendingHeaders[name.c_str()] = value.c_str();
+}
+
+void ESP8266WebServer::sendContent(const char *content, size_t length) {
+    if (response.chunked && length == 0) {
+        response.finished = true;
+        return;
+    }
+    response.body.append(content, length);
+}
+
+String ESP8266WebServer::header(const String &name) const {
+    auto found = requestHeaders.find(name.c_str());
+    return found == requestHeaders.end() ? String() : String(found->second);
+}
+
+bool ESP8266WebServer::hasHeader(const String &name) const {
+    return requestHeaders.count(name.c_str()) != 0;
+}
+
+String ESP8266WebServer::arg(const String &name) const {
+    auto found = args.find(name.c_str());
+    return found == args.end() ? String() : String(found->second);
+}
+
+bool ESP8266WebServer::hasArg(const String &name) const {
+    return args.count(name.c_str()) != 0;
+}
+
+void ESP8266WebServer::startRequest(const char *uri, HTTPMethod method, const char *query) {
+    currentUri = uri;
+    currentMethod = method;
+    args.clear();
+    pendingHeaders.clear();
+    contentLength = CONTENT_LENGTH_UNKNOWN;
+    response = FakeResponse();
+    currentClient = WiFiClient(std::make_shared<FakeSocket>());
+
+    std::string rest = query ? query : "";
+    while (!rest.empty()) {
+        size_t end = rest.find('&');
+        std::string pair = rest.substr(0, end);
+        size_t equals = pair.find('=');
+        args[pair.substr(0, equals)] = equals == std::string::npos ? "" : pair.substr(equals + 1);
+        rest = end == std::string::npos ? "" : rest.substr(end + 1);
+    }
+}
+
+const ESP8266WebServer::Route *ESP8266WebServer::findRoute() const {
+    for (const Route &route : routes) {
+        if (route.uri == currentUri.c_str() && (route.method == HTTP_ANY || route.method == currentMethod)) {
+            return &route;
+        }
+    }
+    return 0;
+}
+
+const FakeResponse &ESP8266WebServer::fakeRequest(const char *uri, HTTPMethod method, const char *query,
+                                                  const std::map<std::string, std::string> &headers) {
+    startRequest(uri, method, query);
+    requestHeaders = headers;
+    const Route *route = findRoute();
+    if (route) {
+        route->handler();
+    } else if (notFound) {
+        notFound();
+    }
+    return response;
+}
+
+const FakeResponse &ESP8266WebServer::fakeUpload(const char *uri, const uint8_t *data, size_t length) {
+    startRequest(uri, HTTP_POST, "");
+    requestHeaders.clear();
+    const Route *route = findRoute();
+    if (!route) {
+        if (notFound) {
+            notFound();
+        }
+        return response;
+    }
+    if (route->uploadHandler) {
+        currentUpload.status = UPLOAD_FILE_START;
+        currentUpload.totalSize = 0;
+        currentUpload.currentSize = 0;
+        route->uploadHandler();
+        for (size_t offset = 0; offset < length; offset += HTTP_UPLOAD_BUFLEN) {
+            currentUpload.status = UPLOAD_FILE_WRITE;
+            currentUpload.currentSize = min(length - offset, (size_t)HTTP_UPLOAD_BUFLEN);
+            memcpy(currentUpload.buf, data + offset, currentUpload.currentSize);
+            currentUpload.totalSize += currentUpload.currentSize;
+            route->uploadHandler();
+        }
+        currentUpload.status = UPLOAD_FILE_END;
+        currentUpload.currentSize = 0;
+        route->uploadHandler();
+    }
+    route->handler();
+    return response;
+}
@@ -0,0 +1,105 @@
+#ifndef FAKE_ESP8266WEBSERVER_H
+#define FAKE_ESP8266WEBSERVER_H
+
+#include "Arduino.h"
+#include "ESP8266WiFi.h"
+#include <functional>
+#include <map>
+#include <vector>
+
+// Request routing and response capture for the native build. handleClient()
+// does nothing; a test drives a route with fakeRequest() (or fakeUpload()
+// for a POSTed file) and reads back the status, headers and body the
+// handler produced, chunked content included.
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+enum HTTPUploadStatus { UPLOAD_FILE_START, UPLOAD_FILE_WRITE, UPLOAD_FILE_END, UPLOAD_FILE_ABORTED };
+
+#define HTTP_UPLOAD_BUFLEN 2048
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+
+struct HTTPUpload {
+    HTTPUploadStatus status;
+    String filename;
+    String name;
+    String type;
+    size_t totalSize;
+    size_t currentSize;
+    uint8_t buf[HTTP_UPLOAD_BUFLEN];
+};
+
+struct FakeResponse {
+    int code = 0;              // 0 when the handler sent nothing
+    std::string contentType;
+    std::map<std::string, std::string> headers;
+    std::string body;
+    bool chunked = false;
+    bool finished = false;     // Chunked reply closed with an empty chunk
+};
+
+class ESP8266WebServer {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    explicit ESP8266WebServer(int port = 80) : port(port) {}
+
+    void on(const String &uri, THandlerFunction handler) { on(uri, HTTP_ANY, handler); }
+    void on(const String &uri, HTTPMethod method, THandlerFunction handler) { on(uri, method, handler, THandlerFunction()); }
+    void on(const String &uri, HTTPMethod method, THandlerFunction handler, THandlerFunction uploadHandler);
+    void onNotFound(THandlerFunction handler) { notFound = handler; }
+    void begin() { started = true; }
+    void handleClient() {}
+    void collectHeaders(const char *names[], size_t count) {}
+
+    void send(int code, const char *contentType = 0, const String &content = String());
+    void send(int code, const String &contentType, const String &content) { send(code, contentType.c_str(), content); }
+    void send_P(int code, PGM_P contentType, PGM_P content, size_t length);
+    void sendHeader(const String &name, const String &value, bool first = false);
+    void setContentLength(size_t length) { contentLength = length; }
+    void sendContent(const String &content) { sendContent(content.c_str(), content.length()); }
+    void sendContent(const char *content, size_t length);
+
+    String header(const String &name) const;
+    bool hasHeader(const String &name) const;
+    String arg(const String &name) const;
+    bool hasArg(const String &name) const;
+    const String &uri() const { return currentUri; }
+    HTTPMethod method() const { return currentMethod; }
+    HTTPUpload &upload() { return currentUpload; }
+    WiFiClient client() { return currentClient; }
+
+    // Test controls: run one request through the routes and return the reply.
+    // query is "a=1&b=2"; requestHeaders are sent as given.
+    const FakeResponse &fakeRequest(const char *uri, HTTPMethod method = HTTP_GET, const char *query = "",
+                                    const std::map<std::string, std::string> &requestHeaders = {});
+    const FakeResponse &fakeUpload(const char *uri, const uint8_t *data, size_t length);
+    std::shared_ptr<FakeSocket> fakeLastSocket() const { return currentClient.fakeSocket(); }
+    bool fakeStarted() const { return started; }
+
+private:
+    struct Route {
+        std::string uri;
+        HTTPMethod method;
+        THandlerFunction handler;
+        THandlerFunction uploadHandler;
+    };
+    std::vector<Route> routes;
+    THandlerFunction notFound;
+    int port;
+    bool started = false;
+
+    String currentUri;
+    HTTPMethod currentMethod = HTTP_GET;
+    std::map<std::string, std::string> args;
+    std::map<std::string, std::string> requestHeaders;
+    std::map<std::string, std::string> pendingHeaders;
+    size_t contentLength = CONTENT_LENGTH_UNKNOWN;
+    HTTPUpload currentUpload;
+    WiFiClient currentClient;
+    FakeResponse response;
+
+    void startRequest(const char *uri, HTTPMethod method, const char *query);
+    const Route *findRoute() const;
+};
+
+#endif // FAKE_ESP8266WEBSERVER_H
@@ -0,0 +1,22 @@
+#include "ESP8266WiFi.h"
+
+ESP8266WiFiClass WiFi;
+
+String IPAddress::toString() const {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+    return String(text);
+}
+
+int WiFiClient::availableForWrite() {
+    return socket && socket->connected ? socket->writeSpace : 0;
+}
+
+size_t WiFiClient::write(const uint8_t *buffer, size_t size) {
+    if (!socket || !socket->connected) {
+        return 0;
+    }
+    size = min(size, (size_t)max(socket->writeSpace, 0));
+    socket->sent.append((const char *)buffer, size);
+    return size;
+}
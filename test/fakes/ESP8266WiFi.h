@@ -0,0 +1,82 @@
+#ifndef FAKE_ESP8266WIFI_H
+#define FAKE_ESP8266WIFI_H
+
+#include "Arduino.h"
+#include <memory>
+
+// Soft-AP and client sockets for the native build. A WiFiClient shares its
+// state between copies like the core's does, so a test can keep a handle
+// to a client the firmware subscribed and read back what was written.
+
+class IPAddress : public Printable {
+public:
+    IPAddress() : octets{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : octets{a, b, c, d} {}
+    String toString() const;
+    uint8_t operator[](int index) const { return octets[index & 3]; }
+    size_t printTo(Print &out) const override { return out.print(toString()); }
+
+private:
+    uint8_t octets[4];
+};
+
+struct FakeSocket {
+    bool connected = true;
+    bool noDelay = false;
+    int writeSpace = 1460;  // What availableForWrite() reports
+    std::string sent;
+};
+
+class WiFiClient : public Stream {
+public:
+    WiFiClient() {}
+    explicit WiFiClient(std::shared_ptr<FakeSocket> socket) : socket(socket) {}
+
+    uint8_t connected() { return socket && socket->connected; }
+    void stop() { if (socket) socket->connected = false; }
+    void setNoDelay(bool on) { if (socket) socket->noDelay = on; }
+    int availableForWrite() override;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    explicit operator bool() const { return socket && socket->connected; }
+
+    // Test handle on the far end
+    std::shared_ptr<FakeSocket> fakeSocket() const { return socket; }
+
+private:
+    std::shared_ptr<FakeSocket> socket;
+};
+
+#define WIFI_OFF 0
+#define WIFI_STA 1
+#define WIFI_AP  2
+
+class ESP8266WiFiClass {
+public:
+    bool mode(int mode) { currentMode = mode; return true; }
+    int getMode() const { return currentMode; }
+    bool softAPConfig(IPAddress local, IPAddress gateway, IPAddress subnet) { apAddress = local; return true; }
+    bool softAP(const char *ssid, const char *password = 0) { apUp = true; return true; }
+    IPAddress softAPIP() const { return apAddress; }
+    uint8_t softAPgetStationNum() const { return stations; }
+    bool softAPdisconnect(bool wifiOff = false) { apUp = false; stations = 0; return true; }
+    bool forceSleepBegin() { asleep = true; return true; }
+    bool forceSleepWake() { asleep = false; return true; }
+
+    // Test controls
+    void fakeSetStations(uint8_t count) { stations = count; }
+    bool fakeApUp() const { return apUp; }
+    bool fakeAsleep() const { return asleep; }
+
+private:
+    int currentMode = WIFI_OFF;
+    IPAddress apAddress;
+    uint8_t stations = 0;
+    bool apUp = false;
+    bool asleep = false;
+};
+
+extern ESP8266WiFiClass WiFi;
+
+#endif // FAKE_ESP8266WIFI_H
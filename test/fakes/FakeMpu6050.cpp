@@ -0,0 +1,239 @@
+#include "FakeMpu6050.h"
+
+// Register addresses and bits, as in include/MPU6050_Raw.h
+#define R_SMPLRT_DIV   0x19
+#define R_CONFIG       0x1A
+#define R_FIFO_EN      0x23
+#define R_INT_ENABLE   0x38
+#define R_INT_STATUS   0x3A
+#define R_ACCEL_XOUT_H 0x3B
+#define R_USER_CTRL    0x6A
+#define R_PWR_MGMT_1   0x6B
+#define R_FIFO_COUNTH  0x72
+#define R_FIFO_COUNTL  0x73
+#define R_FIFO_R_W     0x74
+#define R_WHO_AM_I     0x75
+#define B_FIFO_EN_ACCEL    0x08
+#define B_USER_FIFO_EN     0x40
+#define B_USER_FIFO_RESET  0x04
+#define B_INT_FIFO_OFLOW   0x10
+#define FIFO_CAPACITY      1024
+
+FakeMpu6050::FakeMpu6050() {
+    intPin = -1;
+    reset();
+}
+
+void FakeMpu6050::reset() {
+    memset(registers, 0, sizeof(registers));
+    registers[R_WHO_AM_I] = 0x68;
+    registers[R_PWR_MGMT_1] = 0x40; // Asleep after power-on
+    pointer = 0;
+    fifo.clear();
+    autoSample = true;
+    lastSampleMicros = micros();
+    truncateTo = -1;
+    nackCount = 0;
+    fifoResets = 0;
+    samplesDropped = 0;
+    writes = 0;
+    reads = 0;
+    setAccel(0, 0, 4096); // At rest, +1g on Z at ±8g
+    updatePin();
+}
+
+void FakeMpu6050::setAccel(int16_t x, int16_t y, int16_t z) {
+    int16_t values[3] = { x, y, z };
+    for (int i = 0; i < 3; i++) {
+        registers[R_ACCEL_XOUT_H + 2 * i] = (uint16_t)values[i] >> 8;
+        registers[R_ACCEL_XOUT_H + 2 * i + 1] = values[i] & 0xFF;
+    }
+}
+
+void FakeMpu6050::setTemperature(int16_t raw) {
+    registers[R_ACCEL_XOUT_H + 6] = (uint16_t)raw >> 8;
+    registers[R_ACCEL_XOUT_H + 7] = raw & 0xFF;
+}
+
+void FakeMpu6050::setGyro(int16_t x, int16_t y, int16_t z) {
+    int16_t values[3] = { x, y, z };
+    for (int i = 0; i < 3; i++) {
+        registers[R_ACCEL_XOUT_H + 8 + 2 * i] = (uint16_t)values[i] >> 8;
+        registers[R_ACCEL_XOUT_H + 9 + 2 * i] = values[i] & 0xFF;
+    }
+}
+
+void FakeMpu6050::pushFifo(int16_t x, int16_t y, int16_t z) {
+    uint8_t bytes[6] = {
+        (uint8_t)((uint16_t)x >> 8), (uint8_t)(x & 0xFF),
+        (uint8_t)((uint16_t)y >> 8), (uint8_t)(y & 0xFF),
+        (uint8_t)((uint16_t)z >> 8), (uint8_t)(z & 0xFF),
+    };
+    appendFifo(bytes, sizeof(bytes));
+}
+
+void FakeMpu6050::pushFifoBytes(const uint8_t *data, size_t length) {
+    appendFifo(data, length);
+}
+
+void FakeMpu6050::appendFifo(const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (fifo.size() >= FIFO_CAPACITY) {
+            // Like the chip: the oldest byte is overwritten
+            fifo.pop_front();
+            samplesDropped++;
+            raise(B_INT_FIFO_OFLOW);
+        }
+        fifo.push_back(data[i]);
+    }
+}
+
+void FakeMpu6050::triggerMotion() {
+    raise(0x40);
+}
+
+void FakeMpu6050::raise(uint8_t bits) {
+    registers[R_INT_STATUS] |= bits;
+    updatePin();
+}
+
+void FakeMpu6050::updatePin() {
+    if (intPin >= 0) {
+        bool asserted = (registers[R_INT_STATUS] & registers[R_INT_ENABLE]) != 0;
+        fakeSetPin(intPin, asserted ? HIGH : LOW);
+    }
+}
+
+void FakeMpu6050::setIntPin(int pin) {
+    if (intPin >= 0) {
+        fakeSetPinRefresh(intPin, 0, 0);
+    }
+    intPin = pin;
+    if (intPin >= 0) {
+        // Data-ready follows the clock, so the pin is current when read
+        fakeSetPinRefresh(intPin, refreshPin, this);
+        updatePin();
+    }
+}
+
+void FakeMpu6050::refreshPin(void *context) {
+    static_cast<FakeMpu6050 *>(context)->sampleUntilNow();
+}
+
+uint32_t FakeMpu6050::samplePeriodMicros() const {
+    // Gyro output rate is 1kHz with the DLPF on, 8kHz without
+    uint32_t base = (registers[R_CONFIG] & 0x07) ? 1000 : 125;
+    return base * (1 + registers[R_SMPLRT_DIV]);
+}
+
+void FakeMpu6050::sampleUntilNow() {
+    unsigned long now = micros();
+    uint32_t period = samplePeriodMicros();
+    bool sampling = autoSample && !(registers[R_PWR_MGMT_1] & 0x40);
+    while (now - lastSampleMicros >= period) {
+        lastSampleMicros += period;
+        if (!sampling) {
+            continue;
+        }
+        if ((registers[R_USER_CTRL] & B_USER_FIFO_EN) && (registers[R_FIFO_EN] & B_FIFO_EN_ACCEL)) {
+            appendFifo(&registers[R_ACCEL_XOUT_H], 6);
+        }
+        raise(DATA_READY);
+    }
+}
+
+bool FakeMpu6050::receive(const uint8_t *data, size_t length) {
+    sampleUntilNow();
+    if (nackCount > 0) {
+        nackCount--;
+        return false;
+    }
+    if (length == 0) {
+        return true; // Address-only probe
+    }
+    pointer = data[0] & 0x7F;
+    for (size_t i = 1; i < length; i++) {
+        writeRegister(pointer, data[i]);
+        if (pointer != R_FIFO_R_W) {
+            pointer = (pointer + 1) & 0x7F;
+        }
+    }
+    return true;
+}
+
+size_t FakeMpu6050::transmit(uint8_t *data, size_t length) {
+    sampleUntilNow();
+    reads++;
+    if (truncateTo >= 0) {
+        length = min(length, (size_t)truncateTo);
+        truncateTo = -1;
+    }
+    for (size_t i = 0; i < length; i++) {
+        data[i] = readRegister(pointer);
+        if (pointer != R_FIFO_R_W) {
+            pointer = (pointer + 1) & 0x7F;
+        }
+    }
+    return length;
+}
+
+void FakeMpu6050::writeRegister(uint8_t address, uint8_t value) {
+    writes++;
+    switch (address) {
+        case R_USER_CTRL:
+            if (value & B_USER_FIFO_RESET) {
+                // Takes effect only while the FIFO is disabled; self-clearing
+                if (!(registers[R_USER_CTRL] & B_USER_FIFO_EN) || !(value & B_USER_FIFO_EN)) {
+                    fifo.clear();
+                    fifoResets++;
+                }
+                value &= ~B_USER_FIFO_RESET;
+            }
+            registers[address] = value;
+            break;
+        case R_INT_ENABLE:
+            registers[address] = value;
+            updatePin();
+            break;
+        case R_INT_STATUS:
+        case R_FIFO_COUNTH:
+        case R_FIFO_COUNTL:
+        case R_WHO_AM_I:
+            break; // Read-only
+        case R_FIFO_R_W:
+            appendFifo(&value, 1);
+            break;
+        case R_PWR_MGMT_1:
+            registers[address] = value & ~0x80; // DEVICE_RESET self-clears
+            lastSampleMicros = micros();
+            break;
+        default:
+            registers[address] = value;
+            break;
+    }
+}
+
+uint8_t FakeMpu6050::readRegister(uint8_t address) {
+    switch (address) {
+        case R_FIFO_COUNTH:
+            return fifo.size() >> 8;
+        case R_FIFO_COUNTL:
+            return fifo.size() & 0xFF;
+        case R_FIFO_R_W: {
+            if (fifo.empty()) {
+                return 0xFF;
+            }
+            uint8_t value = fifo.front();
+            fifo.pop_front();
+            return value;
+        }
+        case R_INT_STATUS: {
+            uint8_t value = registers[R_INT_STATUS];
+            registers[R_INT_STATUS] = 0;
+            updatePin();
+            return value;
+        }
+        default:
+            return registers[address];
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef FAKE_MPU6050_H
+#define FAKE_MPU6050_H
+
+#include "Wire.h"
+#include <deque>
+
+// Register map of an MPU6050 behind the fake Wire bus. Writes land in the
+// registers (auto-incrementing like the chip); reads of FIFO_R_W pop the
+// FIFO and FIFO_COUNTH/L report its depth. The FIFO fills itself at the
+// configured sample rate as fake time passes, with the current accel
+// reading, unless the test turns that off and scripts the contents with
+// pushFifo(). INT_STATUS bits raise the INT pin (when one is wired) while
+// their INT_ENABLE bit is set; reading INT_STATUS clears them.
+class FakeMpu6050 : public FakeI2CDevice {
+public:
+    static const uint8_t DATA_READY = 0x01;  // INT_STATUS / INT_ENABLE bit 0
+
+    FakeMpu6050();
+
+    bool receive(const uint8_t *data, size_t length) override;
+    size_t transmit(uint8_t *data, size_t length) override;
+
+    // Test controls
+    void reset();
+    void setAccel(int16_t x, int16_t y, int16_t z);
+    void setGyro(int16_t x, int16_t y, int16_t z);
+    void setTemperature(int16_t raw);
+    void setAutoSample(bool on) { autoSample = on; }
+    void pushFifo(int16_t x, int16_t y, int16_t z);
+    void pushFifoBytes(const uint8_t *data, size_t length);
+    void setIntPin(int pin);  // -1: INT not wired
+    void triggerMotion();
+    void truncateNextRead(size_t bytes) { truncateTo = (int)bytes; }
+    void nackWrites(uint8_t count) { nackCount = count; }
+
+    uint8_t reg(uint8_t address) const { return registers[address & 0x7F]; }
+    void setReg(uint8_t address, uint8_t value) { registers[address & 0x7F] = value; }
+    size_t fifoDepth() const { return fifo.size(); }
+    uint32_t getFifoResets() const { return fifoResets; }
+    uint32_t getSamplesDropped() const { return samplesDropped; }
+    uint32_t getWrites() const { return writes; }
+    uint32_t getReads() const { return reads; }
+
+private:
+    uint8_t registers[128];
+    uint8_t pointer;
+    std::deque<uint8_t> fifo;
+    bool autoSample;
+    unsigned long lastSampleMicros;
+    int intPin;
+    int truncateTo;
+    uint8_t nackCount;
+    uint32_t fifoResets;
+    uint32_t samplesDropped;
+    uint32_t writes;
+    uint32_t reads;
+
+    uint32_t samplePeriodMicros() const;
+    void sampleUntilNow();
+    static void refreshPin(void *context);
+    void writeRegister(uint8_t address, uint8_t value);
+    uint8_t readRegister(uint8_t address);
+    void appendFifo(const uint8_t *data, size_t length);
+    void raise(uint8_t bits);
+    void updatePin();
+};
+
+#endif // FAKE_MPU6050_H
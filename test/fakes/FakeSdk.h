@@ -0,0 +1,11 @@
+#ifndef FAKE_SDK_H
+#define FAKE_SDK_H
+
+#include <stdint.h>
+
+// Test view of the SDK calls faked in esp_sdk.cpp
+uint32_t fakeLightSleepCount();
+uint32_t fakeLastSleepMicros(); // Requested timeout; 0xFFFFFFF sleeps until the wake pin
+int fakeWakePin();              // -1 when no wake-up is armed
+
+#endif // FAKE_SDK_H
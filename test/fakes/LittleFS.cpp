@@ -0,0 +1,141 @@
+#include "LittleFS.h"
+
+FS LittleFS;
+
+File::File(const std::string &path, std::shared_ptr<FakeFileData> data, bool writable, bool append)
+    : path(path), data(data), position_(append ? data->bytes.size() : 0), writable(writable) {
+}
+
+size_t File::write(const uint8_t *buffer, size_t size) {
+    if (!data || !writable) {
+        return 0;
+    }
+    if (position_ + size > data->bytes.size()) {
+        data->bytes.resize(position_ + size);
+    }
+    memcpy(data->bytes.data() + position_, buffer, size);
+    position_ += size;
+    return size;
+}
+
+int File::available() {
+    if (!data) {
+        return 0;
+    }
+    size_t end = min(data->bytes.size(), data->readLimit);
+    return position_ < end ? end - position_ : 0;
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+    return available() > 0 ? data->bytes[position_] : -1;
+}
+
+size_t File::read(uint8_t *buffer, size_t size) {
+    if (data && data->readsLeft == 0) {
+        return 0;
+    }
+    if (data && data->readsLeft > 0) {
+        data->readsLeft--;
+    }
+    size_t count = min(size, (size_t)available());
+    if (count > 0) {
+        memcpy(buffer, data->bytes.data() + position_, count);
+        position_ += count;
+    }
+    return count;
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!data) {
+        return false;
+    }
+    size_t target = pos;
+    if (mode == SeekCur) {
+        target = position_ + pos;
+    } else if (mode == SeekEnd) {
+        target = data->bytes.size() - pos;
+    }
+    if (target > data->bytes.size()) {
+        return false;
+    }
+    position_ = target;
+    return true;
+}
+
+File FS::open(const char *path, const char *mode) {
+    std::string name(path);
+    bool write = mode[0] == 'w';
+    bool append = mode[0] == 'a';
+    bool update = strchr(mode, '+') != 0;
+    if (write || ((append || update) && !files.count(name))) {
+        if (mode[0] == 'r') {
+            return File();
+        }
+        files[name] = std::make_shared<FakeFileData>();
+    } else if (!files.count(name)) {
+        return File();
+    }
+    if (write || append || update) {
+        writeOpens[name]++;
+    }
+    return File(name, files[name], write || append || update, append);
+}
+
+bool FS::rename(const char *from, const char *to) {
+    auto found = files.find(from);
+    if (found == files.end()) {
+        return false;
+    }
+    files[to] = found->second;
+    files.erase(found);
+    return true;
+}
+
+bool FS::info(FSInfo &info) const {
+    size_t used = 0;
+    for (const auto &file : files) {
+        used += (file.second->bytes.size() + 4095) / 4096 * 4096;
+    }
+    info.totalBytes = 1024 * 1024;
+    info.usedBytes = used;
+    info.blockSize = 4096;
+    info.pageSize = 256;
+    info.maxOpenFiles = 5;
+    info.maxPathLength = 32;
+    return true;
+}
+
+void FS::fakeLoad(const char *path, const std::vector<uint8_t> &bytes) {
+    auto data = std::make_shared<FakeFileData>();
+    data->bytes = bytes;
+    files[path] = data;
+}
+
+std::vector<uint8_t> FS::fakeContents(const char *path) const {
+    auto found = files.find(path);
+    return found == files.end() ? std::vector<uint8_t>() : found->second->bytes;
+}
+
+uint32_t FS::fakeWriteOpens(const char *path) const {
+    auto found = writeOpens.find(path);
+    return found == writeOpens.end() ? 0 : found->second;
+}
+
+void FS::fakeLimitReads(const char *path, size_t offset) {
+    auto found = files.find(path);
+    if (found != files.end()) {
+        found->second->readLimit = offset;
+    }
+}
+
+void FS::fakeFailReadsAfter(const char *path, long reads) {
+    auto found = files.find(path);
+    if (found != files.end()) {
+        found->second->readsLeft = reads;
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef FAKE_LITTLEFS_H
+#define FAKE_LITTLEFS_H
+
+#include "Arduino.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+// In-memory file system with the LittleFS API. Tests can load and inspect
+// files, count how often a path was opened for writing and make reads come
+// back short past a given offset, as a failing flash would.
+struct FakeFileData {
+    std::vector<uint8_t> bytes;
+    size_t readLimit;     // Reads stop at this offset
+    long readsLeft;       // Reads that succeed before all come back empty; -1 = no limit
+    FakeFileData() : readLimit((size_t)-1), readsLeft(-1) {}
+};
+
+class File : public Stream {
+public:
+    File() : position_(0), writable(false) {}
+    File(const std::string &path, std::shared_ptr<FakeFileData> data, bool writable, bool append);
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t read(uint8_t *buffer, size_t size);
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const { return position_; }
+    size_t size() const { return data ? data->bytes.size() : 0; }
+    void close() { data.reset(); }
+    void flush() override {}
+    operator bool() const { return data != nullptr; }
+    const char *name() const { return path.c_str(); }
+
+private:
+    std::string path;
+    std::shared_ptr<FakeFileData> data;
+    size_t position_;
+    bool writable;
+};
+
+struct FSInfo {
+    size_t totalBytes;
+    size_t usedBytes;
+    size_t blockSize;
+    size_t pageSize;
+    size_t maxOpenFiles;
+    size_t maxPathLength;
+};
+
+class FS {
+public:
+    FS() : mounted(false) {}
+
+    bool begin() { mounted = true; return true; }
+    void end() { mounted = false; }
+    bool format() { files.clear(); return true; }
+    File open(const char *path, const char *mode);
+    bool exists(const char *path) const { return files.count(path) != 0; }
+    bool remove(const char *path) { return files.erase(path) != 0; }
+    bool rename(const char *from, const char *to);
+    bool info(FSInfo &info) const;
+
+    // Test controls
+    void fakeClear() { files.clear(); writeOpens.clear(); }
+    void fakeLoad(const char *path, const std::vector<uint8_t> &bytes);
+    std::vector<uint8_t> fakeContents(const char *path) const;
+    uint32_t fakeWriteOpens(const char *path) const;
+    void fakeLimitReads(const char *path, size_t offset);
+    void fakeFailReadsAfter(const char *path, long reads); // -1 lifts it
+
+private:
+    bool mounted;
+    std::map<std::string, std::shared_ptr<FakeFileData> > files;
+    std::map<std::string, uint32_t> writeOpens;
+};
+
+extern FS LittleFS;
+
+#endif // FAKE_LITTLEFS_H
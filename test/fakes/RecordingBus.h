@@ -0,0 +1,90 @@
+#ifndef RECORDING_BUS_H
+#define RECORDING_BUS_H
+
+#include "I2CBus.h"
+#include "Wire.h"
+#include <vector>
+
+// Bus policy for MPU6050<Bus> that logs every register transaction and
+// answers it from a device model (usually a FakeMpu6050), so a test can
+// assert the exact traffic a driver call produces. failNext() makes the
+// next transactions fail with a given status before reaching the device.
+struct BusRecord {
+    char op;          // 'W' write, 'R' read, 'P' probe
+    uint8_t address;  // Device address (probes) or register
+    uint8_t value;    // Value written, or bytes requested
+    I2CStatus status;
+
+    bool operator==(const BusRecord &other) const {
+        return op == other.op && address == other.address && value == other.value && status == other.status;
+    }
+};
+
+inline BusRecord busWrite(uint8_t reg, uint8_t value) { return BusRecord{ 'W', reg, value, I2C_OK }; }
+inline BusRecord busRead(uint8_t reg, uint8_t length) { return BusRecord{ 'R', reg, length, I2C_OK }; }
+inline BusRecord busProbe(uint8_t address) { return BusRecord{ 'P', address, 0, I2C_OK }; }
+
+struct RecordingBus {
+    static inline FakeI2CDevice *device = 0;
+    static inline uint8_t deviceAddress = 0;
+    static inline std::vector<BusRecord> log;
+    static inline I2CStatus failStatus = I2C_OK;
+    static inline uint8_t failCount = 0;
+    static inline uint8_t clients = 0;
+
+    static void attach(uint8_t address, FakeI2CDevice *model) {
+        deviceAddress = address;
+        device = model;
+        log.clear();
+        failCount = 0;
+        clients = 0;
+    }
+    static void failNext(I2CStatus status, uint8_t count = 1) {
+        failStatus = status;
+        failCount = count;
+    }
+
+    static int8_t registerClient(const char *name, uint8_t address, uint32_t maxClock) {
+        return clients < I2C_MAX_CLIENTS ? clients++ : I2C_NO_CLIENT;
+    }
+    static I2CStatus writeRegister(int8_t client, uint8_t reg, uint8_t value) {
+        I2CStatus status = injected();
+        if (status == I2C_OK) {
+            uint8_t bytes[2] = { reg, value };
+            status = device->receive(bytes, 2) ? I2C_OK : I2C_NACK_DATA;
+        }
+        log.push_back(BusRecord{ 'W', reg, value, status });
+        return status;
+    }
+    static I2CStatus readRegisters(int8_t client, uint8_t reg, uint8_t *buffer, uint8_t length) {
+        I2CStatus status = injected();
+        if (status == I2C_OK) {
+            if (!device->receive(&reg, 1)) {
+                status = I2C_NACK_DATA;
+            } else if (device->transmit(buffer, length) != length) {
+                status = I2C_SHORT_READ;
+            }
+        }
+        log.push_back(BusRecord{ 'R', reg, length, status });
+        return status;
+    }
+    static bool probe(uint8_t address) {
+        bool found = device && address == deviceAddress && device->receive(0, 0);
+        log.push_back(BusRecord{ 'P', address, 0, found ? I2C_OK : I2C_NACK_ADDRESS });
+        return found;
+    }
+
+private:
+    static I2CStatus injected() {
+        if (!device) {
+            return I2C_NACK_ADDRESS;
+        }
+        if (failCount > 0) {
+            failCount--;
+            return failStatus;
+        }
+        return I2C_OK;
+    }
+};
+
+#endif // RECORDING_BUS_H
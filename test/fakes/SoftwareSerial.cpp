@@ -0,0 +1,18 @@
+#include "SoftwareSerial.h"
+
+size_t SoftwareSerial::write(const uint8_t *data, size_t length) {
+    tx.insert(tx.end(), data, data + length);
+    if (peer) {
+        peer(*this, data, length);
+    }
+    return length;
+}
+
+int SoftwareSerial::read() {
+    if (rx.empty()) {
+        return -1;
+    }
+    uint8_t c = rx.front();
+    rx.pop_front();
+    return c;
+}
@@ -0,0 +1,49 @@
+#ifndef FAKE_SOFTWARE_SERIAL_H
+#define FAKE_SOFTWARE_SERIAL_H
+
+#include "Arduino.h"
+#include <deque>
+#include <vector>
+
+// Serial link to a scripted peer. What the firmware writes is kept in
+// sent(); bytes the peer puts in with inject() are read back in order. A
+// peer callback, if set, sees every write and can answer straight away.
+// As on the ESP8266, nothing is received on GPIO16: it has no pin-change
+// interrupt, so injected bytes are dropped there.
+class SoftwareSerial : public Stream {
+public:
+    typedef void (*PeerCallback)(SoftwareSerial &link, const uint8_t *data, size_t length);
+
+    SoftwareSerial(int rxPin, int txPin) : rxPin(rxPin), txPin(txPin), baud(0), peer(0) {}
+
+    void begin(unsigned long speed) { baud = speed; }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *data, size_t length) override;
+    using Print::write;
+    int available() override { return rx.size(); }
+    int read() override;
+    int peek() override { return rx.empty() ? -1 : rx.front(); }
+
+    // Test controls
+    void inject(const uint8_t *data, size_t length) {
+        if (canReceive()) {
+            rx.insert(rx.end(), data, data + length);
+        }
+    }
+    bool canReceive() const { return rxPin != 16; }
+    void setPeer(PeerCallback callback) { peer = callback; }
+    std::vector<uint8_t> &sent() { return tx; }
+    int getRxPin() const { return rxPin; }
+    int getTxPin() const { return txPin; }
+    unsigned long getBaud() const { return baud; }
+
+private:
+    int rxPin;
+    int txPin;
+    unsigned long baud;
+    PeerCallback peer;
+    std::vector<uint8_t> tx;
+    std::deque<uint8_t> rx;
+};
+
+#endif // FAKE_SOFTWARE_SERIAL_H
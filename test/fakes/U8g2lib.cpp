@@ -0,0 +1,305 @@
+#include "U8g2lib.h"
+#include "Wire.h"
+
+const u8g2_cb_p U8G2_R0 = 0;
+
+// Only its address is used: setFont() stores it
+const uint8_t u8g2_font_6x10_tf[] = { 0 };
+
+#define DRAW_UPPER_RIGHT 0x01
+#define DRAW_UPPER_LEFT  0x02
+#define DRAW_LOWER_LEFT  0x04
+#define DRAW_LOWER_RIGHT 0x08
+
+// Printable ASCII, 5 columns per glyph, bit 0 at the top
+static const uint8_t glyphs[95][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00},
+    {0x14, 0x7F, 0x14, 0x7F, 0x14}, {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+    {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00}, {0x00, 0x1C, 0x22, 0x41, 0x00},
+    {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x08, 0x2A, 0x1C, 0x2A, 0x08}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+    {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00},
+    {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+    {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31}, {0x18, 0x14, 0x12, 0x7F, 0x10},
+    {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+    {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x36, 0x36, 0x00, 0x00},
+    {0x00, 0x56, 0x36, 0x00, 0x00}, {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14},
+    {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06}, {0x32, 0x49, 0x79, 0x41, 0x3E},
+    {0x7E, 0x11, 0x11, 0x11, 0x7E}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+    {0x7F, 0x41, 0x41, 0x22, 0x1C}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x09, 0x01},
+    {0x3E, 0x41, 0x49, 0x49, 0x7A}, {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00},
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, {0x7F, 0x40, 0x40, 0x40, 0x40},
+    {0x7F, 0x02, 0x0C, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46},
+    {0x46, 0x49, 0x49, 0x49, 0x31}, {0x01, 0x01, 0x7F, 0x01, 0x01}, {0x3F, 0x40, 0x40, 0x40, 0x3F},
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F}, {0x63, 0x14, 0x08, 0x14, 0x63},
+    {0x07, 0x08, 0x70, 0x08, 0x07}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x00},
+    {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7F, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04},
+    {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78},
+    {0x7F, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, {0x38, 0x44, 0x44, 0x48, 0x7F},
+    {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7E, 0x09, 0x01, 0x02}, {0x0C, 0x52, 0x52, 0x52, 0x3E},
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3D, 0x00},
+    {0x7F, 0x10, 0x28, 0x44, 0x00}, {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x18, 0x04, 0x78},
+    {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0x7C, 0x14, 0x14, 0x14, 0x08},
+    {0x08, 0x14, 0x14, 0x18, 0x7C}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20},
+    {0x04, 0x3F, 0x44, 0x40, 0x20}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C},
+    {0x3C, 0x40, 0x30, 0x40, 0x3C}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0C, 0x50, 0x50, 0x50, 0x3C},
+    {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x7F, 0x00, 0x00},
+    {0x00, 0x41, 0x36, 0x08, 0x00}, {0x08, 0x04, 0x08, 0x10, 0x08}
+};
+
+U8G2::U8G2() {
+    memset(buffer, 0, sizeof(buffer));
+    memset(panel, 0, sizeof(panel));
+    font = 0;
+    drawColor = 1;
+    bitmapMode = 0;
+    powerSave = false;
+    busClock = 0;
+    tilesSent = 0;
+    begins = 0;
+    cursorX = 0;
+    cursorY = 0;
+}
+
+bool U8G2::begin() {
+    // The real begin() restarts Wire from its byte callback (U8X8_MSG_BYTE_INIT),
+    // which resets the core's stretch limit, then sends the init sequence at
+    // the bus clock; it also clears the panel and wakes it up
+    begins++;
+    Wire.begin();
+    if (busClock) {
+        Wire.setClock(busClock);
+    }
+    clearBuffer();
+    memset(panel, 0, sizeof(panel));
+    powerSave = false;
+    return true;
+}
+
+void U8G2::sendBuffer() {
+    updateDisplayArea(0, 0, getBufferTileWidth(), getBufferTileHeight());
+}
+
+void U8G2::updateDisplayArea(uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th) {
+    for (uint8_t row = ty; row < ty + th && row < getBufferTileHeight(); row++) {
+        for (uint8_t tile = tx; tile < tx + tw && tile < getBufferTileWidth(); tile++) {
+            size_t offset = row * FAKE_U8G2_WIDTH + tile * 8;
+            memcpy(panel + offset, buffer + offset, 8);
+            tilesSent++;
+        }
+    }
+}
+
+bool U8G2::getPixel(int x, int y) const {
+    if (x < 0 || y < 0 || x >= FAKE_U8G2_WIDTH || y >= FAKE_U8G2_HEIGHT) {
+        return false;
+    }
+    return (buffer[(y / 8) * FAKE_U8G2_WIDTH + x] >> (y % 8)) & 1;
+}
+
+void U8G2::setPixel(int x, int y, uint8_t color) {
+    if (x < 0 || y < 0 || x >= FAKE_U8G2_WIDTH || y >= FAKE_U8G2_HEIGHT) {
+        return;
+    }
+    uint8_t &cell = buffer[(y / 8) * FAKE_U8G2_WIDTH + x];
+    uint8_t mask = 1 << (y % 8);
+    if (color == 0) {
+        cell &= ~mask;
+    } else if (color == 1) {
+        cell |= mask;
+    } else {
+        cell ^= mask;
+    }
+}
+
+void U8G2::drawPixel(int x, int y) {
+    setPixel(x, y, drawColor);
+}
+
+void U8G2::drawHLine(int x, int y, int w) {
+    for (int i = 0; i < w; i++) {
+        drawPixel(x + i, y);
+    }
+}
+
+void U8G2::drawVLine(int x, int y, int h) {
+    for (int i = 0; i < h; i++) {
+        drawPixel(x, y + i);
+    }
+}
+
+void U8G2::drawBox(int x, int y, int w, int h) {
+    for (int i = 0; i < h; i++) {
+        drawHLine(x, y + i, w);
+    }
+}
+
+void U8G2::drawFrame(int x, int y, int w, int h) {
+    drawHLine(x, y, w);
+    drawHLine(x, y + h - 1, w);
+    drawVLine(x, y, h);
+    drawVLine(x + w - 1, y, h);
+}
+
+void U8G2::drawLine(int x1, int y1, int x2, int y2) {
+    // u8g2_DrawLine
+    int dx = x1 > x2 ? x1 - x2 : x2 - x1;
+    int dy = y1 > y2 ? y1 - y2 : y2 - y1;
+    bool swapxy = false;
+    if (dy > dx) {
+        swapxy = true;
+        int tmp = dx; dx = dy; dy = tmp;
+        tmp = x1; x1 = y1; y1 = tmp;
+        tmp = x2; x2 = y2; y2 = tmp;
+    }
+    if (x1 > x2) {
+        int tmp = x1; x1 = x2; x2 = tmp;
+        tmp = y1; y1 = y2; y2 = tmp;
+    }
+    int err = dx >> 1;
+    int ystep = y2 > y1 ? 1 : -1;
+    int y = y1;
+    for (int x = x1; x <= x2; x++) {
+        if (swapxy) {
+            drawPixel(y, x);
+        } else {
+            drawPixel(x, y);
+        }
+        err -= dy;
+        if (err < 0) {
+            y += ystep;
+            err += dx;
+        }
+    }
+}
+
+void U8G2::drawCircleSection(int x, int y, int x0, int y0, uint8_t option) {
+    if (option & DRAW_UPPER_RIGHT) {
+        drawPixel(x0 + x, y0 - y);
+        drawPixel(x0 + y, y0 - x);
+    }
+    if (option & DRAW_UPPER_LEFT) {
+        drawPixel(x0 - x, y0 - y);
+        drawPixel(x0 - y, y0 - x);
+    }
+    if (option & DRAW_LOWER_RIGHT) {
+        drawPixel(x0 + x, y0 + y);
+        drawPixel(x0 + y, y0 + x);
+    }
+    if (option & DRAW_LOWER_LEFT) {
+        drawPixel(x0 - x, y0 + y);
+        drawPixel(x0 - y, y0 + x);
+    }
+}
+
+void U8G2::drawCircle(int x0, int y0, int radius, uint8_t option) {
+    // u8g2_draw_circle: midpoint algorithm, one octant mirrored
+    int f = 1 - radius;
+    int ddFx = 1;
+    int ddFy = -2 * radius;
+    int x = 0;
+    int y = radius;
+    drawCircleSection(x, y, x0, y0, option);
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddFy += 2;
+            f += ddFy;
+        }
+        x++;
+        ddFx += 2;
+        f += ddFx;
+        drawCircleSection(x, y, x0, y0, option);
+    }
+}
+
+void U8G2::drawDiscSection(int x, int y, int x0, int y0, uint8_t option) {
+    if (option & DRAW_UPPER_RIGHT) {
+        drawVLine(x0 + x, y0 - y, y + 1);
+        drawVLine(x0 + y, y0 - x, x + 1);
+    }
+    if (option & DRAW_UPPER_LEFT) {
+        drawVLine(x0 - x, y0 - y, y + 1);
+        drawVLine(x0 - y, y0 - x, x + 1);
+    }
+    if (option & DRAW_LOWER_RIGHT) {
+        drawVLine(x0 + x, y0, y + 1);
+        drawVLine(x0 + y, y0, x + 1);
+    }
+    if (option & DRAW_LOWER_LEFT) {
+        drawVLine(x0 - x, y0, y + 1);
+        drawVLine(x0 - y, y0, x + 1);
+    }
+}
+
+void U8G2::drawDisc(int x0, int y0, int radius, uint8_t option) {
+    int f = 1 - radius;
+    int ddFx = 1;
+    int ddFy = -2 * radius;
+    int x = 0;
+    int y = radius;
+    drawDiscSection(x, y, x0, y0, option);
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddFy += 2;
+            f += ddFy;
+        }
+        x++;
+        ddFx += 2;
+        f += ddFx;
+        drawDiscSection(x, y, x0, y0, option);
+    }
+}
+
+void U8G2::drawXBM(int x, int y, int w, int h, const uint8_t *bitmap) {
+    // XBM rows, LSB first; bitmap mode 1 leaves clear bits transparent
+    int rowBytes = (w + 7) / 8;
+    for (int row = 0; row < h; row++) {
+        for (int col = 0; col < w; col++) {
+            bool set = (bitmap[row * rowBytes + col / 8] >> (col % 8)) & 1;
+            if (set) {
+                setPixel(x + col, y + row, drawColor);
+            } else if (bitmapMode == 0) {
+                setPixel(x + col, y + row, drawColor == 0 ? 1 : 0);
+            }
+        }
+    }
+}
+
+int U8G2::drawGlyph(int x, int y, uint16_t encoding) {
+    // Baseline at y, 7 rows above it
+    if (encoding >= 32 && encoding < 127) {
+        const uint8_t *columns = glyphs[encoding - 32];
+        for (int col = 0; col < 5; col++) {
+            for (int row = 0; row < 7; row++) {
+                if ((columns[col] >> row) & 1) {
+                    drawPixel(x + col, y - 7 + row);
+                }
+            }
+        }
+    }
+    return 6;
+}
+
+int U8G2::drawStr(int x, int y, const char *text) {
+    int start = x;
+    while (*text) {
+        x += drawGlyph(x, y, (uint8_t)*text++);
+    }
+    return x - start;
+}
+
+int U8G2::getStrWidth(const char *text) const {
+    return 6 * strlen(text);
+}
+
+size_t U8G2::write(uint8_t c) {
+    if (c == '\n') {
+        cursorX = 0;
+        cursorY += 10;
+    } else if (c != '\r') {
+        cursorX += drawGlyph(cursorX, cursorY, c);
+    }
+    return 1;
+}
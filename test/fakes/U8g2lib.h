@@ -0,0 +1,103 @@
+#ifndef FAKE_U8G2LIB_H
+#define FAKE_U8G2LIB_H
+
+#include "Arduino.h"
+
+// Software U8g2 for the native build: a 128x64 full buffer in the SH1106
+// tile layout (8 pages of 128 bytes, LSB at the top), with the primitives
+// the firmware uses. Lines and circles follow U8g2's own algorithms, so
+// frames match the device; text uses a built-in 5x7 face in 6-pixel cells,
+// which has the 6x10 font's advance but not its exact glyph shapes. The
+// panel behind the bus is modelled too: updateDisplayArea() and
+// sendBuffer() copy tiles to it and count what was sent. begin() restarts
+// Wire like the real hardware-I2C byte callback does.
+
+#define U8X8_PIN_NONE 255
+#define FAKE_U8G2_WIDTH  128
+#define FAKE_U8G2_HEIGHT 64
+#define FAKE_U8G2_BUFFER_SIZE (FAKE_U8G2_WIDTH * FAKE_U8G2_HEIGHT / 8)
+
+typedef const struct u8g2_cb_struct *u8g2_cb_p;
+extern const u8g2_cb_p U8G2_R0;
+
+extern const uint8_t u8g2_font_6x10_tf[];
+
+class U8G2 : public Print {
+public:
+    U8G2();
+
+    bool begin();
+    void setBusClock(uint32_t clock) { busClock = clock; }
+    void setPowerSave(uint8_t on) { powerSave = on != 0; }
+    void setFont(const uint8_t *font) { this->font = font; }
+    void setDrawColor(uint8_t color) { drawColor = color; }
+    void setBitmapMode(uint8_t mode) { bitmapMode = mode; }
+    void setFontMode(uint8_t mode) {}
+
+    void clearBuffer() { memset(buffer, 0, sizeof(buffer)); }
+    void sendBuffer();
+    void updateDisplay() { sendBuffer(); }
+    void updateDisplayArea(uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th);
+
+    void drawPixel(int x, int y);
+    void drawHLine(int x, int y, int w);
+    void drawVLine(int x, int y, int h);
+    void drawLine(int x1, int y1, int x2, int y2);
+    void drawBox(int x, int y, int w, int h);
+    void drawFrame(int x, int y, int w, int h);
+    void drawCircle(int x0, int y0, int radius, uint8_t option = 0x0F);
+    void drawDisc(int x0, int y0, int radius, uint8_t option = 0x0F);
+    void drawXBM(int x, int y, int w, int h, const uint8_t *bitmap);
+    void drawXBMP(int x, int y, int w, int h, const uint8_t *bitmap) { drawXBM(x, y, w, h, bitmap); }
+    int drawStr(int x, int y, const char *text);
+    int drawGlyph(int x, int y, uint16_t encoding);
+    int getStrWidth(const char *text) const;
+    int8_t getMaxCharWidth() const { return 6; }
+    int8_t getAscent() const { return 7; }
+    int8_t getDescent() const { return -2; }
+
+    uint8_t *getBufferPtr() { return buffer; }
+    uint8_t getBufferTileWidth() const { return FAKE_U8G2_WIDTH / 8; }
+    uint8_t getBufferTileHeight() const { return FAKE_U8G2_HEIGHT / 8; }
+    uint16_t getDisplayWidth() const { return FAKE_U8G2_WIDTH; }
+    uint16_t getDisplayHeight() const { return FAKE_U8G2_HEIGHT; }
+
+    // Print draws at a cursor like the real class
+    void setCursor(int x, int y) { cursorX = x; cursorY = y; }
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+    // Test view of the panel
+    bool getPixel(int x, int y) const;
+    const uint8_t *getPanel() const { return panel; }
+    bool isPowerSave() const { return powerSave; }
+    uint32_t getBusClock() const { return busClock; }
+    uint32_t getTilesSent() const { return tilesSent; }
+    uint32_t getBeginCount() const { return begins; }
+    void resetCounters() { tilesSent = 0; }
+
+private:
+    uint8_t buffer[FAKE_U8G2_BUFFER_SIZE];
+    uint8_t panel[FAKE_U8G2_BUFFER_SIZE];
+    const uint8_t *font;
+    uint8_t drawColor;
+    uint8_t bitmapMode;
+    bool powerSave;
+    uint32_t busClock;
+    uint32_t tilesSent;
+    uint32_t begins;
+    int cursorX;
+    int cursorY;
+
+    void setPixel(int x, int y, uint8_t color);
+    void drawCircleSection(int x, int y, int x0, int y0, uint8_t option);
+    void drawDiscSection(int x, int y, int x0, int y0, uint8_t option);
+};
+
+class U8G2_SH1106_128X64_NONAME_F_HW_I2C : public U8G2 {
+public:
+    U8G2_SH1106_128X64_NONAME_F_HW_I2C(u8g2_cb_p rotation, uint8_t reset = U8X8_PIN_NONE,
+                                       uint8_t clock = U8X8_PIN_NONE, uint8_t data = U8X8_PIN_NONE) {}
+};
+
+#endif // FAKE_U8G2LIB_H
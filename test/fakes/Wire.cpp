@@ -0,0 +1,129 @@
+#include "Wire.h"
+
+TwoWire Wire;
+
+TwoWire::TwoWire() {
+    deviceCount = 0;
+    txAddress = 0;
+    txLength = 0;
+    rxLength = 0;
+    rxIndex = 0;
+    clock = 100000;
+    stretchLimit = 150000;
+    stretchPerByte = 0;
+    failStatus = 0;
+    failCount = 0;
+    busHeld = false;
+    begins = 0;
+    transfers = 0;
+}
+
+void TwoWire::begin(int sda, int scl) {
+    begin();
+}
+
+void TwoWire::begin() {
+    // Like twi_init(): back to the core's default clock and stretch limit
+    begins++;
+    clock = 100000;
+    stretchLimit = 150000;
+}
+
+void TwoWire::attach(uint8_t address, FakeI2CDevice *device) {
+    for (uint8_t i = 0; i < deviceCount; i++) {
+        if (devices[i].address == address) {
+            devices[i].device = device;
+            return;
+        }
+    }
+    if (deviceCount < sizeof(devices) / sizeof(devices[0])) {
+        devices[deviceCount].address = address;
+        devices[deviceCount].device = device;
+        deviceCount++;
+    }
+}
+
+void TwoWire::detachAll() {
+    deviceCount = 0;
+    failCount = 0;
+    busHeld = false;
+    stretchPerByte = 0;
+}
+
+void TwoWire::failNext(uint8_t status, uint8_t count) {
+    failStatus = status;
+    failCount = count;
+}
+
+FakeI2CDevice *TwoWire::find(uint8_t address) const {
+    for (uint8_t i = 0; i < deviceCount; i++) {
+        if (devices[i].address == address) {
+            return devices[i].device;
+        }
+    }
+    return 0;
+}
+
+void TwoWire::spend(size_t bytes) {
+    // Nine clocks per byte (data + ACK), plus start and stop
+    uint32_t clocks = bytes * 9 + 2;
+    fakeAdvanceMicros((clocks * 1000000UL + clock - 1) / clock + bytes * min(stretchPerByte, stretchLimit * 9));
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    txAddress = address;
+    txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (txLength >= BUFFER_LENGTH) {
+        return 0;
+    }
+    txBuffer[txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t length) {
+    size_t written = 0;
+    while (written < length && write(data[written])) {
+        written++;
+    }
+    return written;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    transfers++;
+    if (busHeld) {
+        fakeAdvanceMicros(stretchLimit);
+        return 4;
+    }
+    if (failCount > 0) {
+        failCount--;
+        spend(1);
+        return failStatus;
+    }
+    FakeI2CDevice *device = find(txAddress);
+    if (!device) {
+        spend(1);
+        return 2;
+    }
+    spend(1 + txLength);
+    return device->receive(txBuffer, txLength) ? 0 : 3;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool sendStop) {
+    transfers++;
+    rxLength = 0;
+    rxIndex = 0;
+    if (quantity > BUFFER_LENGTH) {
+        quantity = BUFFER_LENGTH;
+    }
+    FakeI2CDevice *device = busHeld ? 0 : find(address);
+    if (!device) {
+        spend(1);
+        return 0;
+    }
+    rxLength = device->transmit(rxBuffer, quantity);
+    spend(1 + rxLength);
+    return rxLength;
+}
@@ -0,0 +1,91 @@
+#ifndef FAKE_WIRE_H
+#define FAKE_WIRE_H
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH 128 // Same as the ESP8266 core
+
+// A device model on the fake bus. receive() gets the bytes of one write
+// (register address first) and returns false to NACK them; transmit() fills
+// a read and returns how many bytes the device supplied.
+class FakeI2CDevice {
+public:
+    virtual ~FakeI2CDevice() {}
+    virtual bool receive(const uint8_t *data, size_t length) = 0;
+    virtual size_t transmit(uint8_t *data, size_t length) = 0;
+};
+
+// A device that ACKs everything and reads as zeros (the display's address)
+class FakeAckDevice : public FakeI2CDevice {
+public:
+    bool receive(const uint8_t *data, size_t length) override { return true; }
+    size_t transmit(uint8_t *data, size_t length) override { memset(data, 0, length); return length; }
+};
+
+// Wire with the ESP8266 core's return codes (0 OK, 2 address NACK, 3 data
+// NACK, 4 bus error). Each transfer advances the fake clock by its length
+// in SCL clocks at the selected speed, plus any stretching set by the test.
+// begin() resets the clock and the stretch limit, as twi_init() does.
+class TwoWire : public Stream {
+public:
+    TwoWire();
+
+    void begin(int sda, int scl);
+    void begin();
+    void setClock(uint32_t frequency) { clock = frequency; }
+    void setClockStretchLimit(uint32_t limit) { stretchLimit = limit; }
+
+    void beginTransmission(uint8_t address);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+    uint8_t requestFrom(int address, int quantity) { return requestFrom((uint8_t)address, (uint8_t)quantity); }
+
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t *data, size_t length) override;
+    using Print::write;
+    int available() override { return rxLength - rxIndex; }
+    int read() override { return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1; }
+    int peek() override { return rxIndex < rxLength ? rxBuffer[rxIndex] : -1; }
+
+    // Test controls
+    void attach(uint8_t address, FakeI2CDevice *device);
+    void detachAll();
+    void failNext(uint8_t status, uint8_t count = 1); // Next endTransmission()s return status
+    void setHeld(bool held) { busHeld = held; }        // Bus error until released
+    void setStretchPerByte(uint32_t us) { stretchPerByte = us; }
+    uint32_t getClock() const { return clock; }
+    uint32_t getStretchLimit() const { return stretchLimit; }
+    uint32_t getBeginCount() const { return begins; }
+    uint32_t getTransferCount() const { return transfers; }
+
+private:
+    struct Slot {
+        uint8_t address;
+        FakeI2CDevice *device;
+    };
+    Slot devices[8];
+    uint8_t deviceCount;
+
+    uint8_t txAddress;
+    uint8_t txBuffer[BUFFER_LENGTH];
+    size_t txLength;
+    uint8_t rxBuffer[BUFFER_LENGTH];
+    size_t rxLength;
+    size_t rxIndex;
+
+    uint32_t clock;
+    uint32_t stretchLimit;
+    uint32_t stretchPerByte;
+    uint8_t failStatus;
+    uint8_t failCount;
+    bool busHeld;
+    uint32_t begins;
+    uint32_t transfers;
+
+    FakeI2CDevice *find(uint8_t address) const;
+    void spend(size_t bytes);
+};
+
+extern TwoWire Wire;
+
+#endif // FAKE_WIRE_H
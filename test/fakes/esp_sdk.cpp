@@ -0,0 +1,57 @@
+#include "Arduino.h"
+#include "FakeSdk.h"
+
+extern "C" {
+#include "user_interface.h"
+#include "gpio.h"
+}
+
+static uint32_t lightSleeps = 0;
+static uint32_t lastSleepMicros = 0;
+static int wakePin = -1;
+
+bool wifi_set_opmode_current(uint8_t mode) {
+    return true;
+}
+
+void wifi_fpm_set_sleep_type(sleep_type type) {
+}
+
+void wifi_fpm_open() {
+}
+
+void wifi_fpm_close() {
+}
+
+int8_t wifi_fpm_do_sleep(uint32_t us) {
+    lightSleeps++;
+    lastSleepMicros = us;
+    return 0;
+}
+
+void wifi_fpm_set_wakeup_cb(void (*callback)(void)) {
+}
+
+void gpio_pin_wakeup_enable(uint32_t pin, GPIO_INT_TYPE type) {
+    wakePin = pin;
+    fakeDetachInterruptSilently(pin);
+}
+
+void gpio_pin_wakeup_disable() {
+    if (wakePin >= 0) {
+        fakeDetachInterruptSilently(wakePin);
+        wakePin = -1;
+    }
+}
+
+uint32_t fakeLightSleepCount() {
+    return lightSleeps;
+}
+
+uint32_t fakeLastSleepMicros() {
+    return lastSleepMicros;
+}
+
+int fakeWakePin() {
+    return wakePin;
+}
@@ -0,0 +1,22 @@
+#ifndef FAKE_GPIO_H
+#define FAKE_GPIO_H
+
+#include <stdint.h>
+
+#define GPIO_ID_PIN(n) (n)
+
+enum GPIO_INT_TYPE {
+    GPIO_PIN_INTR_DISABLE,
+    GPIO_PIN_INTR_POSEDGE,
+    GPIO_PIN_INTR_NEGEDGE,
+    GPIO_PIN_INTR_ANYEDGE,
+    GPIO_PIN_INTR_LOLEVEL,
+    GPIO_PIN_INTR_HILEVEL
+};
+
+// Like the SDK, both calls replace the pin's interrupt type: a handler set
+// with attachInterrupt() is gone after gpio_pin_wakeup_disable()
+void gpio_pin_wakeup_enable(uint32_t pin, GPIO_INT_TYPE type);
+void gpio_pin_wakeup_disable();
+
+#endif // FAKE_GPIO_H
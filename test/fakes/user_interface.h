@@ -0,0 +1,18 @@
+#ifndef FAKE_USER_INTERFACE_H
+#define FAKE_USER_INTERFACE_H
+
+#include <stdint.h>
+
+// ESP8266 SDK calls behind forced light sleep. The sleep itself is the
+// delay() that follows; the fake only records what was requested.
+#define NULL_MODE 0
+enum sleep_type { NONE_SLEEP_T = 0, LIGHT_SLEEP_T, MODEM_SLEEP_T };
+
+bool wifi_set_opmode_current(uint8_t mode);
+void wifi_fpm_set_sleep_type(sleep_type type);
+void wifi_fpm_open();
+void wifi_fpm_close();
+int8_t wifi_fpm_do_sleep(uint32_t us);
+void wifi_fpm_set_wakeup_cb(void (*callback)(void));
+
+#endif // FAKE_USER_INTERFACE_H
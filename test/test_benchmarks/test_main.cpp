@@ -0,0 +1,37 @@
+// Host run of the firmware microbenchmarks (pio test -e native_benchmarks).
+// Cycle counts come from the host timestamp counter, so only the ratios
+// between variants carry over to the ESP8266; absolute numbers do not.
+#include <unity.h>
+#include <Arduino.h>
+#include <Wire.h>
+#include <FakeMpu6050.h>
+#include "magic8ball.h"
+#include "MPU6050_Raw.h"
+
+extern bool bootComplete;
+
+static FakeMpu6050 sensor;
+static FakeAckDevice panel;
+
+void setUp() {}
+void tearDown() {}
+
+void test_benchmarks_run() {
+    // As on the device, the benchmarks run once boot completes, so the
+    // catalog, display and sensor are all up; the log goes to stdout
+    Wire.attach(MPU6050_ALT_ADDR, &sensor);
+    Wire.attach(SCREEN_ADDRESS, &panel);
+    Serial.setEcho(true);
+    setup();
+    while (!bootComplete) {
+        loop();
+    }
+    Serial.setEcho(false);
+    TEST_ASSERT_TRUE(Serial.output().find("=== BENCHMARKS ===") != std::string::npos);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_benchmarks_run);
+    return UNITY_END();
+}
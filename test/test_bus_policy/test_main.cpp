@@ -0,0 +1,166 @@
+// Exact register traffic of the MPU6050 driver, through a recording bus
+// policy instead of the shared i2cBus
+#include <unity.h>
+#include <Arduino.h>
+#include <FakeMpu6050.h>
+#include <RecordingBus.h>
+#include "MPU6050_impl.h"
+
+static FakeMpu6050 sensor;
+static MPU6050<RecordingBus> *mpu;
+
+static void assertTraffic(const BusRecord *expected, size_t count) {
+    char message[80];
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(count, RecordingBus::log.size(), "transaction count");
+    for (size_t i = 0; i < count; i++) {
+        const BusRecord &actual = RecordingBus::log[i];
+        snprintf(message, sizeof(message), "transaction %u: %c 0x%02X 0x%02X", (unsigned)i,
+                 actual.op, actual.address, actual.value);
+        TEST_ASSERT_TRUE_MESSAGE(actual == expected[i], message);
+    }
+}
+
+void setUp() {
+    sensor.reset();
+    sensor.setAutoSample(false);
+    RecordingBus::attach(MPU6050_ALT_ADDR, &sensor);
+    static MPU6050<RecordingBus> instance(MPU6050_ALT_ADDR);
+    instance = MPU6050<RecordingBus>(MPU6050_ALT_ADDR);
+    mpu = &instance;
+}
+
+void tearDown() {}
+
+void test_begin_traffic() {
+    TEST_ASSERT_TRUE(mpu->begin());
+    const BusRecord expected[] = {
+        busProbe(MPU6050_ALT_ADDR),
+        busRead(WHO_AM_I, 1),
+        busWrite(PWR_MGMT_1, 0x00),
+        busRead(PWR_MGMT_1, 1),
+        busWrite(ACCEL_CONFIG, MPU6050_DEFAULT_RANGE << 3),
+        busRead(ACCEL_CONFIG, 1),
+        busWrite(GYRO_CONFIG, MPU6050_DEFAULT_GYRO_RANGE << 3),
+        busRead(GYRO_CONFIG, 1),
+    };
+    assertTraffic(expected, sizeof(expected) / sizeof(expected[0]));
+    TEST_ASSERT_EQUAL_UINT8(0x00, sensor.reg(PWR_MGMT_1));
+    TEST_ASSERT_EQUAL_UINT8(MPU6050_DEFAULT_RANGE, mpu->getAccelerometerRange());
+}
+
+void test_begin_fails_without_device() {
+    RecordingBus::attach(MPU6050_DEFAULT_ADDR, &sensor); // Sensor answers elsewhere
+    TEST_ASSERT_FALSE(mpu->begin());
+    const BusRecord expected[] = {
+        BusRecord{ 'P', MPU6050_ALT_ADDR, 0, I2C_NACK_ADDRESS },
+    };
+    assertTraffic(expected, 1);
+}
+
+void test_enable_fifo_traffic() {
+    mpu->begin();
+    RecordingBus::log.clear();
+    TEST_ASSERT_TRUE(mpu->enableFifo());
+    const BusRecord expected[] = {
+        busWrite(FIFO_EN, FIFO_EN_ACCEL),
+        busWrite(USER_CTRL, USER_CTRL_FIFO_RESET),
+        busWrite(USER_CTRL, USER_CTRL_FIFO_EN),
+        busRead(USER_CTRL, 1),
+        busRead(INT_STATUS, 1),
+    };
+    assertTraffic(expected, sizeof(expected) / sizeof(expected[0]));
+    TEST_ASSERT_TRUE(mpu->isFifoEnabled());
+}
+
+void test_enable_motion_interrupt_traffic() {
+    mpu->begin();
+    RecordingBus::log.clear();
+    TEST_ASSERT_TRUE(mpu->enableMotionInterrupt(40, 20));
+    const BusRecord expected[] = {
+        busRead(ACCEL_CONFIG, 1),
+        busWrite(ACCEL_CONFIG, (MPU6050_DEFAULT_RANGE << 3) | ACCEL_HPF_5HZ),
+        busWrite(MOT_THR, 40),
+        busWrite(MOT_DUR, 20),
+        busWrite(INT_PIN_CFG, INT_PIN_CFG_LATCH),
+        busWrite(INT_ENABLE, INT_ENABLE_MOT),
+        busRead(INT_ENABLE, 1),
+        busRead(MOT_THR, 1),
+        busRead(INT_STATUS, 1),
+    };
+    assertTraffic(expected, sizeof(expected) / sizeof(expected[0]));
+}
+
+// Acknowledges writes of a non-zero value to one register without storing
+// them, like a chip that missed the configuration
+struct DroppedWrite : FakeI2CDevice {
+    FakeMpu6050 *inner;
+    uint8_t reg;
+    bool receive(const uint8_t *data, size_t length) override {
+        if (length == 2 && data[0] == reg && data[1] != 0) {
+            return true;
+        }
+        return inner->receive(data, length);
+    }
+    size_t transmit(uint8_t *data, size_t length) override { return inner->transmit(data, length); }
+};
+
+void test_enable_motion_interrupt_rolls_back_on_mismatch() {
+    mpu->begin();
+    DroppedWrite dropping;
+    dropping.inner = &sensor;
+    dropping.reg = INT_ENABLE;
+    RecordingBus::device = &dropping;
+    RecordingBus::log.clear();
+
+    TEST_ASSERT_FALSE(mpu->enableMotionInterrupt(40, 20));
+    const BusRecord &last = RecordingBus::log.back();
+    TEST_ASSERT_TRUE(last == busWrite(INT_ENABLE, 0x00));
+    TEST_ASSERT_EQUAL_HEX8(0x00, sensor.reg(INT_ENABLE));
+    RecordingBus::device = &sensor;
+}
+
+void test_read_motion_raw_traffic() {
+    mpu->begin();
+    sensor.setAccel(0x0123, -2, 4096);
+    sensor.setTemperature(-340);
+    sensor.setGyro(100, -100, 0x7FFF);
+    RecordingBus::log.clear();
+
+    MotionSample sample;
+    TEST_ASSERT_TRUE(mpu->readMotionRaw(sample));
+    const BusRecord expected[] = {
+        busRead(ACCEL_XOUT_H, MOTION_BURST_LENGTH),
+    };
+    assertTraffic(expected, 1);
+    TEST_ASSERT_EQUAL_INT16(0x0123, sample.accel.x);
+    TEST_ASSERT_EQUAL_INT16(-2, sample.accel.y);
+    TEST_ASSERT_EQUAL_INT16(4096, sample.accel.z);
+    TEST_ASSERT_EQUAL_INT16(-340, sample.temperature);
+    TEST_ASSERT_EQUAL_INT16(100, sample.gyroX);
+    TEST_ASSERT_EQUAL_INT16(-100, sample.gyroY);
+    TEST_ASSERT_EQUAL_INT16(0x7FFF, sample.gyroZ);
+}
+
+void test_read_motion_raw_reports_status() {
+    mpu->begin();
+    RecordingBus::log.clear();
+    RecordingBus::failNext(I2C_TIMEOUT);
+
+    MotionSample sample;
+    TEST_ASSERT_FALSE(mpu->readMotionRaw(sample));
+    TEST_ASSERT_EQUAL(I2C_TIMEOUT, mpu->getLastStatus());
+    TEST_ASSERT_EQUAL_INT16(0, sample.accel.z);
+    TEST_ASSERT_EQUAL_UINT32(1, RecordingBus::log.size());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_traffic);
+    RUN_TEST(test_begin_fails_without_device);
+    RUN_TEST(test_enable_fifo_traffic);
+    RUN_TEST(test_enable_motion_interrupt_traffic);
+    RUN_TEST(test_enable_motion_interrupt_rolls_back_on_mismatch);
+    RUN_TEST(test_read_motion_raw_traffic);
+    RUN_TEST(test_read_motion_raw_reports_status);
+    return UNITY_END();
+}
@@ -0,0 +1,238 @@
+// DFPlayerQueue against a scripted serial peer standing in for the module:
+// ACK pacing, ACK timeouts and the fallback, busy retries, status messages,
+// and BUSY-pin pacing when replies cannot be received (RX on GPIO16)
+#include <unity.h>
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+#include <vector>
+#include "DFPlayerQueue.h"
+
+#define BUSY_PIN D6
+
+// What the scripted module does with each command it receives
+enum PeerMode { PEER_ACK, PEER_SILENT, PEER_BUSY_ONCE };
+
+static PeerMode peerMode;
+static bool peerDrivesBusy;
+static std::vector<uint8_t> received; // Command bytes in arrival order
+static std::vector<bool> ackRequested;
+static bool busyErrorSent;
+
+static void frame(uint8_t out[DFPLAYER_FRAME_LENGTH], uint8_t command, uint16_t param) {
+    uint8_t bytes[DFPLAYER_FRAME_LENGTH] = { 0x7E, 0xFF, 0x06, command, 0, (uint8_t)(param >> 8), (uint8_t)param, 0, 0, 0xEF };
+    uint16_t sum = 0;
+    for (int i = 1; i < 7; i++) {
+        sum += bytes[i];
+    }
+    sum = -sum;
+    bytes[7] = sum >> 8;
+    bytes[8] = sum & 0xFF;
+    memcpy(out, bytes, DFPLAYER_FRAME_LENGTH);
+}
+
+static void reply(SoftwareSerial &link, uint8_t command, uint16_t param) {
+    uint8_t out[DFPLAYER_FRAME_LENGTH];
+    frame(out, command, param);
+    link.inject(out, sizeof(out));
+}
+
+static void peer(SoftwareSerial &link, const uint8_t *data, size_t length) {
+    TEST_ASSERT_EQUAL_UINT32(DFPLAYER_FRAME_LENGTH, length);
+    uint8_t command = data[3];
+    received.push_back(command);
+    ackRequested.push_back(data[4] == 1);
+
+    if (peerDrivesBusy) {
+        if (command == DFPLAYER_CMD_PLAY_TRACK) {
+            fakeSetPin(BUSY_PIN, LOW);
+        } else if (command == DFPLAYER_CMD_STOP) {
+            fakeSetPin(BUSY_PIN, HIGH);
+        }
+    }
+    if (data[4] != 1) {
+        return;
+    }
+    if (peerMode == PEER_BUSY_ONCE && !busyErrorSent) {
+        busyErrorSent = true;
+        reply(link, DFPLAYER_MSG_ERROR, DFPLAYER_ERROR_BUSY);
+    } else if (peerMode != PEER_SILENT) {
+        reply(link, DFPLAYER_MSG_ACK, 0);
+    }
+}
+
+static SoftwareSerial *link;
+static DFPlayerQueue *player;
+
+static void serviceFor(unsigned long ms) {
+    unsigned long end = millis() + ms;
+    do {
+        player->service();
+        delay(1);
+    } while ((long)(millis() - end) < 0);
+}
+
+static void start(int rxPin, bool receives, int8_t busyPin) {
+    delete link;
+    link = new SoftwareSerial(rxPin, D3);
+    link->setPeer(peer);
+    delete player;
+    player = new DFPlayerQueue();
+    player->begin(*link, receives, busyPin);
+}
+
+void setUp() {
+    fakeResetClock();
+    peerMode = PEER_ACK;
+    peerDrivesBusy = false;
+    busyErrorSent = false;
+    received.clear();
+    ackRequested.clear();
+    fakeSetPin(BUSY_PIN, HIGH);
+    start(D7, true, DFPLAYER_NO_BUSY_PIN);
+}
+
+void tearDown() {}
+
+void test_acks_pace_commands() {
+    player->send(DFPLAYER_CMD_VOLUME, 20);
+    player->send(DFPLAYER_CMD_EQ, 0);
+    player->send(DFPLAYER_CMD_OUTPUT, 2);
+    // The ACK arrives with the command, so each service() sends the next
+    player->service();
+    player->service();
+    player->service();
+    player->service();
+    TEST_ASSERT_EQUAL_UINT32(3, received.size());
+    TEST_ASSERT_EQUAL_UINT32(3, player->getAckCount());
+    TEST_ASSERT_EQUAL_UINT32(0, player->getTimeoutCount());
+    TEST_ASSERT_TRUE(player->isIdle());
+    TEST_ASSERT_TRUE(ackRequested[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, millis());
+}
+
+void test_timeout_then_falls_back_to_gap() {
+    peerMode = PEER_SILENT;
+    for (int i = 0; i < 5; i++) {
+        player->send(DFPLAYER_CMD_VOLUME, i);
+    }
+    player->service();
+    TEST_ASSERT_EQUAL_UINT32(1, received.size());
+    serviceFor(DFPLAYER_ACK_TIMEOUT - 1);
+    TEST_ASSERT_EQUAL_UINT32(1, received.size()); // Still waiting for the ACK
+    serviceFor(2);
+    TEST_ASSERT_EQUAL_UINT32(1, player->getTimeoutCount());
+    TEST_ASSERT_EQUAL_UINT32(2, received.size());
+
+    // Three misses with no ACK ever: stop asking, send on a fixed gap
+    serviceFor(2 * DFPLAYER_ACK_TIMEOUT + 5);
+    TEST_ASSERT_EQUAL_UINT32(DFPLAYER_MAX_MISSED_ACKS, player->getTimeoutCount());
+    TEST_ASSERT_FALSE(player->isAckSupported());
+    TEST_ASSERT_EQUAL_UINT32(4, received.size());
+    TEST_ASSERT_FALSE(ackRequested[3]);
+    serviceFor(DFPLAYER_NO_ACK_GAP);
+    TEST_ASSERT_EQUAL_UINT32(5, received.size());
+    TEST_ASSERT_EQUAL_UINT32(DFPLAYER_MAX_MISSED_ACKS, player->getTimeoutCount());
+}
+
+void test_busy_error_is_retried() {
+    peerMode = PEER_BUSY_ONCE;
+    player->play(1);
+    player->service();
+    player->service();
+    TEST_ASSERT_EQUAL_UINT32(1, player->getErrorCount());
+    TEST_ASSERT_EQUAL_HEX8(DFPLAYER_ERROR_BUSY, player->getLastError());
+    TEST_ASSERT_FALSE(player->isIdle());
+    serviceFor(DFPLAYER_BUSY_RETRY + 2);
+    TEST_ASSERT_EQUAL_UINT32(2, received.size());
+    TEST_ASSERT_EQUAL_HEX8(DFPLAYER_CMD_PLAY_TRACK, received[1]);
+    TEST_ASSERT_EQUAL_UINT32(1, player->getAckCount());
+    TEST_ASSERT_TRUE(player->isPlaying());
+}
+
+void test_finished_message_ends_track() {
+    player->play(2);
+    player->service();
+    TEST_ASSERT_TRUE(player->isPlaying());
+    reply(*link, DFPLAYER_MSG_SD_FINISHED, 2);
+    player->service();
+    TEST_ASSERT_FALSE(player->isPlaying());
+    TEST_ASSERT_EQUAL_UINT32(1, player->getFinishedCount());
+}
+
+void test_play_replaces_queued_play() {
+    peerMode = PEER_SILENT;
+    player->send(DFPLAYER_CMD_VOLUME, 20); // In flight, waiting for its ACK
+    player->service();
+    player->play(1);
+    player->play(2);
+    TEST_ASSERT_EQUAL_UINT32(1, player->getReplacedCount());
+    serviceFor(DFPLAYER_ACK_TIMEOUT + 1);
+    TEST_ASSERT_EQUAL_UINT32(2, received.size());
+    TEST_ASSERT_EQUAL_HEX8(DFPLAYER_CMD_PLAY_TRACK, received[1]);
+    TEST_ASSERT_EQUAL_UINT8(2, link->sent()[DFPLAYER_FRAME_LENGTH + 6]);
+}
+
+void test_rx_on_gpio16_paces_on_busy_pin() {
+    // The board's wiring: the module's replies never arrive
+    start(D0, false, BUSY_PIN);
+    peerDrivesBusy = true;
+    player->send(DFPLAYER_CMD_VOLUME, 20);
+    player->play(1);
+    player->service();
+    TEST_ASSERT_FALSE(ackRequested[0]);
+    TEST_ASSERT_EQUAL(0, link->available());
+
+    serviceFor(DFPLAYER_NO_ACK_GAP + 1);
+    TEST_ASSERT_EQUAL_UINT32(2, received.size());
+    TEST_ASSERT_TRUE(player->isPlaying());
+    serviceFor(DFPLAYER_NO_ACK_GAP + 1);
+    TEST_ASSERT_TRUE(player->isIdle());
+    TEST_ASSERT_EQUAL_UINT32(0, player->getTimeoutCount());
+
+    // The track ends: BUSY goes back high
+    fakeSetPin(BUSY_PIN, HIGH);
+    player->service();
+    TEST_ASSERT_FALSE(player->isPlaying());
+    TEST_ASSERT_EQUAL_UINT32(1, player->getFinishedCount());
+}
+
+void test_play_waits_for_busy() {
+    start(D0, false, BUSY_PIN);
+    player->play(1);
+    player->send(DFPLAYER_CMD_VOLUME, 10);
+    player->service();
+
+    // The card is slow: BUSY only follows after 300ms, and the next
+    // command waits for it rather than going out after the fixed gap
+    serviceFor(300);
+    TEST_ASSERT_EQUAL_UINT32(1, received.size());
+    TEST_ASSERT_FALSE(player->isIdle());
+    fakeSetPin(BUSY_PIN, LOW);
+    serviceFor(2);
+    TEST_ASSERT_EQUAL_UINT32(2, received.size());
+    TEST_ASSERT_TRUE(player->isPlaying());
+}
+
+void test_busy_timeout_when_play_fails() {
+    start(D0, false, BUSY_PIN);
+    player->play(9); // No such file: BUSY never goes low
+    player->service();
+    serviceFor(DFPLAYER_BUSY_TIMEOUT + 1);
+    TEST_ASSERT_EQUAL_UINT32(1, player->getTimeoutCount());
+    TEST_ASSERT_FALSE(player->isPlaying());
+    TEST_ASSERT_TRUE(player->isIdle());
+    TEST_ASSERT_EQUAL_UINT32(0, player->getFinishedCount());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_acks_pace_commands);
+    RUN_TEST(test_timeout_then_falls_back_to_gap);
+    RUN_TEST(test_busy_error_is_retried);
+    RUN_TEST(test_finished_message_ends_track);
+    RUN_TEST(test_play_replaces_queued_play);
+    RUN_TEST(test_rx_on_gpio16_paces_on_busy_pin);
+    RUN_TEST(test_play_waits_for_busy);
+    RUN_TEST(test_busy_timeout_when_play_fails);
+    return UNITY_END();
+}
@@ -0,0 +1,103 @@
+// EventStream against fake sockets: the largest answer event reaches a
+// listener that has just connected, oversized events are counted rather
+// than sent, and a listener that stops reading is dropped.
+#include <unity.h>
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <memory>
+#include <string>
+#include "EventStream.h"
+
+static EventStream *stream;
+
+static std::shared_ptr<FakeSocket> connect(bool wantsAccel = false) {
+    std::shared_ptr<FakeSocket> socket = std::make_shared<FakeSocket>();
+    WiFiClient client(socket);
+    TEST_ASSERT_TRUE(stream->subscribe(client, wantsAccel));
+    return socket;
+}
+
+// An answer made only of quotes doubles in length when escaped
+static std::string largestAnswerData() {
+    std::string data = "{\"response\":\"";
+    for (int i = 0; i < CATALOG_MAX_ENTRY_LENGTH; i++) {
+        data += "\\\"";
+    }
+    data += "\",\"source\":\"button\"}";
+    return data;
+}
+
+void setUp() {
+    fakeResetClock();
+    stream = new EventStream();
+}
+
+void tearDown() {
+    delete stream;
+}
+
+void test_largest_answer_reaches_new_listener() {
+    std::string data = largestAnswerData();
+    TEST_ASSERT_LESS_OR_EQUAL(EVENT_MAX_DATA_LENGTH, (int)data.size());
+    std::shared_ptr<FakeSocket> socket = connect();
+
+    // Published before the response head has gone out
+    stream->publish("answer", data.c_str());
+    stream->service();
+
+    TEST_ASSERT_EQUAL(1, stream->getClientCount());
+    TEST_ASSERT_EQUAL(0, (int)stream->getDroppedClientCount());
+    TEST_ASSERT_EQUAL(0, (int)stream->getDroppedEventCount());
+    std::string expected = "event: answer\ndata: " + data + "\n\n";
+    TEST_ASSERT_TRUE(socket->sent.find(expected) != std::string::npos);
+}
+
+void test_oversized_event_is_counted_not_sent() {
+    std::shared_ptr<FakeSocket> socket = connect();
+    stream->service();
+    size_t before = socket->sent.size();
+
+    std::string data(EVENT_MAX_TEXT_LENGTH, 'x');
+    stream->publish("answer", data.c_str());
+    stream->service();
+
+    TEST_ASSERT_EQUAL(1, (int)stream->getDroppedEventCount());
+    TEST_ASSERT_EQUAL(0, (int)stream->getEventCount());
+    TEST_ASSERT_EQUAL(1, stream->getClientCount());
+    TEST_ASSERT_EQUAL(before, socket->sent.size());
+}
+
+void test_accel_events_only_go_to_accel_listeners() {
+    std::shared_ptr<FakeSocket> plain = connect(false);
+    std::shared_ptr<FakeSocket> accel = connect(true);
+    AccelSample sample = { 0, 0, 4096 };
+    fakeAdvanceMicros(EVENT_ACCEL_INTERVAL * 1000UL);
+    stream->publishAccel(sample, 2);
+    stream->service();
+
+    TEST_ASSERT_TRUE(accel->sent.find("event: accel\ndata: [0,0,1000]") != std::string::npos);
+    TEST_ASSERT_TRUE(plain->sent.find("event: accel") == std::string::npos);
+}
+
+void test_listener_that_stops_reading_is_dropped() {
+    std::shared_ptr<FakeSocket> socket = connect();
+    socket->writeSpace = 0;
+    std::string data = largestAnswerData();
+    for (int i = 0; i < 3; i++) {
+        stream->publish("answer", data.c_str());
+        stream->service();
+    }
+
+    TEST_ASSERT_EQUAL(0, stream->getClientCount());
+    TEST_ASSERT_EQUAL(1, (int)stream->getDroppedClientCount());
+    TEST_ASSERT_FALSE(socket->connected);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_largest_answer_reaches_new_listener);
+    RUN_TEST(test_oversized_event_is_counted_not_sent);
+    RUN_TEST(test_accel_events_only_go_to_accel_listeners);
+    RUN_TEST(test_listener_that_stops_reading_is_dropped);
+    return UNITY_END();
+}
@@ -0,0 +1,181 @@
+// Boots the whole firmware against the fakes and runs loop() in fake time:
+// the sensor, shake path, answer selection, rendering and web routes all
+// take their real code paths.
+#include <unity.h>
+#include <Arduino.h>
+#include <Wire.h>
+#include <ESP8266WebServer.h>
+#include <FakeMpu6050.h>
+#include <FakeSdk.h>
+#include "magic8ball.h"
+#include "MPU6050_Raw.h"
+#include "PowerManager.h"
+#include "ResponseQueue.h"
+
+extern MPU6050_Raw mpu;
+extern bool bootComplete;
+extern ESP8266WebServer server;
+extern PowerManager powerManager;
+extern ResponseQueue responseQueue;
+
+static FakeMpu6050 sensor;
+static FakeAckDevice panel;
+
+static void runLoops(unsigned long ms) {
+    unsigned long end = millis() + ms;
+    while ((long)(millis() - end) < 0) {
+        loop();
+    }
+}
+
+static bool logContains(const char *text) {
+    return Serial.output().find(text) != std::string::npos;
+}
+
+static int litPixels() {
+    int lit = 0;
+    for (int y = 0; y < SCREEN_HEIGHT; y++) {
+        for (int x = 0; x < SCREEN_WIDTH; x++) {
+            lit += display.getPixel(x, y);
+        }
+    }
+    return lit;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_boot_completes() {
+    Wire.attach(MPU6050_ALT_ADDR, &sensor);
+    Wire.attach(SCREEN_ADDRESS, &panel);
+    sensor.setIntPin(MPU_INT_PIN);
+    setup();
+    runLoops(DFPLAYER_POWERUP_MS + 2000);
+
+    TEST_ASSERT_TRUE(bootComplete);
+    TEST_ASSERT_TRUE(mpu.isInitialized());
+    TEST_ASSERT_TRUE(mpu.isFifoEnabled());
+    TEST_ASSERT_TRUE(logContains("Boot complete"));
+    TEST_ASSERT_GREATER_THAN(0, litPixels());
+    TEST_ASSERT_TRUE(motionWakeEnabled);
+    TEST_ASSERT_EQUAL_HEX8(0x40, sensor.reg(0x38)); // INT_ENABLE back to motion only
+    // U8g2's Wire.begin() must not leave the core's 150ms stretch limit behind
+    TEST_ASSERT_EQUAL(I2C_CLOCK_STRETCH_LIMIT_US, (int)Wire.getStretchLimit());
+}
+
+void test_shake_shows_an_answer() {
+    Serial.clearOutput();
+    sensor.triggerMotion();
+    // 5Hz back-and-forth on X, +-1.5g
+    for (int swing = 0; swing < 10; swing++) {
+        sensor.setAccel(swing % 2 ? -6144 : 6144, 0, 4096);
+        runLoops(100);
+    }
+    sensor.setAccel(0, 0, 4096);
+    runLoops(200);
+
+    TEST_ASSERT_TRUE(logContains("SHAKE DETECTED!"));
+    TEST_ASSERT_TRUE(responseShown);
+}
+
+void test_web_routes_answer() {
+    const FakeResponse &status = server.fakeRequest("/status");
+    TEST_ASSERT_EQUAL(200, status.code);
+    TEST_ASSERT_EQUAL_STRING("application/json", status.contentType.c_str());
+
+    const FakeResponse &ask = server.fakeRequest("/ask");
+    TEST_ASSERT_EQUAL(200, ask.code);
+    TEST_ASSERT_GREATER_THAN(0, (int)ask.body.size());
+
+    const FakeResponse &metrics = server.fakeRequest("/metrics");
+    TEST_ASSERT_EQUAL(200, metrics.code);
+    TEST_ASSERT_TRUE(metrics.body.find("sse_events_dropped_total 0") != std::string::npos);
+
+    const FakeResponse &missing = server.fakeRequest("/nope");
+    TEST_ASSERT_EQUAL(404, missing.code);
+}
+
+static void checkUnwiredInt(int floatingLevel) {
+    detachInterrupt(MPU_INT_PIN);
+    motionWakeEnabled = false;
+    fakeSetPin(MPU_INT_PIN, floatingLevel);
+    Serial.clearOutput();
+
+    initializeMotionWake();
+
+    TEST_ASSERT_FALSE(motionWakeEnabled);
+    TEST_ASSERT_FALSE(fakeInterruptAttached(MPU_INT_PIN));
+    TEST_ASSERT_TRUE(logContains("INT not seen on D5"));
+    TEST_ASSERT_EQUAL_HEX8(0x00, sensor.reg(0x38));
+}
+
+void test_unwired_int_falls_back_to_polling() {
+    sensor.setIntPin(-1);
+    checkUnwiredInt(HIGH);
+    checkUnwiredInt(LOW);
+
+    // Shakes are sampled without waiting for a motion edge
+    TEST_ASSERT_TRUE(motionWindowActive());
+
+    sensor.setIntPin(MPU_INT_PIN);
+    initializeMotionWake();
+    TEST_ASSERT_TRUE(motionWakeEnabled);
+    TEST_ASSERT_TRUE(fakeInterruptAttached(MPU_INT_PIN));
+}
+
+void test_deep_idle_sleep_keeps_motion_interrupt() {
+    // Idle past the deep-idle timeout; the access point goes off and the
+    // loop light-sleeps until the sensor reports motion
+    runLoops(POWER_DEEP_IDLE_AFTER + 2000);
+    TEST_ASSERT_EQUAL(POWER_DEEP_IDLE, powerManager.getState());
+    uint32_t sleeps = fakeLightSleepCount();
+    runLoops(2000);
+    TEST_ASSERT_GREATER_THAN(sleeps, fakeLightSleepCount());
+
+    // The SDK's wake-up setup dropped the handler; it must be back
+    TEST_ASSERT_TRUE(fakeInterruptAttached(MPU_INT_PIN));
+    uint32_t wakes = motionWakeCount;
+    sensor.triggerMotion();
+    runLoops(100);
+    TEST_ASSERT_EQUAL(wakes + 1, motionWakeCount);
+    TEST_ASSERT_EQUAL(POWER_ACTIVE, powerManager.getState());
+}
+
+void test_shake_in_flush_callback_waits_for_the_frame() {
+    // Settle after the previous tests, then open a motion window
+    sensor.setAccel(0, 0, 4096);
+    runLoops(3000);
+    sensor.triggerMotion();
+    runLoops(100);
+    Serial.clearOutput();
+    uint32_t queued = responseQueue.getEnqueuedCount();
+
+    // Shake with only the bus scheduler's callback draining the FIFO, as
+    // happens between tile runs of a display flush
+    for (int swing = 0; swing < 20 && !shakePending; swing++) {
+        sensor.setAccel(swing % 2 ? -6144 : 6144, 0, 4096);
+        fakeAdvanceMicros(100000);
+        drainShakeFifo();
+    }
+    TEST_ASSERT_TRUE(shakePending);
+    TEST_ASSERT_FALSE(logContains("SHAKE DETECTED!"));
+    TEST_ASSERT_EQUAL(queued, responseQueue.getEnqueuedCount());
+
+    // The next loop announces it
+    sensor.setAccel(0, 0, 4096);
+    loop();
+    TEST_ASSERT_FALSE(shakePending);
+    TEST_ASSERT_TRUE(logContains("SHAKE DETECTED!"));
+    TEST_ASSERT_EQUAL(queued + 1, responseQueue.getEnqueuedCount());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_boot_completes);
+    RUN_TEST(test_shake_shows_an_answer);
+    RUN_TEST(test_web_routes_answer);
+    RUN_TEST(test_unwired_int_falls_back_to_polling);
+    RUN_TEST(test_deep_idle_sleep_keeps_motion_interrupt);
+    RUN_TEST(test_shake_in_flush_callback_waits_for_the_frame);
+    return UNITY_END();
+}
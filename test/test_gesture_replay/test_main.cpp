@@ -0,0 +1,192 @@
+// Replays labelled accelerometer traces through GestureEngine and reports
+// detection latency and false positives. Traces are CSV files in traces/
+// (the `trace_dump.py csv --raw` layout, ±8g counts at 50Hz) whose shake
+// column marks the intended shakes. The committed ones are synthetic, made
+// by tools/synth_traces.py; device recordings can be added next to them.
+#include <unity.h>
+#include <Arduino.h>
+#include <dirent.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "GestureEngine.h"
+
+#define REPLAY_RATE_HZ        50
+#define REPLAY_MAX_LATENCY_MS 1000 // From the start of a shake to its detection
+#define REPLAY_LATE_MS        (GESTURE_WINDOW_SIZE * 1000 / REPLAY_RATE_HZ) // Window still holds the shake
+
+struct Trace {
+    std::string name;
+    std::vector<AccelSample> samples;
+    std::vector<unsigned long> times;
+    std::vector<bool> labels;
+};
+
+struct Span {
+    unsigned long start;
+    unsigned long end;
+    long detectedAt; // -1 if missed
+};
+
+struct Result {
+    std::string name;
+    std::vector<Span> shakes;
+    std::vector<unsigned long> falsePositives;
+    unsigned long durationMs;
+};
+
+static std::vector<Result> results;
+
+static std::string traceDirectory() {
+    // Next to this file; PlatformIO may compile it by a relative path
+    std::string file = __FILE__;
+    std::string dir = file.substr(0, file.find_last_of("/\\") + 1) + "traces";
+    DIR *probe = opendir(dir.c_str());
+    if (probe) {
+        closedir(probe);
+        return dir;
+    }
+    return "test/test_gesture_replay/traces";
+}
+
+static bool loadTrace(const std::string &path, Trace &trace) {
+    FILE *file = fopen(path.c_str(), "r");
+    if (!file) {
+        return false;
+    }
+    char line[128];
+    while (fgets(line, sizeof(line), file)) {
+        unsigned long ms;
+        int x, y, z, shake;
+        if (line[0] == '#' || sscanf(line, "%lu,%d,%d,%d,%d", &ms, &x, &y, &z, &shake) != 5) {
+            continue; // Comment or header
+        }
+        trace.samples.push_back(AccelSample{ (int16_t)x, (int16_t)y, (int16_t)z });
+        trace.times.push_back(ms);
+        trace.labels.push_back(shake != 0);
+    }
+    fclose(file);
+    return !trace.samples.empty();
+}
+
+static Result replay(const Trace &trace) {
+    Result result;
+    result.name = trace.name;
+    result.durationMs = trace.times.back();
+
+    for (size_t i = 0; i < trace.labels.size(); i++) {
+        if (trace.labels[i] && (i == 0 || !trace.labels[i - 1])) {
+            result.shakes.push_back(Span{ trace.times[i], trace.times[i], -1 });
+        }
+        if (trace.labels[i]) {
+            result.shakes.back().end = trace.times[i];
+        }
+    }
+
+    GestureEngine engine;
+    engine.begin(MPU6050_DEFAULT_RANGE, REPLAY_RATE_HZ);
+    for (size_t i = 0; i < trace.samples.size(); i++) {
+        if (!engine.update(trace.samples[i])) {
+            continue;
+        }
+        unsigned long now = trace.times[i];
+        bool matched = false;
+        for (Span &span : result.shakes) {
+            if (span.detectedAt < 0 && now >= span.start && now <= span.end + REPLAY_LATE_MS) {
+                span.detectedAt = now;
+                matched = true;
+                break;
+            }
+        }
+        if (!matched) {
+            result.falsePositives.push_back(now);
+        }
+    }
+    return result;
+}
+
+static void replayAll() {
+    if (!results.empty()) {
+        return;
+    }
+    std::string dir = traceDirectory();
+    DIR *listing = opendir(dir.c_str());
+    TEST_ASSERT_NOT_NULL_MESSAGE(listing, "traces/ directory not found");
+    std::vector<std::string> names;
+    while (struct dirent *entry = readdir(listing)) {
+        std::string name = entry->d_name;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".csv") == 0) {
+            names.push_back(name);
+        }
+    }
+    closedir(listing);
+    std::sort(names.begin(), names.end());
+
+    for (const std::string &name : names) {
+        Trace trace;
+        trace.name = name;
+        TEST_ASSERT_TRUE_MESSAGE(loadTrace(dir + "/" + name, trace), name.c_str());
+        results.push_back(replay(trace));
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_report() {
+    replayAll();
+    TEST_ASSERT_TRUE(results.size() > 0);
+
+    unsigned shakes = 0, detected = 0, falsePositives = 0;
+    unsigned long latencySum = 0, latencyMax = 0, quietMs = 0;
+    printf("\n%-22s %6s %9s %12s %7s\n", "trace", "shakes", "detected", "latency ms", "false+");
+    for (const Result &result : results) {
+        unsigned hits = 0;
+        std::string latencies;
+        for (const Span &span : result.shakes) {
+            if (span.detectedAt >= 0) {
+                unsigned long latency = span.detectedAt - span.start;
+                hits++;
+                latencySum += latency;
+                latencyMax = max(latencyMax, latency);
+                latencies += (latencies.empty() ? "" : ",") + std::to_string(latency);
+            }
+        }
+        printf("%-22s %6u %9u %12s %7u\n", result.name.c_str(), (unsigned)result.shakes.size(), hits,
+               latencies.empty() ? "-" : latencies.c_str(), (unsigned)result.falsePositives.size());
+        shakes += result.shakes.size();
+        detected += hits;
+        falsePositives += result.falsePositives.size();
+        if (result.shakes.empty()) {
+            quietMs += result.durationMs;
+        }
+    }
+    printf("detected %u of %u shakes, latency mean %lums max %lums, %u false positives in %.1fs of non-shake traces\n\n",
+           detected, shakes, detected ? latencySum / detected : 0, latencyMax, falsePositives, quietMs / 1000.0);
+}
+
+void test_every_shake_detected_in_time() {
+    replayAll();
+    for (const Result &result : results) {
+        for (const Span &span : result.shakes) {
+            TEST_ASSERT_TRUE_MESSAGE(span.detectedAt >= 0, result.name.c_str());
+            TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(REPLAY_MAX_LATENCY_MS, span.detectedAt - (long)span.start,
+                                              result.name.c_str());
+        }
+    }
+}
+
+void test_no_false_positives() {
+    replayAll();
+    for (const Result &result : results) {
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, result.falsePositives.size(), result.name.c_str());
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_report);
+    RUN_TEST(test_every_shake_detected_in_time);
+    RUN_TEST(test_no_false_positives);
+    return UNITY_END();
+}
@@ -0,0 +1,177 @@
+// Golden frames: the final screen of every built-in answer, rendered
+// through /frame.pbm?answer=N, must match the PBMs in golden/. The goldens
+// are host renders (the fake U8g2 draws text in its own 5x7 face), so they
+// catch layout and drawing changes, not font differences on the device.
+// Set UPDATE_GOLDEN=1 to rewrite them after an intended change, or delete
+// a file to have it recreated.
+#include <unity.h>
+#include <Arduino.h>
+#include <Wire.h>
+#include <ESP8266WebServer.h>
+#include <FakeMpu6050.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include "magic8ball.h"
+#include "DisplayFlush.h"
+#include "Metrics.h"
+#include "ResponseLayout.h"
+
+extern ESP8266WebServer server;
+extern bool bootComplete;
+extern TileFlusher displayFlusher;
+extern MetricCounter framesOverBudget;
+void drawResponseFrame(const char* response, const ResponseLayout& layout, int frame);
+extern ResponseLayout responseLayouts[];
+
+static FakeMpu6050 sensor;
+static FakeAckDevice panel;
+
+static std::string goldenDir() {
+    // Next to this file when the compiler gives a usable path, else relative
+    // to the project root (where pio test runs)
+    std::string file = __FILE__;
+    size_t slash = file.find_last_of("/\\");
+    std::string dir = slash == std::string::npos ? "." : file.substr(0, slash);
+    std::string probe = dir + "/golden/answer-00.pbm";
+    FILE *f = fopen(probe.c_str(), "rb");
+    if (f) {
+        fclose(f);
+        return dir + "/golden";
+    }
+    return "test/test_golden_frames/golden";
+}
+
+static bool readFile(const std::string &path, std::string &contents) {
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) {
+        return false;
+    }
+    char chunk[512];
+    size_t n;
+    contents.clear();
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        contents.append(chunk, n);
+    }
+    fclose(f);
+    return true;
+}
+
+static bool writeFile(const std::string &path, const std::string &contents) {
+    FILE *f = fopen(path.c_str(), "wb");
+    if (!f) {
+        return false;
+    }
+    size_t written = fwrite(contents.data(), 1, contents.size(), f);
+    fclose(f);
+    return written == contents.size();
+}
+
+// First differing pixel as "x,y", for a readable failure
+static std::string firstDifference(const std::string &a, const std::string &b) {
+    const size_t header = sizeof("P4\n128 64\n") - 1;
+    for (size_t i = header; i < a.size() && i < b.size(); i++) {
+        uint8_t diff = a[i] ^ b[i];
+        if (diff) {
+            int bit = 0;
+            while (!(diff & (0x80 >> bit))) {
+                bit++;
+            }
+            size_t offset = i - header;
+            char text[32];
+            snprintf(text, sizeof(text), "%d,%d", (int)(offset % 16) * 8 + bit, (int)(offset / 16));
+            return text;
+        }
+    }
+    return "length";
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_boot() {
+    Wire.attach(MPU6050_ALT_ADDR, &sensor);
+    Wire.attach(SCREEN_ADDRESS, &panel);
+    sensor.setIntPin(MPU_INT_PIN);
+    setup();
+    unsigned long end = millis() + DFPLAYER_POWERUP_MS + 2000;
+    while ((long)(millis() - end) < 0) {
+        loop();
+    }
+    TEST_ASSERT_TRUE(bootComplete);
+}
+
+void test_answers_match_goldens() {
+    std::string dir = goldenDir();
+    bool update = getenv("UPDATE_GOLDEN") != 0;
+    int written = 0;
+
+    for (int i = 0; i < numResponses; i++) {
+        char query[24];
+        snprintf(query, sizeof(query), "answer=%d", i);
+        const FakeResponse &response = server.fakeRequest("/frame.pbm", HTTP_GET, query);
+        TEST_ASSERT_EQUAL(200, response.code);
+        TEST_ASSERT_EQUAL_STRING("image/x-portable-bitmap", response.contentType.c_str());
+        TEST_ASSERT_EQUAL(10 + 64 * 16, (int)response.body.size());
+
+        char name[32];
+        snprintf(name, sizeof(name), "/answer-%02d.pbm", i);
+        std::string path = dir + name;
+        std::string golden;
+        if (update || !readFile(path, golden)) {
+            TEST_ASSERT_TRUE_MESSAGE(writeFile(path, response.body), path.c_str());
+            written++;
+            continue;
+        }
+        std::string message = std::string(responses[i]) + " differs at " + firstDifference(golden, response.body);
+        TEST_ASSERT_TRUE_MESSAGE(golden == response.body, message.c_str());
+    }
+    if (written > 0) {
+        printf("Wrote %d golden frame(s) to %s\n", written, dir.c_str());
+    }
+}
+
+void test_answer_render_leaves_display_alone() {
+    uint8_t panelBefore[FAKE_U8G2_BUFFER_SIZE];
+    uint8_t bufferBefore[FAKE_U8G2_BUFFER_SIZE];
+    memcpy(panelBefore, display.getPanel(), sizeof(panelBefore));
+    memcpy(bufferBefore, display.getBufferPtr(), sizeof(bufferBefore));
+    const FakeResponse before = server.fakeRequest("/frame.pbm");
+    display.resetCounters();
+
+    server.fakeRequest("/frame.pbm", HTTP_GET, "answer=3");
+
+    TEST_ASSERT_EQUAL(0, (int)display.getTilesSent());
+    TEST_ASSERT_EQUAL_MEMORY(panelBefore, display.getPanel(), sizeof(panelBefore));
+    TEST_ASSERT_EQUAL_MEMORY(bufferBefore, display.getBufferPtr(), sizeof(bufferBefore));
+    const FakeResponse &after = server.fakeRequest("/frame.pbm");
+    TEST_ASSERT_TRUE(before.body == after.body);
+}
+
+void test_unknown_answer_is_404() {
+    TEST_ASSERT_EQUAL(404, server.fakeRequest("/frame.pbm", HTTP_GET, "answer=999").code);
+}
+
+void test_response_animation_within_budget() {
+    // Every frame after the first (which replaces whatever was on screen)
+    // must fit the byte budget, and no frame may exceed the time budget
+    for (int i = 0; i < numResponses; i++) {
+        drawResponseFrame(responses[i], responseLayouts[i], 0);
+        uint32_t overAfterFirst = framesOverBudget.get();
+        for (int frame = 1; frame < RESPONSE_FRAME_COUNT; frame++) {
+            drawResponseFrame(responses[i], responseLayouts[i], frame);
+            TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(FRAME_BUDGET_BYTES, displayFlusher.getLastFlushBytes(), responses[i]);
+        }
+        TEST_ASSERT_EQUAL_MESSAGE(overAfterFirst, framesOverBudget.get(), responses[i]);
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_boot);
+    RUN_TEST(test_answers_match_goldens);
+    RUN_TEST(test_answer_render_leaves_display_alone);
+    RUN_TEST(test_unknown_answer_is_404);
+    RUN_TEST(test_response_animation_within_budget);
+    return UNITY_END();
+}
@@ -0,0 +1,121 @@
+// The shared I2CBus on the fake Wire: transaction budgets that scale with
+// length, rate-limited bus-clear logging, and probes counted per client.
+#include <unity.h>
+#include <Arduino.h>
+#include <Wire.h>
+#include <FakeMpu6050.h>
+#include <string>
+#include "I2CBus.h"
+
+#define SENSOR_ADDRESS 0x69
+#define FIFO_R_W       0x74
+
+static FakeMpu6050 sensor;
+static int8_t client;
+
+static int countLines(const char *text) {
+    const std::string &log = Serial.output();
+    int count = 0;
+    for (size_t at = log.find(text); at != std::string::npos; at = log.find(text, at + 1)) {
+        count++;
+    }
+    return count;
+}
+
+void setUp() {
+    Wire.detachAll();
+    sensor.reset();
+    sensor.setAutoSample(false);
+    Wire.attach(SENSOR_ADDRESS, &sensor);
+    if (!i2cBus.isStarted()) {
+        i2cBus.begin(4, 5);
+    }
+    client = i2cBus.registerClient("MPU6050", SENSOR_ADDRESS, 400000);
+    i2cBus.resetStats();
+    fakeAdvanceMicros(I2C_RECOVERY_LOG_MS * 1000UL); // Next clear is logged
+    Serial.clearOutput();
+}
+
+void tearDown() {}
+
+void test_budget_scales_with_length() {
+    TEST_ASSERT_GREATER_THAN(i2cBus.timeoutFor(17), i2cBus.timeoutFor(123));
+    // A full FIFO chunk at 400kHz (~2.8ms on the wire) fits its budget
+    TEST_ASSERT_GREATER_THAN(3000, (int)i2cBus.timeoutFor(3 + 120));
+}
+
+void test_full_fifo_chunk_at_400khz_is_not_a_timeout() {
+    uint8_t pattern[120];
+    for (int i = 0; i < 120; i++) {
+        pattern[i] = i;
+    }
+    sensor.pushFifoBytes(pattern, sizeof(pattern));
+
+    uint8_t buffer[120];
+    unsigned long start = micros();
+    I2CStatus status = i2cBus.readRegisters(client, FIFO_R_W, buffer, sizeof(buffer));
+    unsigned long elapsed = micros() - start;
+
+    TEST_ASSERT_EQUAL_STRING("ok", I2CBus::statusName(status));
+    TEST_ASSERT_GREATER_THAN(2000, (int)elapsed); // Longer than the old fixed 2ms limit
+    TEST_ASSERT_EQUAL_MEMORY(pattern, buffer, sizeof(buffer));
+    const I2CClientStats *stats = i2cBus.getStats(client);
+    TEST_ASSERT_EQUAL(0, (int)stats->timeouts);
+    TEST_ASSERT_EQUAL(0, (int)stats->recoveries);
+    TEST_ASSERT_EQUAL(0, countLines("I2C bus cleared"));
+}
+
+void test_stretched_burst_is_a_timeout() {
+    // 17 bytes stretched by 150us each blows the ~1.8ms budget of a 14-byte read
+    Wire.setStretchPerByte(150);
+    uint8_t buffer[14];
+    I2CStatus status = i2cBus.readRegisters(client, 0x3B, buffer, sizeof(buffer));
+    Wire.setStretchPerByte(0);
+
+    TEST_ASSERT_EQUAL_STRING("timeout", I2CBus::statusName(status));
+    const I2CClientStats *stats = i2cBus.getStats(client);
+    TEST_ASSERT_EQUAL(1, (int)stats->timeouts);
+    TEST_ASSERT_EQUAL(1, (int)stats->recoveries);
+    TEST_ASSERT_EQUAL(0, (int)stats->retries);
+}
+
+void test_bus_clear_log_is_rate_limited() {
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(i2cBus.recoverBus());
+    }
+    TEST_ASSERT_EQUAL(1, countLines("I2C bus cleared"));
+    TEST_ASSERT_EQUAL(1, countLines("(1 clears since last report)"));
+
+    fakeAdvanceMicros(I2C_RECOVERY_LOG_MS * 1000UL);
+    i2cBus.recoverBus();
+    TEST_ASSERT_EQUAL(2, countLines("I2C bus cleared"));
+    TEST_ASSERT_EQUAL(1, countLines("(10 clears since last report)"));
+}
+
+void test_probe_counts_against_the_client() {
+    const I2CClientStats *stats = i2cBus.getStats(client);
+    uint32_t transactions = stats->lifetimeTransactions;
+
+    TEST_ASSERT_TRUE(i2cBus.probe(SENSOR_ADDRESS));
+    TEST_ASSERT_FALSE(i2cBus.probe(0x50)); // Nobody registered there
+    TEST_ASSERT_EQUAL(transactions + 1, stats->lifetimeTransactions);
+    TEST_ASSERT_EQUAL(1, (int)stats->transactions);
+    TEST_ASSERT_EQUAL(0, (int)stats->errors);
+
+    uint32_t nacks = stats->nacks;
+    sensor.nackWrites(1);
+    TEST_ASSERT_FALSE(i2cBus.probe(SENSOR_ADDRESS));
+    TEST_ASSERT_EQUAL(nacks + 1, stats->nacks);
+    TEST_ASSERT_EQUAL(1, (int)stats->errors);
+    TEST_ASSERT_EQUAL(0, (int)stats->retries); // Scans are not retried
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_budget_scales_with_length);
+    RUN_TEST(test_full_fifo_chunk_at_400khz_is_not_a_timeout);
+    RUN_TEST(test_stretched_burst_is_a_timeout);
+    RUN_TEST(test_bus_clear_log_is_rate_limited);
+    RUN_TEST(test_probe_counts_against_the_client);
+    return UNITY_END();
+}
@@ -0,0 +1,151 @@
+// FIFO streaming against a scripted MPU6050 register map: the test fills
+// the FIFO byte by byte and checks what readFifo() drains, how it handles
+// overflow and short reads, and what it leaves behind
+#include <unity.h>
+#include <Arduino.h>
+#include <FakeMpu6050.h>
+#include <RecordingBus.h>
+#include "MPU6050_impl.h"
+
+static FakeMpu6050 sensor;
+static MPU6050<RecordingBus> *mpu;
+static AccelSample samples[64];
+
+static size_t countReads(uint8_t reg) {
+    size_t count = 0;
+    for (const BusRecord &record : RecordingBus::log) {
+        count += record.op == 'R' && record.address == reg;
+    }
+    return count;
+}
+
+void setUp() {
+    sensor.reset();
+    sensor.setAutoSample(false); // FIFO contents come from the test only
+    RecordingBus::attach(MPU6050_ALT_ADDR, &sensor);
+    static MPU6050<RecordingBus> instance(MPU6050_ALT_ADDR);
+    instance = MPU6050<RecordingBus>(MPU6050_ALT_ADDR);
+    mpu = &instance;
+    mpu->begin();
+    mpu->enableFifo();
+    RecordingBus::log.clear();
+}
+
+void tearDown() {}
+
+void test_drains_samples_in_order() {
+    for (int i = 0; i < 25; i++) {
+        sensor.pushFifo(i, -i, 4096 + i);
+    }
+    TEST_ASSERT_EQUAL_UINT32(25, mpu->readFifo(samples, 64));
+    for (int i = 0; i < 25; i++) {
+        TEST_ASSERT_EQUAL_INT16(i, samples[i].x);
+        TEST_ASSERT_EQUAL_INT16(-i, samples[i].y);
+        TEST_ASSERT_EQUAL_INT16(4096 + i, samples[i].z);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, sensor.fifoDepth());
+    TEST_ASSERT_EQUAL_UINT32(25, mpu->getFifoSampleCount());
+
+    // 25 samples = one full FIFO_READ_CHUNK burst and one of 5 samples
+    TEST_ASSERT_EQUAL_UINT32(2, countReads(FIFO_R_W));
+    TEST_ASSERT_TRUE(RecordingBus::log[2] == busRead(FIFO_R_W, FIFO_READ_CHUNK));
+    TEST_ASSERT_TRUE(RecordingBus::log[3] == busRead(FIFO_R_W, 5 * ACCEL_BURST_LENGTH));
+}
+
+void test_stops_at_max_samples() {
+    for (int i = 0; i < 30; i++) {
+        sensor.pushFifo(i, 0, 0);
+    }
+    TEST_ASSERT_EQUAL_UINT32(10, mpu->readFifo(samples, 10));
+    TEST_ASSERT_EQUAL_UINT32(20 * ACCEL_BURST_LENGTH, sensor.fifoDepth());
+    TEST_ASSERT_EQUAL_UINT32(20, mpu->readFifo(samples, 64));
+    TEST_ASSERT_EQUAL_INT16(10, samples[0].x);
+}
+
+void test_leaves_partial_sample() {
+    // A sample still being written: only whole samples are read
+    sensor.pushFifo(1, 2, 3);
+    sensor.pushFifo(4, 5, 6);
+    const uint8_t partial[] = { 0x00, 0x07 };
+    sensor.pushFifoBytes(partial, sizeof(partial));
+    TEST_ASSERT_EQUAL_UINT32(2, mpu->readFifo(samples, 64));
+    TEST_ASSERT_EQUAL_UINT32(2, sensor.fifoDepth());
+}
+
+void test_empty_fifo_reads_only_the_count() {
+    TEST_ASSERT_EQUAL_UINT32(0, mpu->readFifo(samples, 64));
+    TEST_ASSERT_EQUAL_UINT32(0, countReads(FIFO_R_W));
+    TEST_ASSERT_TRUE(RecordingBus::log[0] == busRead(FIFO_COUNTH, 2));
+}
+
+void test_overflow_resets_fifo() {
+    // 1200 bytes into a 1024-byte FIFO: the oldest are overwritten and the
+    // stream is no longer aligned to samples
+    for (int i = 0; i < 200; i++) {
+        sensor.pushFifo(i, i, i);
+    }
+    uint32_t resets = sensor.getFifoResets();
+    TEST_ASSERT_EQUAL_UINT32(0, mpu->readFifo(samples, 64));
+    TEST_ASSERT_EQUAL_UINT32(1, mpu->getFifoOverflowCount());
+    TEST_ASSERT_EQUAL_UINT32(resets + 1, sensor.getFifoResets());
+    TEST_ASSERT_EQUAL_UINT32(0, sensor.fifoDepth());
+    TEST_ASSERT_EQUAL_UINT32(0, countReads(FIFO_R_W));
+    TEST_ASSERT_EQUAL_HEX8(USER_CTRL_FIFO_EN, sensor.reg(USER_CTRL)); // Still streaming
+
+    // The next samples are read normally
+    sensor.pushFifo(7, 8, 9);
+    TEST_ASSERT_EQUAL_UINT32(1, mpu->readFifo(samples, 64));
+    TEST_ASSERT_EQUAL_INT16(7, samples[0].x);
+}
+
+void test_short_read_resets_fifo() {
+    for (int i = 0; i < 25; i++) {
+        sensor.pushFifo(i, 0, 0);
+    }
+    // The second burst (5 samples) comes back one byte short
+    struct ShortSecondBurst : FakeI2CDevice {
+        FakeMpu6050 *inner;
+        int bursts = 0;
+        bool receive(const uint8_t *data, size_t length) override { return inner->receive(data, length); }
+        size_t transmit(uint8_t *data, size_t length) override {
+            if (length == 5 * ACCEL_BURST_LENGTH && ++bursts == 1) {
+                inner->truncateNextRead(length - 1);
+            }
+            return inner->transmit(data, length);
+        }
+    } device;
+    device.inner = &sensor;
+    RecordingBus::device = &device;
+
+    uint32_t resets = sensor.getFifoResets();
+    TEST_ASSERT_EQUAL_UINT32(20, mpu->readFifo(samples, 64));
+    const BusRecord shortRead = { 'R', FIFO_R_W, 5 * ACCEL_BURST_LENGTH, I2C_SHORT_READ };
+    TEST_ASSERT_TRUE(RecordingBus::log[3] == shortRead);
+    TEST_ASSERT_EQUAL_UINT32(resets + 1, sensor.getFifoResets());
+    TEST_ASSERT_EQUAL_UINT32(0, sensor.fifoDepth());
+    TEST_ASSERT_EQUAL_INT16(19, samples[19].x);
+    RecordingBus::device = &sensor;
+}
+
+void test_fills_at_configured_rate() {
+    // 1kHz with the DLPF on, divided by 1 + SHAKE divider: 50Hz
+    sensor.setAutoSample(true);
+    mpu->setDigitalLowPassFilter(3);
+    mpu->setSampleRateDivider(19);
+    mpu->resetFifo();
+    delay(1000);
+    TEST_ASSERT_EQUAL_UINT32(50, mpu->readFifo(samples, 64));
+    TEST_ASSERT_EQUAL_INT16(4096, samples[49].z);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_drains_samples_in_order);
+    RUN_TEST(test_stops_at_max_samples);
+    RUN_TEST(test_leaves_partial_sample);
+    RUN_TEST(test_empty_fifo_reads_only_the_count);
+    RUN_TEST(test_overflow_resets_fifo);
+    RUN_TEST(test_short_read_resets_fifo);
+    RUN_TEST(test_fills_at_configured_rate);
+    return UNITY_END();
+}
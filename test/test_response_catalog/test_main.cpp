@@ -0,0 +1,184 @@
+// ResponseCatalog on the in-memory LittleFS: catalogs built here in the
+// tools/build_catalog.py format. The saved selection is only rewritten when
+// it changes, entries must fit the two-line layout, and a short read at any
+// point fails validation.
+#include <unity.h>
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <string>
+#include <vector>
+#include "ResponseCatalog.h"
+
+struct SourceSet {
+    const char *name;
+    std::vector<std::string> entries;
+};
+
+static void putU16(std::vector<uint8_t> &out, size_t at, uint16_t value) {
+    out[at] = value & 0xFF;
+    out[at + 1] = value >> 8;
+}
+
+static void putU32(std::vector<uint8_t> &out, size_t at, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[at + i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+static uint32_t crc32(const uint8_t *data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    while (length--) {
+        crc ^= *data++;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+static std::vector<uint8_t> buildCatalog(const std::vector<SourceSet> &sets) {
+    std::vector<uint8_t> out(16 + 16 * sets.size(), 0);
+    for (size_t s = 0; s < sets.size(); s++) {
+        size_t entry = 16 + 16 * s;
+        strncpy((char *)&out[entry], sets[s].name, 10);
+        putU16(out, entry + 10, sets[s].entries.size());
+        putU32(out, entry + 12, out.size());
+
+        size_t index = out.size();
+        size_t count = sets[s].entries.size();
+        out.resize(index + 4 * (count + 1));
+        uint32_t offset = out.size();
+        for (size_t i = 0; i < count; i++) {
+            putU32(out, index + 4 * i, offset);
+            offset += sets[s].entries[i].size();
+        }
+        putU32(out, index + 4 * count, offset);
+        for (const std::string &text : sets[s].entries) {
+            out.insert(out.end(), text.begin(), text.end());
+        }
+    }
+    memcpy(&out[0], CATALOG_MAGIC, 4);
+    out[4] = CATALOG_VERSION;
+    out[5] = sets.size();
+    putU32(out, 8, out.size());
+    putU32(out, 12, crc32(&out[16], out.size() - 16));
+    return out;
+}
+
+static std::vector<uint8_t> twoSets() {
+    return buildCatalog({
+        { "classic", { "Yes", "No", "Ask again later" } },
+        { "office", { "Circle back after lunch", "Let's take that offline" } },
+    });
+}
+
+static std::string selectionOnFlash() {
+    std::vector<uint8_t> bytes = LittleFS.fakeContents(CATALOG_SELECTION_PATH);
+    return std::string(bytes.begin(), bytes.end());
+}
+
+void setUp() {
+    LittleFS.fakeClear();
+}
+
+void tearDown() {}
+
+void test_boot_does_not_rewrite_selection() {
+    LittleFS.fakeLoad(CATALOG_PATH, twoSets());
+    {
+        ResponseCatalog firstBoot;
+        TEST_ASSERT_TRUE(firstBoot.begin());
+        TEST_ASSERT_EQUAL(0, firstBoot.getSelectedSet());
+    }
+    TEST_ASSERT_EQUAL(1, (int)LittleFS.fakeWriteOpens(CATALOG_SELECTION_PATH));
+    TEST_ASSERT_EQUAL_STRING("classic", selectionOnFlash().c_str());
+
+    for (int boot = 0; boot < 3; boot++) {
+        ResponseCatalog catalog;
+        TEST_ASSERT_TRUE(catalog.begin());
+        TEST_ASSERT_EQUAL(0, catalog.getSelectedSet());
+    }
+    TEST_ASSERT_EQUAL(1, (int)LittleFS.fakeWriteOpens(CATALOG_SELECTION_PATH));
+}
+
+void test_selection_written_only_on_change() {
+    LittleFS.fakeLoad(CATALOG_PATH, twoSets());
+    ResponseCatalog catalog;
+    catalog.begin();
+    uint32_t writes = LittleFS.fakeWriteOpens(CATALOG_SELECTION_PATH);
+
+    TEST_ASSERT_TRUE(catalog.select(1));
+    TEST_ASSERT_TRUE(catalog.select(1));
+    TEST_ASSERT_EQUAL(writes + 1, LittleFS.fakeWriteOpens(CATALOG_SELECTION_PATH));
+    TEST_ASSERT_EQUAL_STRING("office", selectionOnFlash().c_str());
+
+    TEST_ASSERT_TRUE(catalog.select(-1));
+    TEST_ASSERT_EQUAL(writes + 2, LittleFS.fakeWriteOpens(CATALOG_SELECTION_PATH));
+
+    // The built-in choice survives a reboot without another write
+    ResponseCatalog rebooted;
+    rebooted.begin();
+    TEST_ASSERT_EQUAL(-1, rebooted.getSelectedSet());
+    TEST_ASSERT_EQUAL(writes + 2, LittleFS.fakeWriteOpens(CATALOG_SELECTION_PATH));
+}
+
+void test_entries_must_fit_the_layout() {
+    // Two full 21-character lines fit; one more character does not
+    std::string line1(21, 'a');
+    std::string line2(21, 'b');
+    LittleFS.fakeLoad("/fits.bin", buildCatalog({ { "edge", { line1 + " " + line2 } } }));
+    TEST_ASSERT_TRUE(ResponseCatalog::validate("/fits.bin"));
+
+    LittleFS.fakeLoad("/long.bin", buildCatalog({ { "edge", { "Yes", line1 + " " + line2 + "b" } } }));
+    TEST_ASSERT_FALSE(ResponseCatalog::validate("/long.bin"));
+
+    // A single long word is hard-broken at 21 characters
+    LittleFS.fakeLoad("/word.bin", buildCatalog({ { "edge", { std::string(43, 'w') } } }));
+    TEST_ASSERT_FALSE(ResponseCatalog::validate("/word.bin"));
+
+    // The upload is refused and removed; the installed catalog stays
+    LittleFS.fakeLoad(CATALOG_PATH, twoSets());
+    ResponseCatalog catalog;
+    catalog.begin();
+    LittleFS.fakeLoad(CATALOG_UPLOAD_PATH, LittleFS.fakeContents("/long.bin"));
+    TEST_ASSERT_FALSE(catalog.install(CATALOG_UPLOAD_PATH));
+    TEST_ASSERT_FALSE(LittleFS.exists(CATALOG_UPLOAD_PATH));
+    TEST_ASSERT_EQUAL(2, catalog.getSetCount());
+}
+
+void test_any_short_read_fails_validation() {
+    std::vector<uint8_t> bytes = twoSets();
+    long reads = 0;
+    for (;; reads++) {
+        LittleFS.fakeLoad("/upload.bin", bytes);
+        LittleFS.fakeFailReadsAfter("/upload.bin", reads);
+        if (ResponseCatalog::validate("/upload.bin")) {
+            break;
+        }
+        TEST_ASSERT_LESS_THAN(1000, reads);
+    }
+    // Header, CRC pass, set table, index and every entry's text
+    TEST_ASSERT_GREATER_THAN(5 + 5, reads);
+}
+
+void test_entries_read_back() {
+    LittleFS.fakeLoad(CATALOG_PATH, twoSets());
+    ResponseCatalog catalog;
+    catalog.begin();
+    catalog.select(1);
+    char text[CATALOG_MAX_ENTRY_LENGTH + 1];
+    TEST_ASSERT_EQUAL(2, catalog.getEntryCount());
+    TEST_ASSERT_EQUAL(23, (int)catalog.getEntry(0, text, sizeof(text)));
+    TEST_ASSERT_EQUAL_STRING("Circle back after lunch", text);
+    TEST_ASSERT_EQUAL(0, (int)catalog.getEntry(2, text, sizeof(text)));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_boot_does_not_rewrite_selection);
+    RUN_TEST(test_selection_written_only_on_change);
+    RUN_TEST(test_entries_must_fit_the_layout);
+    RUN_TEST(test_any_short_read_fails_validation);
+    RUN_TEST(test_entries_read_back);
+    return UNITY_END();
+}
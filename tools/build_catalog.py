@@ -0,0 +1,224 @@
+"""Build and validate response catalogs for the LittleFS partition.
+
+A catalog holds one or more answer sets (e.g. "classic", "office"). Sources
+are text files in catalogs/, one answer per line; blank lines and lines
+starting with '#' are ignored, and the file name (without .txt) names the set.
+
+    python tools/build_catalog.py build                 # catalogs/*.txt -> data/catalog.bin
+    python tools/build_catalog.py build -o out.bin a.txt b.txt
+    python tools/build_catalog.py check data/catalog.bin [--dump]
+    python tools/build_catalog.py synth -o big.bin --entries 5000 --sets 2
+
+Upload data/ with `pio run -t uploadfs`, or POST a catalog to /catalog.
+
+Format (little-endian), read by src/ResponseCatalog.cpp:
+    header   16 bytes   "M8BC", u8 version, u8 set count, u16 reserved,
+                        u32 file size, u32 CRC-32 of everything after the header
+    sets     16 bytes   char[10] name (NUL padded), u16 entry count,
+             per set    u32 offset of the set's index
+    index    per set    (entry count + 1) u32 offsets; entry i is the bytes
+                        [offset[i], offset[i + 1]), no terminator
+    strings             packed entry text
+"""
+import argparse
+import glob
+import os
+import random
+import struct
+import sys
+import zlib
+
+MAGIC = b"M8BC"
+VERSION = 1
+HEADER = struct.Struct("<4sBBHII")
+SET_ENTRY = struct.Struct("<10sHI")
+MAX_SETS = 8            # CATALOG_MAX_SETS
+MAX_ENTRY_LENGTH = 80   # CATALOG_MAX_ENTRY_LENGTH
+MAX_NAME_LENGTH = 9
+DISPLAY_LINE_CHARS = 21  # LAYOUT_MAX_LINE_CHARS: two lines of 6x10 text on the 128px display
+
+PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def check_entry(set_name, index, text):
+    """Entries are drawn with a Latin-1 font and sent as JSON: plain ASCII only."""
+    if not text:
+        raise ValueError("%s[%d]: empty entry" % (set_name, index))
+    if any(not (0x20 <= ord(c) < 0x7F) for c in text):
+        raise ValueError("%s[%d]: only printable ASCII is supported: %r" % (set_name, index, text))
+    if len(text) > MAX_ENTRY_LENGTH:
+        raise ValueError("%s[%d]: %d chars, limit is %d" % (set_name, index, len(text), MAX_ENTRY_LENGTH))
+    if not fits_display(text):
+        raise ValueError("%s[%d]: does not fit two lines of %d chars: %r" % (
+            set_name, index, DISPLAY_LINE_CHARS, text))
+
+
+def fits_display(text):
+    """Same wrap as layoutResponse()/responseFits(): break the first line at the
+    last space within it (or hard-break one long word); the rest must fit the
+    second line."""
+    if len(text) <= DISPLAY_LINE_CHARS:
+        return True
+    break_at = DISPLAY_LINE_CHARS
+    while break_at > 0 and text[break_at] != " ":
+        break_at -= 1
+    second = break_at + 1 if break_at > 0 else DISPLAY_LINE_CHARS
+    return len(text) - second <= DISPLAY_LINE_CHARS
+
+
+def build(sets):
+    """sets: list of (name, [entries]) -> catalog bytes"""
+    if not 1 <= len(sets) <= MAX_SETS:
+        raise ValueError("need 1..%d sets, got %d" % (MAX_SETS, len(sets)))
+
+    table_end = HEADER.size + SET_ENTRY.size * len(sets)
+    table = b""
+    body = b""
+    offset = table_end
+    for name, entries in sets:
+        if not 1 <= len(name) <= MAX_NAME_LENGTH:
+            raise ValueError("set name %r must be 1..%d chars" % (name, MAX_NAME_LENGTH))
+        if not 1 <= len(entries) <= 0xFFFF:
+            raise ValueError("set %s: need 1..65535 entries" % name)
+        for i, text in enumerate(entries):
+            check_entry(name, i, text)
+
+        index_offset = offset
+        data_offset = index_offset + 4 * (len(entries) + 1)
+        offsets, data = [], b""
+        for text in entries:
+            offsets.append(data_offset + len(data))
+            data += text.encode("ascii")
+        offsets.append(data_offset + len(data))
+
+        table += SET_ENTRY.pack(name.encode("ascii"), len(entries), index_offset)
+        chunk = struct.pack("<%dI" % len(offsets), *offsets) + data
+        body += chunk
+        offset += len(chunk)
+
+    payload = table + body
+    header = HEADER.pack(MAGIC, VERSION, len(sets), 0, HEADER.size + len(payload),
+                         zlib.crc32(payload) & 0xFFFFFFFF)
+    return header + payload
+
+
+def parse(blob):
+    """Validate a catalog the way the firmware does; returns [(name, [entries])]"""
+    if len(blob) < HEADER.size:
+        raise ValueError("file too short for a header")
+    magic, version, set_count, _, size, crc = HEADER.unpack_from(blob)
+    if magic != MAGIC:
+        raise ValueError("bad magic %r" % magic)
+    if version != VERSION:
+        raise ValueError("unsupported version %d" % version)
+    if size != len(blob):
+        raise ValueError("header says %d bytes, file has %d" % (size, len(blob)))
+    if zlib.crc32(blob[HEADER.size:]) & 0xFFFFFFFF != crc:
+        raise ValueError("CRC mismatch")
+    if not 1 <= set_count <= MAX_SETS:
+        raise ValueError("bad set count %d" % set_count)
+
+    sets = []
+    for s in range(set_count):
+        raw_name, count, index_offset = SET_ENTRY.unpack_from(blob, HEADER.size + s * SET_ENTRY.size)
+        name = raw_name.rstrip(b"\0").decode("ascii")
+        index_end = index_offset + 4 * (count + 1)
+        if count == 0 or index_end > size:
+            raise ValueError("set %s: index out of bounds" % name)
+        offsets = struct.unpack_from("<%dI" % (count + 1), blob, index_offset)
+        if offsets[0] != index_end or offsets[-1] > size:
+            raise ValueError("set %s: entries out of bounds" % name)
+        entries = []
+        for i in range(count):
+            if offsets[i + 1] < offsets[i]:
+                raise ValueError("set %s: offsets not increasing at %d" % (name, i))
+            text = blob[offsets[i]:offsets[i + 1]].decode("ascii")
+            check_entry(name, i, text)
+            entries.append(text)
+        sets.append((name, entries))
+    return sets
+
+
+def read_source(path):
+    with open(path, encoding="utf-8") as f:
+        entries = [line.strip() for line in f]
+    return [e for e in entries if e and not e.startswith("#")]
+
+
+def cmd_build(args):
+    sources = args.sources or sorted(glob.glob(os.path.join(PROJECT_DIR, "catalogs", "*.txt")))
+    sets = [(os.path.splitext(os.path.basename(p))[0], read_source(p)) for p in sources]
+    blob = build(sets)
+    parse(blob)  # Round-trip before writing
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, "wb") as f:
+        f.write(blob)
+    print("build_catalog: %s, %d bytes, sets: %s" % (
+        args.output, len(blob), ", ".join("%s (%d)" % (n, len(e)) for n, e in sets)))
+
+
+def cmd_check(args):
+    with open(args.catalog, "rb") as f:
+        sets = parse(f.read())
+    for name, entries in sets:
+        print("%s: %d entries" % (name, len(entries)))
+        if args.dump:
+            for i, text in enumerate(entries):
+                print("  %4d %s" % (i, text))
+    print("OK")
+
+
+def cmd_synth(args):
+    # Large catalogs for lookup latency measurements on the device
+    rng = random.Random(args.seed)
+    words = ["yes", "no", "maybe", "ask", "again", "later", "signs", "point", "outlook",
+             "good", "doubtful", "certain", "soon", "never", "likely", "hazy"]
+    def phrase():
+        # Drop words until it fits the display, like a real entry would be edited
+        chosen = [rng.choice(words) for _ in range(rng.randint(1, 5))]
+        while not fits_display(" ".join(chosen)):
+            chosen.pop()
+        return " ".join(chosen)
+
+    sets = []
+    for s in range(args.sets):
+        sets.append(("synth%d" % s, [phrase() for _ in range(args.entries)]))
+    blob = build(sets)
+    parse(blob)
+    with open(args.output, "wb") as f:
+        f.write(blob)
+    print("build_catalog: %s, %d bytes, %d x %d entries" % (args.output, len(blob), args.sets, args.entries))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="command")
+
+    p = sub.add_parser("build", help="build a catalog from text sources")
+    p.add_argument("-o", "--output", default=os.path.join(PROJECT_DIR, "data", "catalog.bin"))
+    p.add_argument("sources", nargs="*")
+    p.set_defaults(func=cmd_build)
+
+    p = sub.add_parser("check", help="validate a catalog")
+    p.add_argument("catalog")
+    p.add_argument("--dump", action="store_true")
+    p.set_defaults(func=cmd_check)
+
+    p = sub.add_parser("synth", help="generate a large synthetic catalog")
+    p.add_argument("-o", "--output", required=True)
+    p.add_argument("--entries", type=int, default=5000)
+    p.add_argument("--sets", type=int, default=1)
+    p.add_argument("--seed", type=int, default=8)
+    p.set_defaults(func=cmd_synth)
+
+    args = parser.parse_args()
+    if not args.command:
+        args = parser.parse_args(["build"])
+    try:
+        args.func(args)
+    except ValueError as e:
+        sys.exit("build_catalog: error: %s" % e)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,61 @@
+"""Gzip web/index.html into include/web_index.h as a PROGMEM array.
+
+Runs as a PlatformIO pre-build script (extra_scripts = pre:tools/embed_web.py)
+and can also be run by hand: python tools/embed_web.py
+The header is only rewritten when its content changes, so it does not force
+a rebuild on every run.
+"""
+import gzip
+import hashlib
+import os
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+    PROJECT_DIR = env["PROJECT_DIR"]  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = os.path.join(PROJECT_DIR, "web", "index.html")
+TARGET = os.path.join(PROJECT_DIR, "include", "web_index.h")
+
+
+def render_header(html):
+    # mtime=0 keeps the output (and therefore the ETag) reproducible
+    compressed = gzip.compress(html, compresslevel=9, mtime=0)
+    etag = hashlib.sha1(compressed).hexdigest()[:16]
+
+    lines = [
+        "// Generated by tools/embed_web.py from web/index.html - do not edit",
+        "#ifndef WEB_INDEX_H",
+        "#define WEB_INDEX_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "// %d bytes of HTML, %d bytes gzipped" % (len(html), len(compressed)),
+        '#define WEB_INDEX_ETAG "\\"%s\\""' % etag,
+        "#define WEB_INDEX_GZ_LENGTH %d" % len(compressed),
+        "",
+        "static const uint8_t WEB_INDEX_GZ[] PROGMEM = {",
+    ]
+    for i in range(0, len(compressed), 16):
+        chunk = compressed[i:i + 16]
+        lines.append("  " + ", ".join("0x%02x" % b for b in chunk) + ",")
+    lines += ["};", "", "#endif // WEB_INDEX_H", ""]
+    return "\n".join(lines)
+
+
+def main():
+    with open(SOURCE, "rb") as f:
+        header = render_header(f.read())
+
+    if os.path.exists(TARGET):
+        with open(TARGET, "r") as f:
+            if f.read() == header:
+                return
+
+    with open(TARGET, "w") as f:
+        f.write(header)
+    print("embed_web: regenerated %s" % os.path.relpath(TARGET, PROJECT_DIR))
+
+
+main()
@@ -0,0 +1,134 @@
+"""Capture display frames from the device and compare them pixel by pixel.
+
+/frame.pbm returns the last frame sent to the SH1106 as a binary PBM; with
+?answer=N the device first draws the final screen of built-in answer N.
+Capture a set of frames from a known-good build, flash the new build,
+capture again and diff:
+
+    python tools/frames.py capture frames/before          # answers 0..19
+    python tools/frames.py capture frames/after --host 192.168.4.1
+    python tools/frames.py diff frames/before frames/after
+    python tools/frames.py show frames/after/answer-07.pbm
+
+diff exits with status 1 if any frame differs and prints the differing
+pixels ('+' lit only in the second frame, '-' only in the first).
+"""
+import argparse
+import glob
+import os
+import sys
+import urllib.request
+
+WIDTH = 128
+HEIGHT = 64
+ANSWER_COUNT = 20  # numResponses in src/main.cpp
+
+
+def read_pbm(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    parts = data.split(b"\n", 2)
+    if len(parts) != 3 or parts[0] != b"P4" or parts[1] != b"%d %d" % (WIDTH, HEIGHT):
+        raise ValueError("%s: not a %dx%d binary PBM" % (path, WIDTH, HEIGHT))
+    bits = parts[2]
+    if len(bits) != WIDTH * HEIGHT // 8:
+        raise ValueError("%s: truncated, %d bytes of pixels" % (path, len(bits)))
+    return [[(bits[y * WIDTH // 8 + x // 8] >> (7 - x % 8)) & 1 for x in range(WIDTH)]
+            for y in range(HEIGHT)]
+
+
+def fetch(host, query, path):
+    url = "http://%s/frame.pbm%s" % (host, query)
+    with urllib.request.urlopen(url, timeout=10) as reply:
+        data = reply.read()
+    with open(path, "wb") as f:
+        f.write(data)
+    read_pbm(path)
+
+
+def cmd_capture(args):
+    os.makedirs(args.directory, exist_ok=True)
+    for n in range(args.count):
+        path = os.path.join(args.directory, "answer-%02d.pbm" % n)
+        fetch(args.host, "?answer=%d" % n, path)
+        print("frames: %s" % path)
+
+
+def render(pixels, other=None):
+    rows = []
+    for y in range(HEIGHT):
+        row = ""
+        for x in range(WIDTH):
+            a = pixels[y][x]
+            if other is None:
+                row += "#" if a else "."
+            else:
+                b = other[y][x]
+                row += "#" if a and b else "-" if a else "+" if b else "."
+        rows.append(row)
+    return "\n".join(rows)
+
+
+def diff_files(first, second, quiet):
+    a = read_pbm(first)
+    b = read_pbm(second)
+    changed = sum(a[y][x] != b[y][x] for y in range(HEIGHT) for x in range(WIDTH))
+    if changed:
+        print("frames: %s: %d pixels differ" % (os.path.basename(second), changed))
+        if not quiet:
+            print(render(a, b))
+    return changed
+
+
+def cmd_diff(args):
+    if os.path.isdir(args.first):
+        names = sorted(os.path.basename(p) for p in glob.glob(os.path.join(args.first, "*.pbm")))
+        pairs = [(os.path.join(args.first, n), os.path.join(args.second, n)) for n in names]
+    else:
+        pairs = [(args.first, args.second)]
+
+    failed = 0
+    for first, second in pairs:
+        if not os.path.exists(second):
+            print("frames: %s: missing" % second)
+            failed += 1
+        elif diff_files(first, second, args.quiet):
+            failed += 1
+    print("frames: %d of %d frames differ" % (failed, len(pairs)))
+    if failed:
+        sys.exit(1)
+
+
+def cmd_show(args):
+    print(render(read_pbm(args.frame)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("capture", help="download the final frame of each built-in answer")
+    p.add_argument("directory")
+    p.add_argument("--host", default="192.168.4.1")
+    p.add_argument("--count", type=int, default=ANSWER_COUNT)
+    p.set_defaults(func=cmd_capture)
+
+    p = sub.add_parser("diff", help="compare two frames or two capture directories")
+    p.add_argument("first")
+    p.add_argument("second")
+    p.add_argument("-q", "--quiet", action="store_true", help="counts only, no pixel map")
+    p.set_defaults(func=cmd_diff)
+
+    p = sub.add_parser("show", help="print a frame as text")
+    p.add_argument("frame")
+    p.set_defaults(func=cmd_show)
+
+    args = parser.parse_args()
+    try:
+        args.func(args)
+    except (ValueError, OSError) as e:
+        sys.exit("frames: error: %s" % e)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,122 @@
+"""Write synthetic accelerometer traces for the gesture replay test.
+
+The traces are generated, not recorded: sine shakes, bumps, taps, tilts and
+noise at 50Hz in raw ±8g counts, with the sensor lying flat (+1g on Z). They
+use the CSV layout of `trace_dump.py csv --raw`. In these files the shake
+column is the ground truth: 1 for the samples of an intended shake. Every
+file starts with a '# synthetic' comment line saying how it was made.
+
+    python tools/synth_traces.py test/test_gesture_replay/traces
+
+Recordings from the device can sit next to them (see trace_dump.py). Set
+their shake column by hand to the span of the real shake, because trace_dump
+marks the blocks where the device detected a shake, which is not the same.
+"""
+import argparse
+import math
+import os
+import random
+
+RATE_HZ = 50
+COUNTS_PER_G = 4096  # ±8g, MPU6050_DEFAULT_RANGE
+NOISE_G = 0.01       # Sensor noise at rest with the DLPF on
+
+
+def rest(seconds):
+    return [(0.0, 0.0, 0.0, 0)] * int(seconds * RATE_HZ)
+
+
+def shake(seconds, hz, amplitude_g, axis=0):
+    rows = []
+    for i in range(int(seconds * RATE_HZ)):
+        value = amplitude_g * math.sin(2 * math.pi * hz * i / RATE_HZ)
+        offset = [0.0, 0.0, 0.0]
+        offset[axis] = value
+        rows.append((offset[0], offset[1], offset[2], 1))
+    return rows
+
+
+def bump(peak_g, ms, axis=2):
+    # Half-sine pulse, like knocking the table
+    count = max(1, int(ms * RATE_HZ / 1000))
+    rows = []
+    for i in range(count):
+        offset = [0.0, 0.0, 0.0]
+        offset[axis] = peak_g * math.sin(math.pi * (i + 0.5) / count)
+        rows.append((offset[0], offset[1], offset[2], 0))
+    return rows
+
+
+def tilt(seconds, degrees):
+    # Gravity turns from Z towards X; returned as an offset from (0, 0, 1g)
+    rows = []
+    count = int(seconds * RATE_HZ)
+    for i in range(count):
+        angle = math.radians(degrees) * (i + 1) / count
+        rows.append((math.sin(angle), 0.0, math.cos(angle) - 1.0, 0))
+    return rows
+
+
+def hold_tilt(seconds, degrees):
+    angle = math.radians(degrees)
+    return [(math.sin(angle), 0.0, math.cos(angle) - 1.0, 0)] * int(seconds * RATE_HZ)
+
+
+def jitter(seconds, sigma_g, rng):
+    return [(rng.gauss(0, sigma_g), rng.gauss(0, sigma_g), rng.gauss(0, sigma_g), 0)
+            for _ in range(int(seconds * RATE_HZ))]
+
+
+def walk(seconds, hz, amplitude_g):
+    # Carried while walking: a vertical bounce
+    return [(0.0, 0.0, amplitude_g * math.sin(2 * math.pi * hz * i / RATE_HZ), 0)
+            for i in range(int(seconds * RATE_HZ))]
+
+
+TRACES = {
+    "shake_3hz_0g6": ("3Hz 0.6g shake on X for 2s",
+                      lambda rng: rest(1) + shake(2, 3, 0.6) + rest(1.5)),
+    "shake_4hz_2g": ("4Hz 2g shake on X for 1.5s",
+                     lambda rng: rest(1) + shake(1.5, 4, 2.0) + rest(1.5)),
+    "shake_5hz_1g_y": ("5Hz 1g shake on Y for 1s",
+                       lambda rng: rest(1) + shake(1, 5, 1.0, axis=1) + rest(1.5)),
+    "shake_twice": ("two 3Hz 1g shakes 2.5s apart",
+                    lambda rng: rest(1) + shake(1.5, 3, 1.0) + rest(2.5) + shake(1.5, 3, 1.0) + rest(1.5)),
+    "bump": ("single 1.5g knock on Z, 60ms",
+             lambda rng: rest(1) + bump(1.5, 60) + rest(2)),
+    "double_tap": ("two 1g taps on Z 200ms apart",
+                   lambda rng: rest(1) + bump(1.0, 40) + rest(0.16) + bump(1.0, 40) + rest(2)),
+    "tilt_slow": ("turned 90 degrees over 2s and held",
+                  lambda rng: rest(1) + tilt(2, 90) + hold_tilt(2, 90)),
+    "jitter_0g2": ("random jitter, sigma 0.07g (about 0.2g peaks), for 5s",
+                   lambda rng: rest(0.5) + jitter(5, 0.07, rng) + rest(0.5)),
+    "walk": ("carried while walking, 2Hz 0.3g bounce for 6s",
+             lambda rng: rest(0.5) + walk(6, 2, 0.3) + rest(0.5)),
+}
+
+
+def write_trace(path, description, rows, rng):
+    with open(path, "w") as out:
+        out.write("# synthetic: %s (tools/synth_traces.py, not a recording)\n" % description)
+        out.write("ms,x,y,z,shake\n")
+        for i, (x, y, z, label) in enumerate(rows):
+            counts = [int(round((g + rng.gauss(0, NOISE_G)) * COUNTS_PER_G)) for g in (x, y, z + 1.0)]
+            counts = [max(-32768, min(32767, c)) for c in counts]
+            out.write("%d,%d,%d,%d,%d\n" % (i * 1000 // RATE_HZ, counts[0], counts[1], counts[2], label))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("directory")
+    parser.add_argument("--seed", type=int, default=8, help="noise seed; the committed traces use 8")
+    args = parser.parse_args()
+
+    os.makedirs(args.directory, exist_ok=True)
+    for name, (description, build) in sorted(TRACES.items()):
+        rng = random.Random("%d-%s" % (args.seed, name))
+        write_trace(os.path.join(args.directory, name + ".csv"), description, build(rng), rng)
+        print("synth_traces: wrote %s.csv" % name)
+
+
+if __name__ == "__main__":
+    main()
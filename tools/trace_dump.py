@@ -0,0 +1,125 @@
+"""Read accelerometer traces downloaded from /trace.bin.
+
+The file is a sequence of 512-byte blocks written by src/TraceRecorder.cpp
+(the format is described in include/TraceRecorder.h). Blocks are sorted by
+sequence number and split into recordings at blocks flagged as a start.
+
+    curl -o trace.bin http://192.168.4.1/trace.bin
+    python tools/trace_dump.py list trace.bin
+    python tools/trace_dump.py csv trace.bin -r 2 -o shake2.csv
+    python tools/trace_dump.py csv trace.bin --raw      # counts instead of g
+
+CSV columns: time in ms from the start of the recording, x, y, z, and a
+shake column that is 1 in blocks where the device recognised a shake.
+"""
+import argparse
+import struct
+import sys
+
+BLOCK_SIZE = 512
+HEADER = struct.Struct("<4sIIBBBB")
+SAMPLE = struct.Struct("<Hhhh")
+MAGIC = b"M8BT"
+VERSION = 1
+FLAG_START = 0x01
+FLAG_SHAKE = 0x02
+FLAG_GAP = 0x04
+COUNTS_PER_G = {0: 16384, 1: 8192, 2: 4096, 3: 2048}
+
+
+def read_blocks(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) % BLOCK_SIZE:
+        raise ValueError("%s: %d bytes is not a whole number of blocks" % (path, len(data)))
+
+    blocks = []
+    for offset in range(0, len(data), BLOCK_SIZE):
+        magic, sequence, start, version, accel_range, count, flags = HEADER.unpack_from(data, offset)
+        if magic != MAGIC:
+            continue
+        if version != VERSION:
+            raise ValueError("block %d: unsupported version %d" % (offset // BLOCK_SIZE, version))
+        samples = [SAMPLE.unpack_from(data, offset + HEADER.size + i * SAMPLE.size) for i in range(count)]
+        blocks.append({"sequence": sequence, "start": start, "range": accel_range,
+                       "flags": flags, "samples": samples})
+    blocks.sort(key=lambda b: b["sequence"])
+    return blocks
+
+
+def split_recordings(blocks):
+    recordings = []
+    for block in blocks:
+        if block["flags"] & FLAG_START or not recordings:
+            recordings.append([])
+        recordings[-1].append(block)
+    return recordings
+
+
+def samples(recording):
+    """(ms since the recording started, x, y, z, shake, range) per sample."""
+    origin = recording[0]["start"]
+    for block in recording:
+        time = (block["start"] - origin) & 0xFFFFFFFF
+        shake = 1 if block["flags"] & FLAG_SHAKE else 0
+        for delta, x, y, z in block["samples"]:
+            time += delta
+            yield time, x, y, z, shake, block["range"]
+
+
+def cmd_list(args):
+    recordings = split_recordings(read_blocks(args.trace))
+    for n, recording in enumerate(recordings):
+        rows = list(samples(recording))
+        duration = rows[-1][0] if rows else 0
+        shakes = sum(1 for b in recording if b["flags"] & FLAG_SHAKE)
+        gaps = sum(1 for b in recording if b["flags"] & FLAG_GAP)
+        print("%3d  at %9.1fs  %6.1fs  %5d samples  %2d shake blocks%s" % (
+            n, recording[0]["start"] / 1000.0, duration / 1000.0, len(rows), shakes,
+            "  (%d gaps)" % gaps if gaps else ""))
+    print("trace_dump: %d recordings" % len(recordings))
+
+
+def cmd_csv(args):
+    recordings = split_recordings(read_blocks(args.trace))
+    if not recordings:
+        raise ValueError("no recordings in %s" % args.trace)
+    if not -len(recordings) <= args.recording < len(recordings):
+        raise ValueError("recording %d out of range (0..%d)" % (args.recording, len(recordings) - 1))
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    out.write("ms,x,y,z,shake\n")
+    for time, x, y, z, shake, accel_range in samples(recordings[args.recording]):
+        if args.raw:
+            out.write("%d,%d,%d,%d,%d\n" % (time, x, y, z, shake))
+        else:
+            scale = COUNTS_PER_G[accel_range]
+            out.write("%d,%.4f,%.4f,%.4f,%d\n" % (time, x / scale, y / scale, z / scale, shake))
+    if args.output:
+        out.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("list", help="list the recordings in a trace")
+    p.add_argument("trace")
+    p.set_defaults(func=cmd_list)
+
+    p = sub.add_parser("csv", help="write one recording as CSV")
+    p.add_argument("trace")
+    p.add_argument("-r", "--recording", type=int, default=-1, help="index from list, default the newest")
+    p.add_argument("-o", "--output")
+    p.add_argument("--raw", action="store_true", help="raw sensor counts instead of g")
+    p.set_defaults(func=cmd_csv)
+
+    args = parser.parse_args()
+    try:
+        args.func(args)
+    except (ValueError, OSError) as e:
+        sys.exit("trace_dump: error: %s" % e)
+
+
+if __name__ == "__main__":
+    main()